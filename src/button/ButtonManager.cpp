@@ -1,82 +1,382 @@
-#include "ButtonManager.h" 
+#include "ButtonManager.h"
+#include "../platform/Profiler.h"
+#include "../platform/Clock.h"
+#include "../platform/InputSource.h"
+#include <string.h>
 
-// Constructor: Initializes the button map and sets a default last event with no action
-ButtonManager::ButtonManager(const std::map<String, uint8_t>& buttons) 
-  : buttons(buttons), lastEvent({"", 0, NO_ACTION}) {}
+// Constructor: Registers the buttons by id
+ButtonManager::ButtonManager(const ButtonConfig* buttons, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    const ButtonConfig& config = buttons[i];
+    if (config.id >= MAX_BUTTONS || states[config.id].name) {
+      continue;
+    }
+    states[config.id].name = config.name ? config.name : "?";
+    states[config.id].pin = config.pin;
+    ids[this->count++] = config.id;
+  }
+}
 
 // Sets up the button pins as INPUT_PULLUP and initializes internal state tracking
-void ButtonManager::begin() {
-  for (const auto& pair : buttons) {
-    pinMode(pair.second, INPUT_PULLUP); // Use internal pull-up resistor
-    states[pair.second] = ButtonState(); // Initialize state for each button
+void ButtonManager::begin(bool useInterrupts) {
+  this->useInterrupts = useInterrupts && !backend;
+  unsigned long now = Clock::now();
+  active = 0;
+
+  // A backend is read as a whole; map its keys back to the button ids
+  if (backend) {
+    backend->begin();
+    lastScan = backend->scan();
+    knownKeys = 0;
+    memset(keyIds, 0xFF, sizeof(keyIds));
+    for (uint8_t i = 0; i < count; i++) {
+      uint8_t key = states[ids[i]].pin;
+      if (key < InputBackend::MAX_KEYS && key < backend->getKeyCount()) {
+        knownKeys |= InputBackend::KeyMask(1) << key;
+        keyIds[key] = ids[i];
+      }
+    }
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    ButtonState& s = states[ids[i]];
+    const char* name = s.name;
+    uint8_t pin = s.pin;
+    uint8_t gestures = s.gestures;
+    bool repeatEnabled = s.repeatEnabled;
+    ButtonRepeat repeat = s.repeat;
+    s = ButtonState(); // Initialize state for each button
+    s.name = name;
+    s.pin = pin;
+    s.gestures = gestures;
+    s.repeatEnabled = repeatEnabled;
+    s.repeat = repeat;
+    if (!backend) {
+      pinMode(pin, INPUT_PULLUP); // Use internal pull-up resistor
+    }
+    // A button already held is picked up as a press by the first update()
+    s.rawLevel = readLevel(ids[i]);
+    s.rawTime = now;
+    refreshActive(ids[i]);
+
+#if defined(ARDUINO_ARCH_ESP32)
+    if (this->useInterrupts) {
+      interruptContexts[i] = {this, ids[i], pin};
+      attachInterruptArg(digitalPinToInterrupt(pin), onPinChange, &interruptContexts[i], CHANGE);
+    }
+#endif
+  }
+}
+
+// Current level of a button, from the last backend scan or from its pin
+uint8_t ButtonManager::readLevel(uint8_t id) const {
+  uint8_t pin = states[id].pin;
+  if (!backend) {
+    return InputSource::read(pin);
+  }
+  return pin < InputBackend::MAX_KEYS && (lastScan >> pin) & 1 ? LOW : HIGH;
+}
+
+// Pin change interrupt: timestamps the new level
+void IRAM_ATTR ButtonManager::onPinChange(void* arg) {
+  InterruptContext* context = static_cast<InterruptContext*>(arg);
+  ButtonManager* owner = context->owner;
+  owner->feedEdge(context->id, digitalRead(context->pin), millis());
+  // Only here: the hook may use FromISR calls, which a task must not make
+  if (owner->edgeHook) {
+    owner->edgeHook(owner->edgeHookArg);
+  }
+}
+
+void ButtonManager::feedEdge(uint8_t id, int level, unsigned long time) {
+  uint8_t pin = id < MAX_BUTTONS ? states[id].pin : 0;
+  edges.push({id, pin, static_cast<uint8_t>(level), time});
+}
+
+void ButtonManager::setEdgeHook(void (*hook)(void*), void* arg) {
+  edgeHookArg = arg;
+  edgeHook = hook;
+}
+
+void ButtonManager::setEdgeTrace(void (*trace)(const ButtonEdge&, void*), void* arg) {
+  edgeTraceArg = arg;
+  edgeTrace = trace;
+}
+
+void ButtonManager::setRepeat(uint8_t id, const ButtonRepeat& repeat) {
+  if (id < MAX_BUTTONS) {
+    states[id].repeat = repeat;
+    states[id].repeatEnabled = true;
+  }
+}
+
+void ButtonManager::clearRepeat(uint8_t id) {
+  if (id < MAX_BUTTONS) {
+    states[id].repeatEnabled = false;
   }
 }
 
+void ButtonManager::setGestures(uint8_t id, uint8_t gestures) {
+  if (id < MAX_BUTTONS) {
+    states[id].gestures = gestures; // A click already waiting is reported by the next update()
+  }
+}
+
+const char* ButtonManager::name(uint8_t id) const {
+  return id < MAX_BUTTONS && states[id].name ? states[id].name : "?";
+}
+
 // Main update loop that should be called frequently to detect button events
 void ButtonManager::update() {
-  unsigned long now = millis(); // Get current time in milliseconds
-  lastEvent = {"", 0, NO_ACTION}; // Reset the last event
-
-  // Loop through all registered buttons
-  for (const auto& pair : buttons) {
-    const String& name = pair.first;
-    uint8_t pin = pair.second;
-    ButtonState& s = states[pin];
-    bool pressed = (digitalRead(pin) == LOW); // Active LOW logic
-
-    if (pressed) {
-      // If the button is pressed and we weren’t waiting for release, register the press
-      if (!s.waitingForRelease) {
-        s.lastPressTime = now;
-        s.waitingForRelease = true;
-        s.longPressReported = false;
-      }
+  PROFILE_SCOPE("ButtonManager::update");
+  unsigned long now = Clock::now(); // Get current time in milliseconds
 
-      // If button held long enough and long press not yet reported, trigger long press
-      if (!s.longPressReported && (now - s.lastPressTime > 800)) {
-        s.longPressReported = true;
-        s.clickCount = 0;
-        s.clickPending = false;
-        lastEvent = {name, pin, LONG_PRESS};
+  // A backend scan is compared with the previous one as a whole: only the
+  // keys that changed cost anything
+  if (backend) {
+    InputBackend::KeyMask scan = backend->scan();
+    InputBackend::KeyMask changed = (scan ^ lastScan) & knownKeys;
+    lastScan = scan;
+    while (changed) {
+      uint8_t key = lowestBit(changed);
+      changed &= changed - 1;
+      feedEdge(keyIds[key], (scan >> key) & 1 ? LOW : HIGH, now);
+    }
+  }
+  // Without interrupts, sample the pins; a change counts from this moment
+  else if (!useInterrupts) {
+    for (uint8_t i = 0; i < count; i++) {
+      const ButtonState& s = states[ids[i]];
+      uint8_t level = InputSource::read(s.pin);
+      if (level != s.rawLevel) {
+        feedEdge(ids[i], level, now);
       }
+    }
+  }
 
-    } else {
-      // If button was released
-      if (s.waitingForRelease) {
-        s.waitingForRelease = false;
-
-        // Short click candidate (quick release, not a long press)
-        if ((now - s.lastPressTime) < 300 && !s.longPressReported) {
-          s.clickCount++;
-
-          if (s.clickCount == 1) {
-            // First click - start waiting for possible double click
-            s.lastClickTime = now;
-            s.clickPending = true;
-          } else if (s.clickCount == 2 && (now - s.lastClickTime) < 400) {
-            // Double click detected
-            s.clickPending = false;
-            s.clickCount = 0;
-            lastEvent = {name, pin, DOUBLE_CLICK};
-          }
+  // Replay the edges in order, with their own timestamps. Every button's
+  // timers run up to each edge first, so events of different buttons are
+  // queued in the order they happened.
+  ButtonEdge edge;
+  while (edges.pop(edge)) {
+    if (edge.button >= MAX_BUTTONS || !states[edge.button].name) {
+      continue;
+    }
+    runTimers(edge.time);
+    if (edgeTrace) {
+      edgeTrace(edge, edgeTraceArg);
+    }
+    applyEdge(edge.button, edge.level, edge.time);
+  }
+
+  // Edges were lost: trust the pins as they are now
+  if (edges.getDropped() != edgesDroppedSeen) {
+    edgesDroppedSeen = edges.getDropped();
+    for (uint8_t i = 0; i < count; i++) {
+      uint8_t level = readLevel(ids[i]);
+      if (level != states[ids[i]].rawLevel) {
+        if (edgeTrace) {
+          edgeTrace({ids[i], states[ids[i]].pin, level, now}, edgeTraceArg);
         }
+        applyEdge(ids[i], level, now);
       }
+    }
+  }
 
-      // If time passed since first click and no second click came, trigger short click
-      if (s.clickPending && (now - s.lastClickTime > 400)) {
-        s.clickPending = false;
-        if (s.clickCount == 1) {
-          lastEvent = {name, pin, SHORT_CLICK};
-        }
-        s.clickCount = 0;
+  // Time-based transitions up to now (debounce, long press, click timeout)
+  runTimers(now);
+}
+
+// Settles and runs the timers of every button with a gesture in progress;
+// the others have nothing that could change with time
+void ButtonManager::runTimers(unsigned long time) {
+  ButtonMask pending = active;
+  while (pending) {
+    uint8_t id = lowestBit(pending);
+    pending &= pending - 1;
+    settle(id, time);
+    checkTimers(id, time);
+    refreshActive(id);
+  }
+}
+
+void ButtonManager::refreshActive(uint8_t id) {
+  const ButtonState& s = states[id];
+  if (s.waitingForRelease || s.clickPending || s.rawLevel != s.level) {
+    active |= ButtonMask(1) << id;
+  } else {
+    active &= ~(ButtonMask(1) << id);
+  }
+}
+
+void ButtonManager::applyEdge(uint8_t id, uint8_t level, unsigned long time) {
+  ButtonState& s = states[id];
+  settle(id, time); // A level reached before this edge counts first
+  s.rawLevel = level;
+  s.rawTime = time;
+  settle(id, time);
+  refreshActive(id);
+}
+
+// Accepts the last raw level once the bounce lockout after the previous change is over
+void ButtonManager::settle(uint8_t id, unsigned long time) {
+  ButtonState& s = states[id];
+  if (s.rawLevel == s.level || time - s.levelTime < DEBOUNCE_MS) {
+    return;
+  }
+
+  unsigned long at = s.rawTime;
+  if (at - s.levelTime < DEBOUNCE_MS) {
+    at = s.levelTime + DEBOUNCE_MS;
+  }
+  checkTimers(id, at);
+  s.level = s.rawLevel;
+  s.levelTime = at;
+
+  if (s.level == LOW) { // Active LOW logic
+    press(s, at);
+  } else {
+    release(id, at);
+  }
+}
+
+void ButtonManager::press(ButtonState& s, unsigned long time) {
+  // Register the press; the gesture is classified on release or by the timers
+  if (!s.waitingForRelease) {
+    s.lastPressTime = time;
+    s.waitingForRelease = true;
+    s.longPressReported = false;
+    s.nextRepeat = s.repeat.delayMs;
+    s.repeatCount = 0;
+  }
+}
+
+void ButtonManager::release(uint8_t id, unsigned long time) {
+  ButtonState& s = states[id];
+  if (!s.waitingForRelease) {
+    return;
+  }
+  s.waitingForRelease = false;
+
+  // Short click candidate (quick release, not a long press). Where the view
+  // has no use for a long press any hold that did not repeat is a click.
+  if (((time - s.lastPressTime) < CLICK_MAX_MS || !(s.gestures & GESTURE_LONG_PRESS)) && !s.longPressReported) {
+    s.clickCount++;
+
+    if (s.clickCount == 1 && !(s.gestures & GESTURE_DOUBLE_CLICK)) {
+      // No double click to wait for - report the click right away
+      s.clickCount = 0;
+      emit(id, SHORT_CLICK);
+    } else if (s.clickCount == 1) {
+      // First click - start waiting for possible double click
+      s.lastClickTime = time;
+      s.clickPending = true;
+    } else if (s.clickCount == 2 && (time - s.lastClickTime) < DOUBLE_CLICK_MS) {
+      // Double click detected
+      s.clickPending = false;
+      s.clickCount = 0;
+      emit(id, DOUBLE_CLICK);
+    }
+  }
+}
+
+void ButtonManager::checkTimers(uint8_t id, unsigned long time) {
+  ButtonState& s = states[id];
+  // Held repeat button: a single REPEAT however late update() runs, so a
+  // stalled loop cannot flood the event queue. The intervals it skipped are
+  // folded into repeatCount, which keeps following the hold time.
+  if (s.waitingForRelease && repeats(s) && time - s.lastPressTime >= s.nextRepeat) {
+    unsigned long held = time - s.lastPressTime;
+    unsigned long finalInterval = repeatInterval(s.repeat, s.repeat.rampMs);
+    unsigned long steps = 0;
+    while (held >= s.nextRepeat) {
+      unsigned long interval = repeatInterval(s.repeat, s.nextRepeat - s.repeat.delayMs);
+      if (interval == finalInterval) {
+        // Past the ramp the interval is constant: skip ahead in one go
+        unsigned long skipped = (held - s.nextRepeat) / interval + 1;
+        steps += skipped;
+        s.nextRepeat += skipped * interval;
+        break;
       }
+      steps++;
+      s.nextRepeat += interval;
+    }
+    s.longPressReported = true; // The release is not a click any more
+    s.clickCount = 0;
+    s.clickPending = false;
+    s.repeatCount = steps >= 255u - s.repeatCount ? 255 : s.repeatCount + steps;
+    emit(id, REPEAT, s.repeatCount);
+  }
+
+  // If button held long enough and long press not yet reported, trigger long press
+  if (s.waitingForRelease && !repeats(s) && (s.gestures & GESTURE_LONG_PRESS) && !s.longPressReported &&
+      (time - s.lastPressTime > LONG_PRESS_MS)) {
+    s.longPressReported = true;
+    s.clickCount = 0;
+    s.clickPending = false;
+    emit(id, LONG_PRESS);
+  }
+
+  // If time passed since first click and no second click came (or the view
+  // stopped using double clicks), trigger short click
+  if (!s.waitingForRelease && s.clickPending &&
+      (time - s.lastClickTime > DOUBLE_CLICK_MS || !(s.gestures & GESTURE_DOUBLE_CLICK))) {
+    s.clickPending = false;
+    if (s.clickCount == 1) {
+      emit(id, SHORT_CLICK);
     }
+    s.clickCount = 0;
   }
 }
 
-// Returns the last button event and resets the event to NO_ACTION
+void ButtonManager::emit(uint8_t id, ButtonAction action, uint8_t repeatCount) {
+  events.push({id, states[id].pin, action, repeatCount}); // Counted as dropped when the queue is full
+}
+
+// Interval before the next REPEAT, 'repeating' ms after the first one
+unsigned long ButtonManager::repeatInterval(const ButtonRepeat& repeat, unsigned long repeating) {
+  unsigned long interval = repeat.intervalMs;
+  if (repeat.minIntervalMs < interval) {
+    if (repeating >= repeat.rampMs) {
+      interval = repeat.minIntervalMs;
+    } else {
+      interval -= (interval - repeat.minIntervalMs) * repeating / repeat.rampMs;
+    }
+  }
+  return interval ? interval : 1;
+}
+
+// Returns the oldest queued event, or NO_ACTION when there is none
 ButtonEvent ButtonManager::getAction() {
-  ButtonEvent event = lastEvent;
-  lastEvent = {"", 0, NO_ACTION}; // Clear event after reading
+  ButtonEvent event;
+  if (!events.pop(event)) {
+    event = {0, 0, NO_ACTION, 0};
+  }
   return event;
 }
+
+// Earliest time a held button becomes a long press or repeats, a pending
+// click becomes a short click or a bouncing level settles
+unsigned long ButtonManager::nextDeadline() const {
+  unsigned long deadline = NO_DEADLINE;
+  for (ButtonMask pending = active; pending; pending &= pending - 1) {
+    const ButtonState& s = states[lowestBit(pending)];
+    unsigned long due = NO_DEADLINE;
+    if (s.rawLevel != s.level) {
+      due = s.levelTime + DEBOUNCE_MS;
+    } else if (s.waitingForRelease && repeats(s)) {
+      due = s.lastPressTime + s.nextRepeat;
+    } else if (s.waitingForRelease && (s.gestures & GESTURE_LONG_PRESS) && !s.longPressReported) {
+      due = s.lastPressTime + LONG_PRESS_MS + 1;
+    } else if (s.clickPending && !(s.gestures & GESTURE_DOUBLE_CLICK)) {
+      due = s.lastClickTime; // Reported by the next update()
+    } else if (s.clickPending) {
+      due = s.lastClickTime + DOUBLE_CLICK_MS + 1;
+    }
+    // Sooner by distance, so a deadline past the millis() wrap does not win
+    if (due != NO_DEADLINE && (deadline == NO_DEADLINE || static_cast<long>(due - deadline) < 0)) {
+      deadline = due;
+    }
+  }
+  return deadline;
+}
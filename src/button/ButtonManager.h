@@ -2,42 +2,264 @@
 #define BUTTON_MANAGER_H
 
 #include <Arduino.h>
-#include <map>
+#include <type_traits>
+#include "InputBackend.h"
+#include "../platform/SpscRing.h"
 
-enum ButtonAction {
+enum ButtonAction : uint8_t {
   NO_ACTION,
   SHORT_CLICK,
   LONG_PRESS,
-  DOUBLE_CLICK
+  DOUBLE_CLICK,
+  REPEAT          // Buton tinut apasat, cu repetare activata (setRepeat)
+};
+
+// Identificatorii butoanelor de navigare folosite de vederi. Alte butoane pot
+// folosi orice id pana la ButtonManager::MAX_BUTTONS - 1.
+enum ButtonId : uint8_t {
+  BUTTON_UP,
+  BUTTON_DOWN,
+  BUTTON_LEFT,
+  BUTTON_RIGHT,
+  BUTTON_CENTER
 };
 
 struct ButtonEvent {
-  String buttonName;    // Numele butonului
+  uint8_t buttonId;     // Identificatorul butonului (ButtonId)
   uint8_t buttonPin;    // Pinul GPIO
   ButtonAction action;  // Tipul acțiunii
+  uint8_t repeatCount;  // REPEAT: repetări de la apăsare (poate sări pași), maxim 255; altfel 0
+
+  // A click or an auto-repeat: one step of a scroll or of a value
+  bool isStep() const { return action == SHORT_CLICK || action == REPEAT; }
 };
 
+static_assert(std::is_trivially_copyable<ButtonEvent>::value && sizeof(ButtonEvent) == 4,
+              "ButtonEvent is copied through queues and recordings");
+
+// Un buton: identificator, pin si nume (doar pentru diagnostic).
+// Cu un InputBackend, 'pin' este indexul tastei in backend.
+struct ButtonConfig {
+  uint8_t id;
+  uint8_t pin;
+  const char* name;
+};
+
+// Gestures a view consumes from one button, as a bit mask. A view reports
+// them from 'uint8_t gestures(uint8_t buttonId) const'; see
+// ButtonManager::setGestures(). Without DOUBLE_CLICK a click is reported on
+// release; without REPEAT a button set up with setRepeat() behaves like any
+// other; without LONG_PRESS a hold is reported as a click on release.
+// SHORT_CLICK is always reported; GESTURE_CLICK documents that a view uses it.
+enum ButtonGesture : uint8_t {
+  GESTURE_CLICK = 1 << 0,
+  GESTURE_DOUBLE_CLICK = 1 << 1,
+  GESTURE_LONG_PRESS = 1 << 2,
+  GESTURE_REPEAT = 1 << 3,
+  GESTURE_ALL = 0x0F
+};
+
+// Hold-to-repeat timing of one button. The interval shrinks linearly from
+// intervalMs to minIntervalMs over the first rampMs of repeating.
+struct ButtonRepeat {
+  uint16_t delayMs = 500;       // Hold time before the first REPEAT
+  uint16_t intervalMs = 150;
+  uint16_t minIntervalMs = 30;
+  uint16_t rampMs = 2000;
+};
+
+// Schimbare de nivel a unui buton, cu momentul exact (Clock::now())
+struct ButtonEdge {
+  uint8_t button;      // Identificatorul butonului
+  uint8_t pin;
+  uint8_t level;       // LOW = apasat
+  unsigned long time;
+};
+
+// Classifies presses into clicks, double clicks and long presses.
+// Input arrives as timestamped pin edges in a ring: from a GPIO interrupt
+// (begin(true), on the ESP32), from polling the pins through InputSource in
+// update() (begin(), the default), from scanning an InputBackend in update()
+// (setBackend()) or from feedEdge() (tests, host, traces). The state machine
+// runs on the edge timestamps, so a slow frame delays the events but does
+// not change how long a press was or lose a short tap.
+//
+// Events go through a fixed-capacity queue: update() is the only producer
+// and pollEvent()/drainEvents()/getAction() the only consumer, which may run
+// on another task, so a loop slower than the input still sees every event in
+// order. Events past EVENT_CAPACITY are dropped and counted.
+//
+// A button with repeat enabled (setRepeat()) reports REPEAT events while
+// held instead of a LONG_PRESS, where the view uses GESTURE_REPEAT; a quick
+// release is still a click.
+//
+// A click is normally reported DOUBLE_CLICK_MS after its release, once no
+// second click came. Where the active view declares that it does not use
+// DOUBLE_CLICK on a button, the SHORT_CLICK is reported on release.
+//
+// Buttons are addressed by a small integer id (ButtonId for the navigation
+// keys). Their state is a fixed array indexed by it, so routing an edge or an
+// event involves no string compare and no allocation. Only buttons with
+// something in progress (held, bouncing or waiting for a second click) are
+// visited by update(), nextDeadline() and isActive(), and a backend scan is
+// diffed as a bit mask, so an idle keypad of 64 keys costs one scan and no
+// per-key work.
 class ButtonManager {
 public:
-  ButtonManager(const std::map<String, uint8_t>& buttons);
+  static constexpr unsigned long NO_DEADLINE = ~0UL;
+  static constexpr unsigned long DEBOUNCE_MS = 10;     // Edges closer than this after a change are bounce
+  static constexpr unsigned long CLICK_MAX_MS = 300;   // Longer presses are not clicks
+  static constexpr unsigned long DOUBLE_CLICK_MS = 400; // Window for the second click
+  static constexpr unsigned long LONG_PRESS_MS = 800;
+  static constexpr size_t EDGE_CAPACITY = 32;
+  static constexpr size_t EVENT_CAPACITY = 16;
+  static constexpr uint8_t MAX_BUTTONS = 64;
+
+  // Ids of MAX_BUTTONS or more, and repeated ids, are ignored. The names
+  // must outlive the manager (string literals).
+  ButtonManager(const ButtonConfig* buttons, size_t count);
+  template <size_t N>
+  explicit ButtonManager(const ButtonConfig (&buttons)[N]) : ButtonManager(buttons, N) {}
   
-  void begin();
+  // Reads the keys from 'backend' instead of one GPIO per button; the pin of
+  // each ButtonConfig is then its key index. Call before begin().
+  void setBackend(InputBackend* backend) { this->backend = backend; }
+
+  // 'useInterrupts' takes edges from pin change interrupts instead of polling
+  // the pins in update(); on a host nothing is attached and edges come only
+  // from feedEdge(). Ignored with a backend, which is scanned in update().
+  void begin(bool useInterrupts = false);
   void update();
+
+  // Oldest queued event, or one with NO_ACTION if there is none
   ButtonEvent getAction();
 
+  // Takes the oldest queued event; false if there is none
+  bool pollEvent(ButtonEvent& event) { return events.pop(event); }
+
+  // Passes every queued event to 'handler', oldest first; returns how many
+  template <typename Handler>
+  size_t drainEvents(Handler&& handler) {
+    size_t count = 0;
+    ButtonEvent event;
+    while (events.pop(event)) {
+      handler(event);
+      count++;
+    }
+    return count;
+  }
+
+  size_t pendingEvents() const { return events.size(); }
+
+  // millis() time at which update() can report an event without any pin
+  // changing (pending click or long press), or NO_DEADLINE
+  unsigned long nextDeadline() const;
+
+  // True while a button is held or a click is waiting to be classified,
+  // i.e. from the press until the event of that gesture has been reported
+  bool isActive() const { return active != 0; }
+
+  // Turns hold-to-repeat on for button 'id', or off with clearRepeat()
+  void setRepeat(uint8_t id, const ButtonRepeat& repeat = ButtonRepeat());
+  void clearRepeat(uint8_t id);
+
+  // Gestures (ButtonGesture mask) the active view uses on button 'id';
+  // GESTURE_ALL until set
+  void setGestures(uint8_t id, uint8_t gestures);
+  uint8_t getGestures(uint8_t id) const { return id < MAX_BUTTONS ? states[id].gestures : 0; }
+
+  // Takes the gestures of every button from 'view.gestures(id)'. Call it
+  // when the active view or its mode changes, e.g. after handling events.
+  template <typename View>
+  void setGestures(const View& view) {
+    for (uint8_t i = 0; i < count; i++) {
+      setGestures(ids[i], view.gestures(ids[i]));
+    }
+  }
+
+  // Name the button was registered with, for logs ("?" if unknown)
+  const char* name(uint8_t id) const;
+
+  // Queues a level change of button 'id' at millis() time 'time'. Safe from
+  // an interrupt handler; edges past EDGE_CAPACITY before update() are dropped.
+  void feedEdge(uint8_t id, int level, unsigned long time);
+
+  // Called from the pin change interrupt after it queued an edge (e.g. to
+  // wake the loop with FrameScheduler::wakeFromISR()). Edges fed from a task
+  // (polling, a backend scan, feedEdge() calls) do not call it: they are
+  // applied by the update() that runs on that task anyway.
+  void setEdgeHook(void (*hook)(void*), void* arg);
+
+  // Called from update() with every edge it applies, in order (e.g. to
+  // record an input trace, see InputTrace.h)
+  void setEdgeTrace(void (*trace)(const ButtonEdge& edge, void* arg), void* arg);
+
+  uint32_t getEdgesDropped() const { return edges.getDropped(); }
+  uint32_t getEventsDropped() const { return events.getDropped(); } // Queue was full
+
 private:
   struct ButtonState {
+    const char* name = nullptr;     // Null for an unused id
+    uint8_t pin = 0;
+    uint8_t level = HIGH;           // Debounced level
+    unsigned long levelTime = 0;    // When it was reached
+    uint8_t rawLevel = HIGH;        // Level of the last edge
+    unsigned long rawTime = 0;
     unsigned long lastPressTime = 0;
     unsigned long lastClickTime = 0;
     bool waitingForRelease = false;
     bool longPressReported = false;
     bool clickPending = false;
     uint8_t clickCount = 0;
+    uint8_t gestures = GESTURE_ALL;
+    bool repeatEnabled = false;
+    ButtonRepeat repeat;
+    unsigned long nextRepeat = 0;   // Hold time of the next REPEAT
+    uint8_t repeatCount = 0;
+  };
+
+  struct InterruptContext {
+    ButtonManager* owner;
+    uint8_t id;
+    uint8_t pin;
   };
 
-  std::map<String, uint8_t> buttons;  // Nume -> Pin
-  std::map<uint8_t, ButtonState> states; // Pin -> Stare
-  ButtonEvent lastEvent;
+  using ButtonMask = uint64_t;       // Bit = id
+  static_assert(MAX_BUTTONS <= 64, "ButtonMask holds one bit per id");
+
+  ButtonState states[MAX_BUTTONS];  // Indexat dupa id
+  uint8_t ids[MAX_BUTTONS];         // Butoanele folosite, in ordinea inregistrarii
+  uint8_t count = 0;
+  ButtonMask active = 0;            // Butoanele cu un gest in desfasurare
+
+  InputBackend* backend = nullptr;
+  InputBackend::KeyMask lastScan = 0;
+  InputBackend::KeyMask knownKeys = 0;       // Tastele cu un buton
+  uint8_t keyIds[InputBackend::MAX_KEYS];    // Tasta -> id
+
+  SpscRing<ButtonEdge, EDGE_CAPACITY> edges;
+  SpscRing<ButtonEvent, EVENT_CAPACITY> events;
+  bool useInterrupts = false;
+  InterruptContext interruptContexts[MAX_BUTTONS];
+  uint32_t edgesDroppedSeen = 0;
+  void (*edgeHook)(void*) = nullptr;
+  void* edgeHookArg = nullptr;
+  void (*edgeTrace)(const ButtonEdge&, void*) = nullptr;
+  void* edgeTraceArg = nullptr;
+
+  static void onPinChange(void* arg);
+  static uint8_t lowestBit(uint64_t mask) { return __builtin_ctzll(mask); }
+  uint8_t readLevel(uint8_t id) const;
+  void refreshActive(uint8_t id);
+  void runTimers(unsigned long time);
+  void applyEdge(uint8_t id, uint8_t level, unsigned long time);
+  void settle(uint8_t id, unsigned long time);
+  void checkTimers(uint8_t id, unsigned long time);
+  void press(ButtonState& s, unsigned long time);
+  void release(uint8_t id, unsigned long time);
+  void emit(uint8_t id, ButtonAction action, uint8_t repeatCount = 0);
+  static unsigned long repeatInterval(const ButtonRepeat& repeat, unsigned long repeating);
+  static bool repeats(const ButtonState& s) { return s.repeatEnabled && (s.gestures & GESTURE_REPEAT); }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "I2cExpanderInput.h"
+
+I2cExpanderInput::I2cExpanderInput(I2cBus &bus, const uint8_t *addresses, uint8_t expanders)
+    : bus(bus), expanders(expanders < MAX_EXPANDERS ? expanders : MAX_EXPANDERS)
+{
+  memcpy(this->addresses, addresses, this->expanders);
+}
+
+void I2cExpanderInput::begin()
+{
+  static const uint8_t allSet[2] = {0xFF, 0xFF};
+  for (uint8_t i = 0; i < expanders; i++)
+  {
+    bus.writeRegisters(addresses[i], REG_IODIRA, allSet, 2); // Every pin an input
+    bus.writeRegisters(addresses[i], REG_GPPUA, allSet, 2);  // with its pull-up
+  }
+}
+
+InputBackend::KeyMask I2cExpanderInput::scan()
+{
+  KeyMask pressed = 0;
+  for (uint8_t i = 0; i < expanders; i++)
+  {
+    const KeyMask mask = KeyMask(0xFFFF) << (16 * i);
+    uint8_t ports[2];
+    if (!bus.readRegisters(addresses[i], REG_GPIOA, ports, 2))
+    {
+      readErrors++;
+      pressed |= last & mask;
+      continue;
+    }
+    const uint16_t levels = ports[0] | ports[1] << 8;
+    pressed |= KeyMask(static_cast<uint16_t>(~levels)) << (16 * i); // Active low
+  }
+  last = pressed;
+  return pressed;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+bool WireI2cBus::writeRegisters(uint8_t address, uint8_t reg, const uint8_t *data, size_t count)
+{
+  wire.beginTransmission(address);
+  wire.write(reg);
+  wire.write(data, count);
+  return wire.endTransmission() == 0;
+}
+
+bool WireI2cBus::readRegisters(uint8_t address, uint8_t reg, uint8_t *out, size_t count)
+{
+  // Register address, repeated start, then the burst read
+  wire.beginTransmission(address);
+  wire.write(reg);
+  if (wire.endTransmission(false) != 0)
+    return false;
+  if (wire.requestFrom(address, static_cast<uint8_t>(count)) != count)
+    return false;
+  for (size_t i = 0; i < count; i++)
+    out[i] = wire.read();
+  return true;
+}
+
+#endif
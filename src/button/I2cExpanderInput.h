@@ -0,0 +1,159 @@
+#ifndef I2C_EXPANDER_INPUT_H
+#define I2C_EXPANDER_INPUT_H
+
+#include "InputBackend.h"
+#include <stddef.h>
+#include <string.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <Wire.h>
+#endif
+
+// Register access to devices on an I2C bus
+class I2cBus
+{
+public:
+  virtual ~I2cBus() = default;
+
+  // Writes 'count' bytes starting at register 'reg'; false if not acknowledged
+  virtual bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t *data, size_t count) = 0;
+
+  // Reads 'count' bytes starting at register 'reg' in one transaction
+  virtual bool readRegisters(uint8_t address, uint8_t reg, uint8_t *out, size_t count) = 0;
+};
+
+// Keys on up to four MCP23017 16-bit expanders (addresses 0x20 to 0x27),
+// switched to ground with the expander's pull-ups on. Key 16 * i + n is pin
+// n (GPA0 = 0 ... GPB7 = 15) of the i-th address. Each scan reads both ports
+// of an expander in one transaction. An expander that does not answer keeps
+// its previous keys until it does.
+class I2cExpanderInput : public InputBackend
+{
+public:
+  static constexpr uint8_t MAX_EXPANDERS = MAX_KEYS / 16;
+
+  // MCP23017 registers (IOCON.BANK = 0, the power-on layout)
+  static constexpr uint8_t REG_IODIRA = 0x00;
+  static constexpr uint8_t REG_GPPUA = 0x0C;
+  static constexpr uint8_t REG_GPIOA = 0x12;
+
+  I2cExpanderInput(I2cBus &bus, const uint8_t *addresses, uint8_t expanders);
+
+  void begin() override;
+  uint8_t getKeyCount() const override { return expanders * 16; }
+  KeyMask scan() override;
+
+  // Scans in which an expander did not answer
+  unsigned long getReadErrors() const { return readErrors; }
+
+private:
+  I2cBus &bus;
+  uint8_t addresses[MAX_EXPANDERS];
+  uint8_t expanders;
+  KeyMask last = 0;
+  unsigned long readErrors = 0;
+};
+
+#if defined(ARDUINO_ARCH_ESP32)
+// I2cBus on an Arduino TwoWire port (wire.begin() is left to the caller)
+class WireI2cBus : public I2cBus
+{
+public:
+  explicit WireI2cBus(TwoWire &wire) : wire(wire) {}
+
+  bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t *data, size_t count) override;
+  bool readRegisters(uint8_t address, uint8_t reg, uint8_t *out, size_t count) override;
+
+private:
+  TwoWire &wire;
+};
+#endif
+
+// Host stand-in: MCP23017s whose pins follow setKey(), with their register
+// file and a transaction count. Devices not added, or switched off with
+// setResponding(), do not acknowledge.
+class SimulatedI2cBus : public I2cBus
+{
+public:
+  static constexpr uint8_t MAX_DEVICES = 8;
+
+  bool addExpander(uint8_t address)
+  {
+    if (find(address) || count == MAX_DEVICES)
+      return false;
+    Device &device = devices[count++];
+    device.address = address;
+    memset(device.registers, 0, sizeof(device.registers));
+    device.registers[I2cExpanderInput::REG_IODIRA] = 0xFF; // Inputs after reset
+    device.registers[I2cExpanderInput::REG_IODIRA + 1] = 0xFF;
+    device.pressed = 0;
+    device.responding = true;
+    return true;
+  }
+
+  void setResponding(uint8_t address, bool responding)
+  {
+    if (Device *device = find(address))
+      device->responding = responding;
+  }
+
+  void setKey(uint8_t address, uint8_t pin, bool pressed)
+  {
+    Device *device = find(address);
+    if (!device || pin >= 16)
+      return;
+    if (pressed)
+      device->pressed |= 1 << pin;
+    else
+      device->pressed &= ~(1 << pin);
+  }
+
+  bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t *data, size_t size) override
+  {
+    transactions++;
+    Device *device = find(address);
+    if (!device || !device->responding || reg + size > sizeof(device->registers))
+      return false;
+    memcpy(device->registers + reg, data, size);
+    return true;
+  }
+
+  bool readRegisters(uint8_t address, uint8_t reg, uint8_t *out, size_t size) override
+  {
+    transactions++;
+    Device *device = find(address);
+    if (!device || !device->responding || reg + size > sizeof(device->registers))
+      return false;
+    // A pressed key pulls its pin low; the rest float high on the pull-ups
+    const uint16_t levels = ~device->pressed;
+    device->registers[I2cExpanderInput::REG_GPIOA] = levels & 0xFF;
+    device->registers[I2cExpanderInput::REG_GPIOA + 1] = levels >> 8;
+    memcpy(out, device->registers + reg, size);
+    return true;
+  }
+
+  unsigned long getTransactions() const { return transactions; }
+
+private:
+  struct Device
+  {
+    uint8_t address;
+    uint8_t registers[0x16];
+    uint16_t pressed;
+    bool responding;
+  };
+
+  Device devices[MAX_DEVICES];
+  uint8_t count = 0;
+  unsigned long transactions = 0;
+
+  Device *find(uint8_t address)
+  {
+    for (uint8_t i = 0; i < count; i++)
+      if (devices[i].address == address)
+        return &devices[i];
+    return nullptr;
+  }
+};
+
+#endif // I2C_EXPANDER_INPUT_H
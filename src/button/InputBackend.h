@@ -0,0 +1,31 @@
+#ifndef INPUT_BACKEND_H
+#define INPUT_BACKEND_H
+
+#include <stdint.h>
+
+// Source of the key levels for a ButtonManager whose keys are not one GPIO
+// each: a row/column matrix (MatrixKeypad.h), chained 74HC165 shift registers
+// (ShiftRegisterInput.h) or I2C GPIO expanders (I2cExpanderInput.h). One
+// scan() reads every key in as few bus transactions as the hardware allows.
+//
+// Every backend talks to the hardware through a small bus interface, with a
+// real implementation for the device and a simulated one for host tests.
+class InputBackend
+{
+public:
+  using KeyMask = uint64_t;                // Bit k = key k
+  static constexpr uint8_t MAX_KEYS = 64;
+
+  virtual ~InputBackend() = default;
+
+  // Sets up the bus and the pins; called by ButtonManager::begin()
+  virtual void begin() {}
+
+  virtual uint8_t getKeyCount() const = 0;
+
+  // Keys pressed right now, bit k set while key k is down. A failed read
+  // returns the previous result, so a bus error never looks like a release.
+  virtual KeyMask scan() = 0;
+};
+
+#endif // INPUT_BACKEND_H
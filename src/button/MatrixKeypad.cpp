@@ -0,0 +1,105 @@
+#include "MatrixKeypad.h"
+#include "../platform/InputSource.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <soc/gpio_reg.h>
+#include <soc/soc.h>
+#endif
+
+MatrixKeypad::MatrixKeypad(MatrixBus &bus, uint8_t rows, uint8_t columns)
+    : bus(bus), rows(rows), columns(columns)
+{
+  // Keep the keys inside the 64 bit mask
+  if (this->columns > 32)
+    this->columns = 32;
+  if (this->columns && this->rows * this->columns > MAX_KEYS)
+    this->rows = MAX_KEYS / this->columns;
+}
+
+InputBackend::KeyMask MatrixKeypad::scan()
+{
+  const uint32_t columnMask = columns >= 32 ? ~0UL : (1UL << columns) - 1;
+  uint32_t rowColumns[MAX_KEYS];
+  KeyMask pressed = 0;
+  for (uint8_t row = 0; row < rows; row++)
+  {
+    bus.selectRow(row);
+    rowColumns[row] = bus.readColumns() & columnMask;
+    pressed |= KeyMask(rowColumns[row]) << (row * columns);
+  }
+  bus.releaseRows();
+
+  // Two rows sharing two or more columns form a rectangle in which any key
+  // may be a ghost of the other three; those keys keep their last state
+  if (blockGhosts)
+  {
+    KeyMask ambiguous = 0;
+    for (uint8_t a = 0; a < rows; a++)
+    {
+      if (!(rowColumns[a] & (rowColumns[a] - 1)))
+        continue; // Fewer than two keys down in this row
+      for (uint8_t b = a + 1; b < rows; b++)
+      {
+        const uint32_t shared = rowColumns[a] & rowColumns[b];
+        if (shared & (shared - 1))
+          ambiguous |= KeyMask(shared) << (a * columns) | KeyMask(shared) << (b * columns);
+      }
+    }
+    pressed = (pressed & ~ambiguous) | (last & ambiguous);
+  }
+  last = pressed;
+  return pressed;
+}
+
+GpioMatrixBus::GpioMatrixBus(const uint8_t *rowPins, uint8_t rows, const uint8_t *columnPins, uint8_t columns,
+                             unsigned settleUs)
+    : rowPins(rowPins), rows(rows), columnPins(columnPins), columns(columns), settleUs(settleUs)
+{
+}
+
+void GpioMatrixBus::begin()
+{
+  for (uint8_t i = 0; i < rows; i++)
+    pinMode(rowPins[i], INPUT); // Floating until selected
+  for (uint8_t i = 0; i < columns; i++)
+    pinMode(columnPins[i], INPUT_PULLUP);
+  selected = -1;
+}
+
+void GpioMatrixBus::selectRow(uint8_t row)
+{
+  releaseRows();
+  digitalWrite(rowPins[row], LOW);
+  pinMode(rowPins[row], OUTPUT);
+  selected = row;
+  if (settleUs)
+    delayMicroseconds(settleUs);
+}
+
+uint32_t GpioMatrixBus::readColumns()
+{
+  uint32_t low = 0;
+#if defined(ARDUINO_ARCH_ESP32)
+  // Every column in one snapshot of the input registers
+  const uint32_t in0 = ~REG_READ(GPIO_IN_REG);
+  const uint32_t in1 = ~REG_READ(GPIO_IN1_REG);
+  for (uint8_t i = 0; i < columns; i++)
+  {
+    const uint8_t pin = columnPins[i];
+    const uint32_t bit = pin < 32 ? (in0 >> pin) & 1 : (in1 >> (pin - 32)) & 1;
+    low |= bit << i;
+  }
+#else
+  for (uint8_t i = 0; i < columns; i++)
+    if (InputSource::read(columnPins[i]) == LOW)
+      low |= 1UL << i;
+#endif
+  return low;
+}
+
+void GpioMatrixBus::releaseRows()
+{
+  if (selected >= 0)
+    pinMode(rowPins[selected], INPUT);
+  selected = -1;
+}
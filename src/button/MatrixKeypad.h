@@ -0,0 +1,128 @@
+#ifndef MATRIX_KEYPAD_H
+#define MATRIX_KEYPAD_H
+
+#include "InputBackend.h"
+#include <Arduino.h>
+#include <vector>
+
+// Wiring of a row/column keypad
+class MatrixBus
+{
+public:
+  virtual ~MatrixBus() = default;
+
+  virtual void begin() {}
+
+  // Drives 'row' LOW and leaves the other rows floating
+  virtual void selectRow(uint8_t row) = 0;
+
+  // Columns pulled LOW through a pressed key of the selected row (bit c = column c)
+  virtual uint32_t readColumns() = 0;
+
+  // Leaves every row floating once a scan is done
+  virtual void releaseRows() {}
+};
+
+// Keypad of up to 64 keys wired as 'rows' x 'columns' (at most 32 columns).
+// Key (r, c) is key r * columns + c. A scan selects each row in turn and
+// reads all its columns at once, so it costs one bus read per row, not per
+// key. Without a diode per key, three held keys on the corners of a
+// rectangle make the fourth look pressed too; by default such keys are
+// blocked: a key that may be a ghost keeps the state it had before.
+class MatrixKeypad : public InputBackend
+{
+public:
+  MatrixKeypad(MatrixBus &bus, uint8_t rows, uint8_t columns);
+
+  void begin() override { bus.begin(); }
+  uint8_t getKeyCount() const override { return rows * columns; }
+  KeyMask scan() override;
+
+  // 'false' reports the matrix as read, ghost keys included (diode per key)
+  void setGhostBlocking(bool enabled) { blockGhosts = enabled; }
+
+private:
+  MatrixBus &bus;
+  uint8_t rows;
+  uint8_t columns;
+  bool blockGhosts = true;
+  KeyMask last = 0;
+};
+
+// Rows and columns on GPIOs; the columns use the internal pull-ups. The pin
+// arrays must outlive the bus. On the ESP32 the columns of a row are taken
+// from one read of the GPIO input registers instead of a digitalRead() each.
+class GpioMatrixBus : public MatrixBus
+{
+public:
+  // 'settleUs' lets the column lines follow a newly selected row
+  GpioMatrixBus(const uint8_t *rowPins, uint8_t rows, const uint8_t *columnPins, uint8_t columns,
+                unsigned settleUs = 5);
+
+  void begin() override;
+  void selectRow(uint8_t row) override;
+  uint32_t readColumns() override;
+  void releaseRows() override;
+
+private:
+  const uint8_t *rowPins;
+  uint8_t rows;
+  const uint8_t *columnPins;
+  uint8_t columns;
+  unsigned settleUs;
+  int selected = -1;
+};
+
+// Host stand-in for the wiring: holds which keys are down and answers the
+// scan as the matrix would (ghost keys included). Counts the bus operations.
+class SimulatedMatrixBus : public MatrixBus
+{
+public:
+  SimulatedMatrixBus(uint8_t rows, uint8_t columns) : grid(rows, 0), columns(columns) {}
+
+  void setKey(uint8_t row, uint8_t column, bool pressed)
+  {
+    if (row >= grid.size() || column >= columns)
+      return;
+    if (pressed)
+      grid[row] |= 1UL << column;
+    else
+      grid[row] &= ~(1UL << column);
+  }
+
+  void selectRow(uint8_t row) override
+  {
+    selected = row;
+    transactions++;
+  }
+
+  uint32_t readColumns() override
+  {
+    transactions++;
+    if (selected >= grid.size())
+      return 0;
+    // A column pulled low through a key connects every row that shares a key with it
+    uint32_t low = grid[selected];
+    uint32_t reached;
+    do
+    {
+      reached = low;
+      for (uint32_t row : grid)
+        if (row & low)
+          low |= row;
+    } while (low != reached);
+    return low;
+  }
+
+  void releaseRows() override { selected = 0xFF; }
+
+  unsigned long getTransactions() const { return transactions; }
+
+private:
+  std::vector<uint32_t> grid; // Pressed columns of each row
+  uint8_t columns;
+  uint8_t selected = 0xFF;
+  unsigned long transactions = 0;
+};
+
+#endif // MATRIX_KEYPAD_H
@@ -0,0 +1,26 @@
+#include "ShiftRegisterInput.h"
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+void SpiShiftRegisterBus::begin()
+{
+  pinMode(loadPin, OUTPUT);
+  digitalWrite(loadPin, HIGH); // Shift mode
+}
+
+bool SpiShiftRegisterBus::read(uint8_t *out, size_t count)
+{
+  // A low pulse on SH/LD copies the inputs into the registers
+  digitalWrite(loadPin, LOW);
+  delayMicroseconds(1);
+  digitalWrite(loadPin, HIGH);
+
+  memset(out, 0xFF, count);
+  spi.beginTransaction(SPISettings(clockHz, MSBFIRST, SPI_MODE0));
+  spi.transfer(out, count);
+  spi.endTransaction();
+  return true;
+}
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef SHIFT_REGISTER_INPUT_H
+#define SHIFT_REGISTER_INPUT_H
+
+#include "InputBackend.h"
+#include <stddef.h>
+#include <string.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <SPI.h>
+#endif
+
+// Chain of parallel-in shift registers (74HC165)
+class ShiftRegisterBus
+{
+public:
+  virtual ~ShiftRegisterBus() = default;
+
+  virtual void begin() {}
+
+  // Latches every input of the chain and shifts 'count' bytes in, the
+  // register wired to the data pin first (its input H in the top bit).
+  // False if nothing could be read.
+  virtual bool read(uint8_t *out, size_t count) = 0;
+};
+
+// Keys on up to 8 chained 74HC165, pulled up and switched to ground. Key
+// 8 * i + n is input n (A = 0 ... H = 7) of the i-th register counted from
+// the data pin. The whole chain is read in one latch and one burst.
+class ShiftRegisterInput : public InputBackend
+{
+public:
+  static constexpr uint8_t MAX_REGISTERS = MAX_KEYS / 8;
+
+  ShiftRegisterInput(ShiftRegisterBus &bus, uint8_t registers)
+      : bus(bus), registers(registers < MAX_REGISTERS ? registers : MAX_REGISTERS) {}
+
+  void begin() override { bus.begin(); }
+  uint8_t getKeyCount() const override { return registers * 8; }
+
+  KeyMask scan() override
+  {
+    uint8_t bytes[MAX_REGISTERS];
+    if (!bus.read(bytes, registers))
+      return last;
+    KeyMask pressed = 0;
+    for (uint8_t i = 0; i < registers; i++)
+      pressed |= KeyMask(static_cast<uint8_t>(~bytes[i])) << (8 * i); // Active low
+    last = pressed;
+    return pressed;
+  }
+
+private:
+  ShiftRegisterBus &bus;
+  uint8_t registers;
+  KeyMask last = 0;
+};
+
+#if defined(ARDUINO_ARCH_ESP32)
+// The chain on the SPI bus: SCK to CLK, MISO to QH and 'loadPin' to SH/LD
+// (CLK INH tied low). spi.begin() is left to the caller, who owns the pins.
+class SpiShiftRegisterBus : public ShiftRegisterBus
+{
+public:
+  SpiShiftRegisterBus(SPIClass &spi, uint8_t loadPin, uint32_t clockHz = 4000000)
+      : spi(spi), loadPin(loadPin), clockHz(clockHz) {}
+
+  void begin() override;
+  bool read(uint8_t *out, size_t count) override;
+
+private:
+  SPIClass &spi;
+  uint8_t loadPin;
+  uint32_t clockHz;
+};
+#endif
+
+// Host stand-in for the chain: holds which keys are down and counts reads
+class SimulatedShiftRegisterBus : public ShiftRegisterBus
+{
+public:
+  explicit SimulatedShiftRegisterBus(uint8_t registers)
+  {
+    memset(levels, 0xFF, sizeof(levels));
+    this->registers = registers < sizeof(levels) ? registers : sizeof(levels);
+  }
+
+  void setKey(uint8_t key, bool pressed)
+  {
+    if (key / 8 >= registers)
+      return;
+    if (pressed)
+      levels[key / 8] &= ~(1 << (key % 8));
+    else
+      levels[key / 8] |= 1 << (key % 8);
+  }
+
+  bool read(uint8_t *out, size_t count) override
+  {
+    transactions++;
+    for (size_t i = 0; i < count; i++)
+      out[i] = i < registers ? levels[i] : 0xFF; // Past the chain: the pulled-up serial input
+    return true;
+  }
+
+  unsigned long getTransactions() const { return transactions; }
+
+private:
+  uint8_t levels[ShiftRegisterInput::MAX_REGISTERS];
+  uint8_t registers;
+  unsigned long transactions = 0;
+};
+
+#endif // SHIFT_REGISTER_INPUT_H
@@ -0,0 +1,92 @@
+#include "AsyncFlusher.h"
+#include "../platform/Profiler.h"
+#include <string.h>
+
+AsyncFlusher::AsyncFlusher(PageSink &sink, int width, int height)
+    : sink(sink),
+      bufferSize(width * ((height + 7) / 8)),
+      pendingDamage(width, height)
+{
+  front = new uint8_t[bufferSize];
+  shown = new uint8_t[bufferSize];
+  memset(front, 0, bufferSize);
+  memset(shown, 0, bufferSize);
+  idle.give(); // Nothing in flight yet
+}
+
+AsyncFlusher::~AsyncFlusher()
+{
+  stop();
+  delete[] front;
+  delete[] shown;
+}
+
+bool AsyncFlusher::start(int core)
+{
+  if (worker.isRunning())
+    return true;
+  stopping = false;
+  return worker.start(workerEntry, this, "displayFlush", core);
+}
+
+void AsyncFlusher::stop()
+{
+  if (!worker.isRunning())
+    return;
+  waitIdle();
+  stopping = true;
+  work.give();
+  worker.join();
+}
+
+void AsyncFlusher::submit(const uint8_t *frame, const DirtyRegion &damage, bool full)
+{
+  idle.take(); // Back-pressure: wait for the previous frame to be sent
+
+  memcpy(front, frame, bufferSize);
+  pendingDamage = damage;
+  pendingFull = full;
+
+  if (worker.isRunning())
+  {
+    work.give();
+  }
+  else
+  {
+    flushFront();
+    idle.give();
+  }
+}
+
+void AsyncFlusher::waitIdle()
+{
+  idle.take();
+  idle.give();
+}
+
+void AsyncFlusher::workerEntry(void *self)
+{
+  static_cast<AsyncFlusher *>(self)->run();
+}
+
+void AsyncFlusher::run()
+{
+  for (;;)
+  {
+    work.take();
+    if (stopping)
+      break;
+    flushFront();
+    idle.give();
+  }
+}
+
+// Runs on the worker task, or on the caller when the worker is not running
+void AsyncFlusher::flushFront()
+{
+  PROFILE_SCOPE("AsyncFlusher::flush");
+  if (pendingFull)
+    pendingDamage.markAll();
+  bytesSent += flushPageSpans(sink, front, shown, pendingDamage, !pendingFull);
+  framesFlushed++;
+}
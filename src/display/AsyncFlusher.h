@@ -0,0 +1,63 @@
+#ifndef ASYNC_FLUSHER_H
+#define ASYNC_FLUSHER_H
+
+#include "DirtyRegion.h"
+#include "PageSink.h"
+#include "../platform/Threading.h"
+#include <atomic>
+#include <stdint.h>
+
+// Double-buffered display flushing on a worker task.
+// The UI keeps rendering into its own (back) buffer; submit() copies a finished
+// frame and its damage into the front buffer owned by this class and wakes the
+// worker, which sends the changed spans to the sink while the UI draws the next
+// frame. If the worker is still busy with the previous frame, submit() waits for
+// it (back-pressure), so at most one frame is ever in flight.
+class AsyncFlusher
+{
+public:
+  AsyncFlusher(PageSink &sink, int width, int height);
+  ~AsyncFlusher();
+
+  AsyncFlusher(const AsyncFlusher &) = delete;
+  AsyncFlusher &operator=(const AsyncFlusher &) = delete;
+
+  // Starts the worker, pinned to 'core' where supported (the Arduino loop runs on core 1)
+  bool start(int core = 0);
+
+  // Sends the last submitted frame, then ends the worker
+  void stop();
+
+  // Hands a frame to the worker; 'full' sends every damaged byte without
+  // comparing against what the sink shows. Without a running worker the frame
+  // is flushed on the calling thread.
+  void submit(const uint8_t *frame, const DirtyRegion &damage, bool full);
+
+  // Blocks until no frame is in flight (e.g. before sending panel commands)
+  void waitIdle();
+
+  bool isRunning() const { return worker.isRunning(); }
+  unsigned long getFramesFlushed() const { return framesFlushed; }
+  unsigned long getBytesSent() const { return bytesSent; }
+
+private:
+  PageSink &sink;
+  int bufferSize;
+  uint8_t *front;            // Frame being (or about to be) sent
+  uint8_t *shown;            // What the sink currently holds
+  DirtyRegion pendingDamage; // Damage of the frame in 'front'
+  bool pendingFull = false;
+
+  Signal work; // Given by submit(): a frame is waiting in 'front'
+  Signal idle; // Given by the worker: 'front' may be overwritten
+  Thread worker;
+  std::atomic<bool> stopping{false};
+  std::atomic<unsigned long> framesFlushed{0};
+  std::atomic<unsigned long> bytesSent{0};
+
+  static void workerEntry(void *self);
+  void run();
+  void flushFront();
+};
+
+#endif // ASYNC_FLUSHER_H
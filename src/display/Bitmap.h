@@ -0,0 +1,31 @@
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <stdint.h>
+
+// How bitmap pixels are combined with the pixels already in the frame.
+// "Set" means a 1 bit in the bitmap.
+enum class RasterOp : uint8_t {
+  COPY,          // Frame takes the bitmap value (set -> lit, clear -> dark)
+  OR,            // Set bits light pixels, clear bits leave them (transparent)
+  AND,           // Clear bits darken pixels, set bits leave them
+  XOR,           // Set bits invert pixels
+  COPY_INVERTED, // Frame takes the inverted bitmap value
+  AND_INVERTED   // Set bits darken pixels (erase with the bitmap as a mask)
+};
+
+// Packed 1bpp image in the SH1106 page layout: byte (page * width + x) holds
+// the 8 vertical pixels of column x in that page, bit 0 being the top one.
+// Unused bits of the last page are ignored.
+struct Bitmap {
+  const uint8_t* data;
+  uint8_t width;
+  uint8_t height;
+
+  bool getPixel(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) return false;
+    return data[(y / 8) * width + x] & (1 << (y & 7));
+  }
+};
+
+#endif // BITMAP_H
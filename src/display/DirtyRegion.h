@@ -0,0 +1,97 @@
+#ifndef DIRTY_REGION_H
+#define DIRTY_REGION_H
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+// Tracks damaged areas of a page-organized (SH1106/SSD1306 style) frame buffer.
+// For every 8-pixel-high page it keeps the first and last damaged column, so a
+// flush can send only the spans that were touched since the last one.
+// Coordinates are physical (unrotated) panel coordinates. Panels up to
+// MAX_PAGES pages tall are supported; a taller one is a setup error.
+class DirtyRegion
+{
+public:
+  static constexpr uint8_t MAX_PAGES = 16; // 128 pixel tall panels (SH1107)
+
+  DirtyRegion(int width, int height)
+      : panelWidth(width),
+        pageCount(static_cast<uint8_t>((height + 7) / 8 > MAX_PAGES ? MAX_PAGES : (height + 7) / 8))
+  {
+    assert((height + 7) / 8 <= MAX_PAGES && "panel taller than DirtyRegion::MAX_PAGES pages");
+    clear();
+  }
+
+  // Marks a rectangle as damaged; parts outside the panel are ignored
+  void markRect(int x, int y, int w, int h)
+  {
+    if (w <= 0 || h <= 0)
+      return;
+
+    int x0 = x < 0 ? 0 : x;
+    int x1 = x + w - 1 >= panelWidth ? panelWidth - 1 : x + w - 1;
+    int y0 = y < 0 ? 0 : y;
+    int y1 = y + h - 1 >= pageCount * 8 ? pageCount * 8 - 1 : y + h - 1;
+    if (x0 > x1 || y0 > y1)
+      return;
+
+    for (int page = y0 / 8; page <= y1 / 8; page++)
+    {
+      if (x0 < firstColumn[page])
+        firstColumn[page] = static_cast<int16_t>(x0);
+      if (x1 > lastColumn[page])
+        lastColumn[page] = static_cast<int16_t>(x1);
+    }
+  }
+
+  // Marks the whole panel as damaged
+  void markAll()
+  {
+    for (uint8_t page = 0; page < pageCount; page++)
+    {
+      firstColumn[page] = 0;
+      lastColumn[page] = static_cast<int16_t>(panelWidth - 1);
+    }
+  }
+
+  // Forgets all damage (called after a flush)
+  void clear()
+  {
+    for (uint8_t page = 0; page < MAX_PAGES; page++)
+    {
+      firstColumn[page] = INT16_MAX;
+      lastColumn[page] = -1;
+    }
+  }
+
+  bool isPageDirty(uint8_t page) const
+  {
+    return page < pageCount && lastColumn[page] >= firstColumn[page];
+  }
+
+  bool isEmpty() const
+  {
+    for (uint8_t page = 0; page < pageCount; page++)
+    {
+      if (isPageDirty(page))
+        return false;
+    }
+    return true;
+  }
+
+  // First and last damaged column of a page (only valid if isPageDirty)
+  int pageStart(uint8_t page) const { return firstColumn[page]; }
+  int pageEnd(uint8_t page) const { return lastColumn[page]; }
+
+  uint8_t getPageCount() const { return pageCount; }
+  int getWidth() const { return panelWidth; }
+
+private:
+  int panelWidth;
+  uint8_t pageCount;
+  int16_t firstColumn[MAX_PAGES]; // First damaged column per page
+  int16_t lastColumn[MAX_PAGES];  // Last damaged column per page (-1 if clean)
+};
+
+#endif // DIRTY_REGION_H
@@ -0,0 +1,86 @@
+#ifndef DISPLAY_BASE_H
+#define DISPLAY_BASE_H
+
+#include "DisplayInterface.h"
+
+// Base of the concrete displays (CRTP). It repeats the drawing entry points
+// of DisplayInterface, with the same clipping and translation, but calls the
+// hooks of Derived directly. Code holding the concrete type, such as the
+// draw(Display&) templates of the views, therefore makes no virtual call per
+// primitive, and the compiler may inline the hooks defined in the header.
+//
+// Derived must be final and declare DisplayBase<Derived> a friend, since its
+// hooks are protected.
+template <typename Derived>
+class DisplayBase : public DisplayInterface {
+public:
+  // --- Pixel-level control ---
+  void drawPixel(int x, int y, int color) {
+    x = translateX(x);
+    y = translateY(y);
+    if (clipRect().contains(x, y)) self().doDrawPixel(x, y, color);
+  }
+
+  // --- Line & shape drawing ---
+  void drawFastHLine(int x, int y, int w, int color) {
+    if (touchesClip(x, y, x + w - 1, y)) self().doDrawFastHLine(translateX(x), translateY(y), w, color);
+  }
+  void drawFastVLine(int x, int y, int h, int color) {
+    if (touchesClip(x, y, x, y + h - 1)) self().doDrawFastVLine(translateX(x), translateY(y), h, color);
+  }
+  void drawLine(int x0, int y0, int x1, int y1, int color) {
+    if (touchesClip(x0, y0, x1, y1))
+      self().doDrawLine(translateX(x0), translateY(y0), translateX(x1), translateY(y1), color);
+  }
+  void drawRect(int x, int y, int w, int h, int color) {
+    if (touchesClip(x, y, x + w - 1, y + h - 1)) self().doDrawRect(translateX(x), translateY(y), w, h, color);
+  }
+  void fillRect(int x, int y, int w, int h, int color) {
+    if (touchesClip(x, y, x + w - 1, y + h - 1)) self().doFillRect(translateX(x), translateY(y), w, h, color);
+  }
+  void drawCircle(int x0, int y0, int r, int color) {
+    if (touchesClip(x0 - r, y0 - r, x0 + r, y0 + r)) self().doDrawCircle(translateX(x0), translateY(y0), r, color);
+  }
+  void fillCircle(int x0, int y0, int r, int color) {
+    if (touchesClip(x0 - r, y0 - r, x0 + r, y0 + r)) self().doFillCircle(translateX(x0), translateY(y0), r, color);
+  }
+  void drawTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) {
+    if (touchesClip(x0, y0, x1, y1, x2, y2))
+      self().doDrawTriangle(translateX(x0), translateY(y0), translateX(x1), translateY(y1),
+                            translateX(x2), translateY(y2), color);
+  }
+  void fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) {
+    if (touchesClip(x0, y0, x1, y1, x2, y2))
+      self().doFillTriangle(translateX(x0), translateY(y0), translateX(x1), translateY(y1),
+                            translateX(x2), translateY(y2), color);
+  }
+  void drawRoundRect(int x, int y, int w, int h, int r, int color) {
+    if (touchesClip(x, y, x + w - 1, y + h - 1)) self().doDrawRoundRect(translateX(x), translateY(y), w, h, r, color);
+  }
+  void fillRoundRect(int x, int y, int w, int h, int r, int color) {
+    if (touchesClip(x, y, x + w - 1, y + h - 1)) self().doFillRoundRect(translateX(x), translateY(y), w, h, r, color);
+  }
+
+  // --- Bulk drawing ---
+  void drawBitmap(int x, int y, const Bitmap& bitmap, RasterOp op = RasterOp::OR) {
+    drawBitmap(x, y, bitmap, 0, 0, bitmap.width, bitmap.height, op);
+  }
+  void drawBitmap(int x, int y, const Bitmap& bitmap, int srcX, int srcY, int w, int h, RasterOp op) {
+    if (touchesClip(x, y, x + w - 1, y + h - 1))
+      self().doDrawBitmap(translateX(x), translateY(y), bitmap, srcX, srcY, w, h, op);
+  }
+  void fillSpan(int x, int y, int w, int color) {
+    if (w > 0 && touchesClip(x, y, x + w - 1, y)) self().doFillSpan(translateX(x), translateY(y), w, color);
+  }
+
+  // --- Text handling ---
+  void setCursor(int x, int y) { self().doSetCursor(translateX(x), translateY(y)); }
+
+  // --- Damage tracking ---
+  void invalidateRect(int x, int y, int w, int h) { self().doInvalidateRect(translateX(x), translateY(y), w, h); }
+
+private:
+  Derived& self() { return static_cast<Derived&>(*this); }
+};
+
+#endif // DISPLAY_BASE_H
@@ -1,47 +1,307 @@
 #ifndef DISPLAY_INTERFACE_H
 #define DISPLAY_INTERFACE_H
 
+#include "Bitmap.h"
+#include "GlyphString.h"
+#include "TextFormat.h"
+#include "../ui/Rect.h"
+#include <stddef.h>
+
 // Abstract interface for display functionality
 // This allows different types of displays to be used interchangeably
+//
+// Drawing goes through a clip and origin stack (see pushClip/pushViewport).
+// The public primitives translate their coordinates, skip shapes that miss
+// the clip and pass the rest to the protected do* hooks, which every display
+// implements in absolute coordinates without touching pixels outside clipRect().
+//
+// The views also have a draw(Display&) template for the concrete display
+// type, which derives from DisplayBase (DisplayBase.h): there every hook is
+// bound at compile time and may be inlined into the view's loops. draw()
+// keeps going through this interface, for code that mixes display types.
 class DisplayInterface {
 public:
   virtual ~DisplayInterface() = default;
 
   // --- Pixel-level control ---
-  virtual void drawPixel(int x, int y, int color) = 0;
+  void drawPixel(int x, int y, int color) {
+    x += originX;
+    y += originY;
+    if (clip.contains(x, y)) doDrawPixel(x, y, color);
+  }
 
   // --- Line & shape drawing ---
-  virtual void drawFastHLine(int x, int y, int w, int color) = 0;
-  virtual void drawFastVLine(int x, int y, int h, int color) = 0;
-  virtual void drawLine(int x0, int y0, int x1, int y1, int color) = 0;
-  virtual void drawRect(int x, int y, int w, int h, int color) = 0;
-  virtual void fillRect(int x, int y, int w, int h, int color) = 0;
-  virtual void drawCircle(int x0, int y0, int r, int color) = 0;
-  virtual void fillCircle(int x0, int y0, int r, int color) = 0;
-  virtual void drawTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) = 0;
-  virtual void fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) = 0;
-  virtual void drawRoundRect(int x, int y, int w, int h, int r, int color) = 0;
-  virtual void fillRoundRect(int x, int y, int w, int h, int r, int color) = 0;
+  void drawFastHLine(int x, int y, int w, int color) {
+    if (touchesClip(x, y, x + w - 1, y)) doDrawFastHLine(x + originX, y + originY, w, color);
+  }
+  void drawFastVLine(int x, int y, int h, int color) {
+    if (touchesClip(x, y, x, y + h - 1)) doDrawFastVLine(x + originX, y + originY, h, color);
+  }
+  void drawLine(int x0, int y0, int x1, int y1, int color) {
+    if (touchesClip(x0, y0, x1, y1)) doDrawLine(x0 + originX, y0 + originY, x1 + originX, y1 + originY, color);
+  }
+  void drawRect(int x, int y, int w, int h, int color) {
+    if (touchesClip(x, y, x + w - 1, y + h - 1)) doDrawRect(x + originX, y + originY, w, h, color);
+  }
+  void fillRect(int x, int y, int w, int h, int color) {
+    if (touchesClip(x, y, x + w - 1, y + h - 1)) doFillRect(x + originX, y + originY, w, h, color);
+  }
+  void drawCircle(int x0, int y0, int r, int color) {
+    if (touchesClip(x0 - r, y0 - r, x0 + r, y0 + r)) doDrawCircle(x0 + originX, y0 + originY, r, color);
+  }
+  void fillCircle(int x0, int y0, int r, int color) {
+    if (touchesClip(x0 - r, y0 - r, x0 + r, y0 + r)) doFillCircle(x0 + originX, y0 + originY, r, color);
+  }
+  void drawTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) {
+    if (touchesClip(x0, y0, x1, y1, x2, y2))
+      doDrawTriangle(x0 + originX, y0 + originY, x1 + originX, y1 + originY, x2 + originX, y2 + originY, color);
+  }
+  void fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) {
+    if (touchesClip(x0, y0, x1, y1, x2, y2))
+      doFillTriangle(x0 + originX, y0 + originY, x1 + originX, y1 + originY, x2 + originX, y2 + originY, color);
+  }
+  void drawRoundRect(int x, int y, int w, int h, int r, int color) {
+    if (touchesClip(x, y, x + w - 1, y + h - 1)) doDrawRoundRect(x + originX, y + originY, w, h, r, color);
+  }
+  void fillRoundRect(int x, int y, int w, int h, int r, int color) {
+    if (touchesClip(x, y, x + w - 1, y + h - 1)) doFillRoundRect(x + originX, y + originY, w, h, r, color);
+  }
+
+  // --- Bulk drawing ---
+  // Combines a packed 1bpp bitmap (see Bitmap.h) with the frame at (x, y)
+  void drawBitmap(int x, int y, const Bitmap& bitmap, RasterOp op = RasterOp::OR) {
+    drawBitmap(x, y, bitmap, 0, 0, bitmap.width, bitmap.height, op);
+  }
+
+  // Same, but only the source rectangle (srcX, srcY, w, h) of the bitmap is drawn;
+  // the rectangle is clipped to the bitmap
+  void drawBitmap(int x, int y, const Bitmap& bitmap, int srcX, int srcY, int w, int h, RasterOp op) {
+    if (touchesClip(x, y, x + w - 1, y + h - 1))
+      doDrawBitmap(x + originX, y + originY, bitmap, srcX, srcY, w, h, op);
+  }
+
+  // Fills 'w' pixels of row y starting at x (nothing is drawn for w <= 0)
+  void fillSpan(int x, int y, int w, int color) {
+    if (w > 0 && touchesClip(x, y, x + w - 1, y)) doFillSpan(x + originX, y + originY, w, color);
+  }
+
+  // --- Clipping and viewports ---
+  // pushClip limits drawing to a rectangle; pushViewport also moves the origin
+  // to its top-left corner, so a view can draw from (0, 0) wherever it is
+  // placed. Both take current coordinates, intersect with the enclosing clip
+  // and are undone by popClip. Text is clipped too, cursor included.
+  void pushClip(int x, int y, int w, int h) { push(Rect(x, y, w, h), false); }
+  void pushClip(const Rect& area) { push(area, false); }
+  void pushViewport(int x, int y, int w, int h) { push(Rect(x, y, w, h), true); }
+  void pushViewport(const Rect& area) { push(area, true); }
+
+  void popClip() {
+    if (overflow > 0) {
+      overflow--;
+      return;
+    }
+    if (depth == 0) return;
+    const ClipState& saved = stack[--depth];
+    clip = saved.clip;
+    originX = saved.originX;
+    originY = saved.originY;
+    clipChanged();
+  }
+
+  // Current clip in current coordinates
+  Rect getClipRect() const {
+    return Rect(clip.x - originX, clip.y - originY, clip.w, clip.h);
+  }
+
+  // False when nothing drawn inside 'area' (current coordinates) can show;
+  // widgets use it to skip work for parts that are scrolled or clipped away
+  bool isVisible(const Rect& area) const {
+    return Rect(area.x + originX, area.y + originY, area.w, area.h).intersects(clip);
+  }
 
   // --- Text handling ---
-  virtual void setCursor(int x, int y) = 0;
+  void setCursor(int x, int y) { doSetCursor(x + originX, y + originY); }
   virtual void setTextColor(int color) = 0;
   virtual void setTextColor(int color, int background) = 0;
   virtual void setTextSize(int size) = 0;
   virtual void setTextWrap(bool wrap) = 0;
-  virtual void print(const char* text) = 0;
+  virtual void print(const char* text) = 0;           // UTF-8
+  // Prints 'count' glyph indices of the built-in font (see GlyphString.h)
+  virtual void printGlyphs(const uint8_t* glyphs, size_t count) = 0;
+  void printGlyphs(const GlyphString& text) { printGlyphs(text.data(), text.length()); }
   virtual void println(const char* text) = 0;
+  // Formats into a fixed stack buffer with vsnprintf; output past it is cut.
+  // Prefer the typed print overloads below in code that runs every frame.
   virtual void printf(const char* format, ...) = 0;
 
+  // --- Typed text (see TextFormat.h) ---
+  // Numbers are rendered straight to glyphs, without printf or heap allocation
+  void print(char c) { printField(c); }
+  void print(long value) { print(IntField{value, 0, ' '}); }
+  void print(int value) { print(static_cast<long>(value)); }
+  void print(const IntField& field) { printField(field); }
+  void print(const FixedPoint& number) { printField(number); }
+
+  template <size_t N>
+  void print(const TextBuffer<N>& text) { printGlyphs(text.data(), text.length()); }
+
+  // Format checked at compile time, e.g. print(TIME_FORMAT, hours, minutes)
+  template <typename... Args>
+  void print(const TextFormat<Args...>& format, typename std::common_type<Args>::type... values) {
+    TextBuffer<TextFormat<Args...>::CAPACITY> text;
+    format.render(text, values...);
+    printGlyphs(text.data(), text.length());
+  }
+
   // --- Display buffer control ---
   virtual void display() = 0;         // Pushes buffer to display
   virtual void clearDisplay() = 0;    // Clears buffer
   virtual void setRotation(int rotation) = 0;
   virtual void invertDisplay(bool invert) = 0;
 
+  // --- Panel power ---
+  // Panels without these controls ignore them
+  virtual void setContrast(uint8_t /*contrast*/) {}
+  virtual void setPowerSave(bool /*enabled*/) {} // Blanks the panel; its content is kept
+
+  // --- Damage tracking ---
+  // Displays that flush only changed regions track what the primitives above
+  // touch. These let callers report changes made behind the display's back.
+  void invalidateRect(int x, int y, int w, int h) { doInvalidateRect(x + originX, y + originY, w, h); } // Region must be resent
+  virtual void invalidateAll() {} // Next display() sends the full frame
+
   // --- Display dimensions ---
+  // Size of the whole display, whatever the current viewport
   virtual int width() const = 0;
   virtual int height() const = 0;
+
+protected:
+  // --- Drawing hooks ---
+  // Absolute coordinates; shapes may reach outside clipRect() but must only
+  // change pixels inside it
+  virtual void doDrawPixel(int x, int y, int color) = 0;
+  virtual void doDrawFastHLine(int x, int y, int w, int color) = 0;
+  virtual void doDrawFastVLine(int x, int y, int h, int color) = 0;
+  virtual void doDrawLine(int x0, int y0, int x1, int y1, int color) = 0;
+  virtual void doDrawRect(int x, int y, int w, int h, int color) = 0;
+  virtual void doFillRect(int x, int y, int w, int h, int color) = 0;
+  virtual void doDrawCircle(int x0, int y0, int r, int color) = 0;
+  virtual void doFillCircle(int x0, int y0, int r, int color) = 0;
+  virtual void doDrawTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) = 0;
+  virtual void doFillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) = 0;
+  virtual void doDrawRoundRect(int x, int y, int w, int h, int r, int color) = 0;
+  virtual void doFillRoundRect(int x, int y, int w, int h, int r, int color) = 0;
+  virtual void doSetCursor(int x, int y) = 0;
+
+  // Displays with direct buffer access override this with byte-wide writes;
+  // the fallback goes through doDrawPixel
+  virtual void doDrawBitmap(int x, int y, const Bitmap& bitmap, int srcX, int srcY, int w, int h, RasterOp op) {
+    if (srcX < 0) { x -= srcX; w += srcX; srcX = 0; }
+    if (srcY < 0) { y -= srcY; h += srcY; srcY = 0; }
+    if (srcX + w > bitmap.width) w = bitmap.width - srcX;
+    if (srcY + h > bitmap.height) h = bitmap.height - srcY;
+
+    for (int row = 0; row < h; row++) {
+      for (int col = 0; col < w; col++) {
+        bool set = bitmap.getPixel(srcX + col, srcY + row);
+        int color = -1;
+        switch (op) {
+        case RasterOp::COPY:          color = set ? 1 : 0; break;
+        case RasterOp::OR:            if (set) color = 1; break;
+        case RasterOp::AND:           if (!set) color = 0; break;
+        case RasterOp::XOR:           if (set) color = 2; break;
+        case RasterOp::COPY_INVERTED: color = set ? 0 : 1; break;
+        case RasterOp::AND_INVERTED:  if (set) color = 0; break;
+        }
+        if (color >= 0) doDrawPixel(x + col, y + row, color);
+      }
+    }
+  }
+
+  virtual void doFillSpan(int x, int y, int w, int color) { doFillRect(x, y, w, 1, color); }
+  virtual void doInvalidateRect(int /*x*/, int /*y*/, int /*w*/, int /*h*/) {}
+
+  // Current clip in absolute coordinates
+  const Rect& clipRect() const { return clip; }
+
+  // Called after every push and pop, for displays that mirror the clip
+  virtual void clipChanged() {}
+
+  // Current coordinates to absolute ones
+  int translateX(int x) const { return x + originX; }
+  int translateY(int y) const { return y + originY; }
+
+  // Whether the bounding box of the given corners (current coordinates, any
+  // order) overlaps the clip
+  bool touchesClip(int x0, int y0, int x1, int y1) const {
+    int left = (x0 < x1 ? x0 : x1) + originX;
+    int right = (x0 < x1 ? x1 : x0) + originX;
+    int top = (y0 < y1 ? y0 : y1) + originY;
+    int bottom = (y0 < y1 ? y1 : y0) + originY;
+    return left < clip.right() && right >= clip.x && top < clip.bottom() && bottom >= clip.y;
+  }
+
+  bool touchesClip(int x0, int y0, int x1, int y1, int x2, int y2) const {
+    return touchesClip(x0 < x1 ? (x0 < x2 ? x0 : x2) : (x1 < x2 ? x1 : x2),
+                       y0 < y1 ? (y0 < y2 ? y0 : y2) : (y1 < y2 ? y1 : y2),
+                       x0 > x1 ? (x0 > x2 ? x0 : x2) : (x1 > x2 ? x1 : x2),
+                       y0 > y1 ? (y0 > y2 ? y0 : y2) : (y1 > y2 ? y1 : y2));
+  }
+
+private:
+  static constexpr int MAX_CLIP_DEPTH = 8;
+
+  struct ClipState {
+    Rect clip;
+    int originX;
+    int originY;
+  };
+
+  // Everything until a clip is pushed; displays clip to their own bounds
+  Rect clip{-32768, -32768, 65536, 65536};
+  int originX = 0;
+  int originY = 0;
+  ClipState stack[MAX_CLIP_DEPTH];
+  uint8_t depth = 0;
+  uint8_t overflow = 0; // Pushes past MAX_CLIP_DEPTH, ignored until popped
+
+  void push(const Rect& area, bool viewport) {
+    if (depth == MAX_CLIP_DEPTH) {
+      overflow++;
+      return;
+    }
+    stack[depth++] = ClipState{clip, originX, originY};
+    Rect absolute(area.x + originX, area.y + originY, area.w, area.h);
+    clip = clip.intersected(absolute);
+    if (viewport) {
+      originX = absolute.x;
+      originY = absolute.y;
+    }
+    clipChanged();
+  }
+
+  template <typename Field>
+  void printField(const Field& field) {
+    TextBuffer<TEXT_FIELD_CAPACITY> text;
+    text.append(field);
+    printGlyphs(text.data(), text.length());
+  }
+};
+
+// Pushes a clip, or a viewport, for the lifetime of the object
+class ScopedClip {
+public:
+  ScopedClip(DisplayInterface& display, const Rect& area, bool viewport = false) : display(display) {
+    if (viewport) display.pushViewport(area);
+    else display.pushClip(area);
+  }
+  ~ScopedClip() { display.popClip(); }
+
+  ScopedClip(const ScopedClip&) = delete;
+  ScopedClip& operator=(const ScopedClip&) = delete;
+
+private:
+  DisplayInterface& display;
 };
 
 #endif // DISPLAY_INTERFACE_H
@@ -1,61 +1,319 @@
+#ifndef DISPLAY_SH1106G_H
+#define DISPLAY_SH1106G_H
+
 #include <Adafruit_SH110X.h>
-#include "DisplayInterface.h"
+#include "DisplayBase.h"
+#include "DirtyRegion.h"
+#include "PageBuffer.h"
+#include "PageSink.h"
+#include "TextRenderer.h"
+#include "PageRotation.h"
+#include "AsyncFlusher.h"
+#include "../platform/Profiler.h"
 #include <cstdio>
 #include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+// Concrete implementation of DisplayInterface using the Adafruit_SH1106G OLED display.
+// Every drawing call records the area it touched; display() then compares those
+// areas against a copy of what the panel currently shows and only sends the
+// changed column spans of each page over I2C.
+// In double-buffered mode the transfer runs on a worker task (see AsyncFlusher)
+// so the UI can draw the next frame while the previous one is being sent.
+class DisplaySH1106G final : public DisplayBase<DisplaySH1106G> {
+  friend class DisplayBase<DisplaySH1106G>;
 
-// Concrete implementation of DisplayInterface using the Adafruit_SH1106G OLED display
-class DisplaySH1106G : public DisplayInterface {
 private:
-  Adafruit_SH1106G oled;  // Instance of the Adafruit SH1106G OLED display driver
+  // Thin extension of the Adafruit driver that can push a single page span
+  class Panel : public Adafruit_SH1106G, public PageSink {
+  public:
+    Panel(uint8_t _width, uint8_t _height, int8_t _reset)
+      : Adafruit_SH1106G(_width, _height, &Wire, _reset) {}
 
-public:
-  DisplaySH1106G(uint8_t _width, uint8_t _height, int8_t _reset)
-    : oled(_width, _height, &Wire, _reset) {}
+    // Switches the bus to the fast clock before a batch of writeSpan calls
+    void beginTransfer() override {
+      i2c_dev->setSpeed(i2c_preclk);
+    }
 
-  bool begin(uint8_t _i2caddr = 0x3C) {
-    
-    if (!oled.begin(_i2caddr, true)) {
-      return false;
+    // Restores the normal bus clock after a batch of writeSpan calls
+    void endTransfer() override {
+      i2c_dev->setSpeed(i2c_postclk);
     }
-    oled.clearDisplay();
-    oled.display();
-    return true;
+
+    // Sends columns [x0, x1] of one page taken from 'frame' to the panel
+    void writeSpan(uint8_t page, uint8_t x0, uint8_t x1, const uint8_t* frame) override {
+      const uint8_t* ptr = frame + page * WIDTH + x0;
+      uint16_t remaining = x1 - x0 + 1;
+      uint8_t column = x0 + _page_start_offset;
+      uint8_t dcByte = 0x40;
+      uint16_t maxChunk = i2c_dev->maxBufferSize() - 1;
+
+      uint8_t cmd[] = {0x00, (uint8_t)(SH110X_SETPAGEADDR + page), (uint8_t)(0x10 + (column >> 4)), (uint8_t)(column & 0x0F)};
+      i2c_dev->write(cmd, 4);
+      while (remaining) {
+        uint16_t chunk = std::min(remaining, maxChunk);
+        i2c_dev->write(ptr, chunk, true, &dcByte, 1);
+        ptr += chunk;
+        remaining -= chunk;
+        yield();
+      }
+    }
+
+    // Portrait canvas (see setTransposeOnFlush): while set, everything drawn
+    // through the driver, including Adafruit GFX shapes, goes into it
+    uint8_t* canvas = nullptr;
+
+    // Clip of the DisplayInterface in logical coordinates, corners inclusive.
+    // Every Adafruit GFX shape ends up in drawPixel, which applies it.
+    void setClip(int x0, int y0, int x1, int y1) {
+      clipX0 = x0;
+      clipY0 = y0;
+      clipX1 = x1;
+      clipY1 = y1;
+    }
+
+    // Frame that text and pixels go to, in logical coordinates when a canvas
+    // is set, clipped like the driver
+    PageBuffer target() {
+      PageBuffer frame = canvas ? PageBuffer(canvas, HEIGHT, WIDTH) : PageBuffer(buffer, WIDTH, HEIGHT);
+      frame.setClip(clipX0, clipY0, clipX1, clipY1);
+      return frame;
+    }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+      if (x < clipX0 || y < clipY0 || x > clipX1 || y > clipY1) {
+        return;
+      }
+      if (canvas) {
+        target().setPixel(x, y, color);
+      } else {
+        Adafruit_SH1106G::drawPixel(x, y, color);
+      }
+    }
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+      if (canvas && w > 0) {
+        target().fillSpan(x, x + w - 1, y, color);
+      } else {
+        Adafruit_SH1106G::drawFastHLine(x, y, w, color);
+      }
+    }
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+      if (canvas && h > 0) {
+        target().fillColumn(x, y, y + h - 1, color);
+      } else {
+        Adafruit_SH1106G::drawFastVLine(x, y, h, color);
+      }
+    }
+
+    // Prints UTF-8 text with the built-in 6x8 font, keeping the Adafruit cursor
+    // and colors. Size 1 text in the native orientation goes through the
+    // page-direct text engine; scaled or rotated text is drawn like
+    // Adafruit_GFX::drawChar. Custom GFX fonts are left to Adafruit.
+    void printText(const char* text) {
+      if (gfxFont) {
+        Adafruit_GFX::print(text);
+      } else if (canPrintDirect()) {
+        int x = cursor_x;
+        int y = cursor_y;
+        TextRenderer(target()).print(text, x, y, textcolor, textbgcolor, wrap);
+        cursor_x = x;
+        cursor_y = y;
+      } else {
+        while (*text) writeGlyph(fontGlyphIndex(utf8Next(text)));
+      }
+    }
+
+    // Same for glyph indices that are already decoded (see GlyphString.h)
+    void printGlyphs(const uint8_t* glyphs, size_t count) {
+      if (canPrintDirect()) {
+        int x = cursor_x;
+        int y = cursor_y;
+        TextRenderer(target()).printGlyphs(glyphs, count, x, y, textcolor, textbgcolor, wrap);
+        cursor_x = x;
+        cursor_y = y;
+      } else {
+        for (size_t i = 0; i < count; i++) writeGlyph(glyphs[i]);
+      }
+    }
+
+  private:
+    int clipX0 = INT16_MIN;
+    int clipY0 = INT16_MIN;
+    int clipX1 = INT16_MAX;
+    int clipY1 = INT16_MAX;
+
+    bool canPrintDirect() const {
+      return textsize_x == 1 && textsize_y == 1 && (getRotation() == 0 || canvas);
+    }
+
+    // Cursor handling of Adafruit_GFX::write for one glyph of the built-in font
+    void writeGlyph(uint8_t glyph) {
+      if (glyph == '\n') {
+        cursor_x = 0;
+        cursor_y += textsize_y * FONT_6X8_HEIGHT;
+      } else if (glyph != '\r') {
+        if (wrap && cursor_x + textsize_x * FONT_6X8_WIDTH > _width) {
+          cursor_x = 0;
+          cursor_y += textsize_y * FONT_6X8_HEIGHT;
+        }
+        drawGlyph(cursor_x, cursor_y, fontGlyph(glyph));
+        cursor_x += textsize_x * FONT_6X8_WIDTH;
+      }
+    }
+
+    // Adafruit_GFX::drawChar with the glyph columns of the built-in font
+    void drawGlyph(int16_t x, int16_t y, const uint8_t* columns) {
+      for (int8_t i = 0; i < FONT_6X8_COLUMNS; i++) {
+        uint8_t line = columns[i];
+        for (int8_t j = 0; j < FONT_6X8_HEIGHT; j++, line >>= 1) {
+          if (line & 1) {
+            fillRect(x + i * textsize_x, y + j * textsize_y, textsize_x, textsize_y, textcolor);
+          } else if (textbgcolor != textcolor) {
+            fillRect(x + i * textsize_x, y + j * textsize_y, textsize_x, textsize_y, textbgcolor);
+          }
+        }
+      }
+      // Opaque text also paints the spacing column
+      if (textbgcolor != textcolor) {
+        fillRect(x + FONT_6X8_COLUMNS * textsize_x, y, textsize_x, FONT_6X8_HEIGHT * textsize_y, textbgcolor);
+      }
+    }
+  };
+
+  Panel oled;              // Instance of the Adafruit SH1106G OLED display driver
+  DirtyRegion damage;      // Areas drawn since the last flush (physical coordinates)
+  uint8_t* shadow;         // Copy of the frame currently shown on the panel
+  int panelWidth;          // Physical width in pixels
+  int panelHeight;         // Physical height in pixels
+  int textSize = 1;        // Current text scale, needed to size text damage
+  bool partialUpdates = true;      // Send only changed spans instead of full frames
+  bool fullRefreshPending = true;  // Next display() must push the whole frame
+  AsyncFlusher* flusher = nullptr; // Set while double-buffered mode is enabled
+  bool transposeOnFlush = true;    // Portrait frames go through oled.canvas
+
+  // Panel commands share the bus with the flush worker
+  void waitForFlush() {
+    if (flusher) flusher->waitIdle();
   }
 
-  void drawFastHLine(int x, int y, int w, int color) override {
-    oled.drawFastHLine(x, y, w, color);
+  // Fast paths write straight into a page buffer: the driver's in the native
+  // orientation, the portrait canvas in rotations 1 and 3. Upside-down
+  // drawing goes through Adafruit GFX.
+  bool directAccess() {
+    return oled.getRotation() == 0 || oled.canvas;
   }
 
-  void drawFastVLine(int x, int y, int h, int color) override {
-    oled.drawFastVLine(x, y, h, color);
+  PageBuffer frame() {
+    return oled.target();
   }
 
-  void drawLine(int x0, int y0, int x1, int y1, int color) override {
-    oled.drawLine(x0, y0, x1, y1, color);
+  PageBuffer panelFrame() {
+    return PageBuffer(oled.getBuffer(), panelWidth, panelHeight);
   }
 
-  void drawRect(int x, int y, int w, int h, int color) override {
-    oled.drawRect(x, y, w, h, color);
+  PageBuffer canvasFrame() {
+    return PageBuffer(oled.canvas, panelHeight, panelWidth);
   }
 
-  void fillRect(int x, int y, int w, int h, int color) override {
-    oled.fillRect(x, y, w, h, color);
+  // Copies the canvas into the driver's buffer and releases it
+  void releaseCanvas() {
+    if (!oled.canvas) return;
+    PageBuffer panel = panelFrame();
+    rotateFrame(canvasFrame(), panel, oled.getRotation());
+    delete[] oled.canvas;
+    oled.canvas = nullptr;
   }
 
-  void drawCircle(int x0, int y0, int r, int color) override {
-    oled.drawCircle(x0, y0, r, color);
+  int bufferSize() const {
+    return panelWidth * ((panelHeight + 7) / 8);
   }
 
-  void fillCircle(int x0, int y0, int r, int color) override {
-    oled.fillCircle(x0, y0, r, color);
+  // Records the part of a logical (rotated) rectangle inside the clip as damaged
+  void markDamage(int x, int y, int w, int h) {
+    if (w < 0) {
+      x += w + 1;
+      w = -w;
+    }
+    if (h < 0) {
+      y += h + 1;
+      h = -h;
+    }
+
+    Rect area = Rect(x, y, w, h).intersected(clipRect());
+    if (!area.isEmpty()) {
+      markUnclipped(area.x, area.y, area.w, area.h);
+    }
   }
 
-  void drawRoundRect(int x, int y, int w, int h, int r, int color) override {
-    oled.drawRoundRect(x, y, w, h, r, color);
+  void markUnclipped(int x, int y, int w, int h) {
+    switch (oled.getRotation()) {
+    case 1:
+      damage.markRect(panelWidth - y - h, x, h, w);
+      break;
+    case 2:
+      damage.markRect(panelWidth - x - w, panelHeight - y - h, w, h);
+      break;
+    case 3:
+      damage.markRect(y, panelHeight - x - w, h, w);
+      break;
+    default:
+      damage.markRect(x, y, w, h);
+      break;
+    }
   }
 
-  void fillRoundRect(int x, int y, int w, int h, int r, int color) override {
-    oled.fillRoundRect(x, y, w, h, r, color);
+  // Records the bounding box of two points as damaged
+  void markLineDamage(int x0, int y0, int x1, int y1) {
+    markDamage(std::min(x0, x1), std::min(y0, y1), abs(x1 - x0) + 1, abs(y1 - y0) + 1);
+  }
+
+  // Records the area covered by text printed from (x0, y0) to the current cursor
+  void markTextDamage(int x0, int y0) {
+    int x1 = oled.getCursorX();
+    int y1 = oled.getCursorY();
+    int lineHeight = 8 * textSize;
+
+    if (y1 == y0) {
+      markDamage(x0, y0, x1 - x0, lineHeight);
+    } else {
+      // Text wrapped or contained newlines: damage the full rows it went through
+      markDamage(0, std::min(y0, y1), oled.width(), abs(y1 - y0) + lineHeight);
+    }
+  }
+
+public:
+  DisplaySH1106G(uint8_t _width, uint8_t _height, int8_t _reset)
+    : oled(_width, _height, _reset),
+      damage(_width, _height),
+      panelWidth(_width),
+      panelHeight(_height) {
+    shadow = new uint8_t[bufferSize()];
+    memset(shadow, 0, bufferSize());
+  }
+
+  ~DisplaySH1106G() {
+    delete flusher;
+    delete[] oled.canvas;
+    delete[] shadow;
+  }
+
+  bool begin(uint8_t _i2caddr = 0x3C) {
+
+    if (!oled.begin(_i2caddr, true)) {
+      return false;
+    }
+    oled.clearDisplay();
+    oled.display();
+
+    // The panel is blank now and so is our copy of it
+    memset(shadow, 0, bufferSize());
+    damage.clear();
+    fullRefreshPending = false;
+    return true;
   }
 
   int width() const override {
@@ -78,24 +336,33 @@ public:
     oled.setTextColor(color, background);
   }
 
-  void setCursor(int x, int y) override {
-    oled.setCursor(x, y);
-  }
-
   void setTextSize(int size) override {
     oled.setTextSize(size);
+    textSize = size > 0 ? size : 1;
   }
 
-  void drawPixel(int x, int y, int color) override {
-    oled.drawPixel(x, y, color);
+  using DisplayInterface::print;
+  void print(const char* text) override {
+    int x0 = oled.getCursorX();
+    int y0 = oled.getCursorY();
+    oled.printText(text);
+    markTextDamage(x0, y0);
   }
 
-  void print(const char* text) override {
-    oled.print(text);
+  using DisplayInterface::printGlyphs;
+  void printGlyphs(const uint8_t* glyphs, size_t count) override {
+    int x0 = oled.getCursorX();
+    int y0 = oled.getCursorY();
+    oled.printGlyphs(glyphs, count);
+    markTextDamage(x0, y0);
   }
 
   void println(const char* text) override {
-    oled.println(text);
+    int x0 = oled.getCursorX();
+    int y0 = oled.getCursorY();
+    oled.printText(text);
+    oled.printText("\r\n");
+    markTextDamage(x0, y0);
   }
 
   void printf(const char* format, ...) override {
@@ -104,34 +371,248 @@ public:
     va_start(args, format);
     vsnprintf(buffer, sizeof(buffer), format, args);
     va_end(args);
-    oled.print(buffer);
-  }
-
-  void drawTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) override {
-    oled.drawTriangle(x0, y0, x1, y1, x2, y2, color);
-  }
-
-  void fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) override {
-    oled.fillTriangle(x0, y0, x1, y1, x2, y2, color);
+    print(buffer);
   }
 
   void clearDisplay() override {
+    PROFILE_SCOPE("DisplaySH1106G::clearDisplay");
     oled.clearDisplay();
+    if (oled.canvas) canvasFrame().fill(0);
+    damage.markAll();
   }
 
+  // Rotations 1 and 3 render into an unrotated portrait canvas when
+  // transpose-on-flush is enabled (see setTransposeOnFlush).
+  // As with Adafruit GFX, what is already in the frame stays where it is.
   void setRotation(int rotation) override {
+    releaseCanvas();
     oled.setRotation(rotation);
+
+    const bool portrait = oled.getRotation() & 1;
+    if (portrait && transposeOnFlush && panelWidth % 8 == 0 && panelHeight % 8 == 0) {
+      oled.canvas = new uint8_t[bufferSize()];
+      PageBuffer portraitFrame = canvasFrame();
+      rotateFrame(panelFrame(), portraitFrame, 4 - oled.getRotation());
+    }
+  }
+
+  // In portrait (rotations 1 and 3) draw every primitive, glyph and bitmap
+  // unrotated into a canvas with the fast landscape paths, and turn the
+  // damaged 8x8 blocks into the panel layout in display(). Enabled by
+  // default; disabling it saves the canvas (one frame of RAM) and draws
+  // portrait frames pixel by pixel through Adafruit GFX.
+  void setTransposeOnFlush(bool enabled) {
+    transposeOnFlush = enabled;
+    setRotation(oled.getRotation());
+  }
+
+  bool getTransposeOnFlush() const {
+    return transposeOnFlush;
   }
 
   void invertDisplay(bool invert) override {
+    waitForFlush();
     oled.invertDisplay(invert);
   }
 
+  void setContrast(uint8_t contrast) override {
+    waitForFlush();
+    oled.setContrast(contrast);
+  }
+
+  // The controller keeps its RAM while the display is off, so nothing is resent on wake
+  void setPowerSave(bool enabled) override {
+    waitForFlush();
+    oled.oled_command(enabled ? SH110X_DISPLAYOFF : SH110X_DISPLAYON);
+  }
+
+  // Pushes the changed parts of the buffer to the panel.
+  // Only damaged spans that really differ from what the panel shows are sent;
+  // with partial updates disabled (or after invalidateAll) the full frame is sent.
+  // In double-buffered mode this only hands the frame to the flush worker.
   void display() override {
-    oled.display();
+    PROFILE_SCOPE("DisplaySH1106G::display");
+    bool full = !partialUpdates || fullRefreshPending;
+
+    if (oled.canvas) {
+      PageBuffer panel = panelFrame();
+      if (full) {
+        rotateFrame(canvasFrame(), panel, oled.getRotation());
+      } else {
+        rotateFrame(canvasFrame(), panel, oled.getRotation(), damage);
+      }
+    }
+
+    if (flusher) {
+      flusher->submit(oled.getBuffer(), damage, full);
+    } else {
+      if (full) damage.markAll();
+      flushPageSpans(oled, oled.getBuffer(), shadow, damage, !full);
+    }
+
+    damage.clear();
+    fullRefreshPending = false;
   }
 
+  void invalidateAll() override {
+    fullRefreshPending = true;
+  }
+
+  // Enables or disables partial (changed spans only) flushing
+  void setPartialUpdates(bool enabled) {
+    partialUpdates = enabled;
+    if (enabled) fullRefreshPending = true; // Panel content must be known again
+  }
+
+  bool getPartialUpdates() const {
+    return partialUpdates;
+  }
+
+  // Enables double-buffered mode: frames are sent by a worker task pinned to
+  // 'core' (the Arduino loop runs on core 1). Returns false if the worker
+  // could not be started, in which case flushing stays synchronous.
+  bool setDoubleBuffered(bool enabled, int core = 0) {
+    if (enabled == (flusher != nullptr)) return true;
+
+    if (enabled) {
+      flusher = new AsyncFlusher(oled, panelWidth, panelHeight);
+      if (!flusher->start(core)) {
+        delete flusher;
+        flusher = nullptr;
+        return false;
+      }
+    } else {
+      delete flusher; // Sends the frame in flight first
+      flusher = nullptr;
+    }
+
+    fullRefreshPending = true; // The new path has no record of the panel content
+    return true;
+  }
+
+  bool isDoubleBuffered() const {
+    return flusher != nullptr;
+  }
+
+  // Direct access to the driver. Anything drawn through it bypasses damage
+  // tracking, so call doInvalidateRect()/invalidateAll() afterwards. In
+  // double-buffered mode do not send commands through it while a flush may be running.
   Adafruit_SH1106G& getDisplay() {
     return oled;
   }
+
+protected:
+  // --- Drawing hooks (see DisplayInterface) ---
+  void doDrawPixel(int x, int y, int color) override {
+    if (directAccess()) {
+      frame().setPixel(x, y, color);
+    } else {
+      oled.drawPixel(x, y, color);
+    }
+    markDamage(x, y, 1, 1);
+  }
+
+  void doDrawFastHLine(int x, int y, int w, int color) override {
+    if (w > 0 && directAccess()) {
+      frame().fillSpan(x, x + w - 1, y, color);
+    } else {
+      oled.drawFastHLine(x, y, w, color);
+    }
+    markDamage(x, y, w, 1);
+  }
+
+  void doDrawFastVLine(int x, int y, int h, int color) override {
+    if (h > 0 && directAccess()) {
+      frame().fillColumn(x, y, y + h - 1, color);
+    } else {
+      oled.drawFastVLine(x, y, h, color);
+    }
+    markDamage(x, y, 1, h);
+  }
+
+  void doDrawLine(int x0, int y0, int x1, int y1, int color) override {
+    oled.drawLine(x0, y0, x1, y1, color);
+    markLineDamage(x0, y0, x1, y1);
+  }
+
+  void doDrawRect(int x, int y, int w, int h, int color) override {
+    oled.drawRect(x, y, w, h, color);
+    markDamage(x, y, w, h);
+  }
+
+  void doFillRect(int x, int y, int w, int h, int color) override {
+    if (w > 0 && h > 0 && directAccess()) {
+      frame().fillRect(x, y, x + w - 1, y + h - 1, color);
+    } else {
+      oled.fillRect(x, y, w, h, color);
+    }
+    markDamage(x, y, w, h);
+  }
+
+  void doDrawCircle(int x0, int y0, int r, int color) override {
+    oled.drawCircle(x0, y0, r, color);
+    markDamage(x0 - r, y0 - r, 2 * r + 1, 2 * r + 1);
+  }
+
+  void doFillCircle(int x0, int y0, int r, int color) override {
+    oled.fillCircle(x0, y0, r, color);
+    markDamage(x0 - r, y0 - r, 2 * r + 1, 2 * r + 1);
+  }
+
+  void doDrawTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) override {
+    oled.drawTriangle(x0, y0, x1, y1, x2, y2, color);
+    markLineDamage(std::min({x0, x1, x2}), std::min({y0, y1, y2}), std::max({x0, x1, x2}), std::max({y0, y1, y2}));
+  }
+
+  void doFillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) override {
+    oled.fillTriangle(x0, y0, x1, y1, x2, y2, color);
+    markLineDamage(std::min({x0, x1, x2}), std::min({y0, y1, y2}), std::max({x0, x1, x2}), std::max({y0, y1, y2}));
+  }
+
+  void doDrawRoundRect(int x, int y, int w, int h, int r, int color) override {
+    oled.drawRoundRect(x, y, w, h, r, color);
+    markDamage(x, y, w, h);
+  }
+
+  void doFillRoundRect(int x, int y, int w, int h, int r, int color) override {
+    oled.fillRoundRect(x, y, w, h, r, color);
+    markDamage(x, y, w, h);
+  }
+
+  void doDrawBitmap(int x, int y, const Bitmap& bitmap, int srcX, int srcY, int w, int h, RasterOp op) override {
+    if (directAccess()) {
+      frame().blit(x, y, bitmap, srcX, srcY, w, h, op);
+    } else {
+      DisplayInterface::doDrawBitmap(x, y, bitmap, srcX, srcY, w, h, op);
+    }
+    markDamage(x, y, w, h);
+  }
+
+  void doFillSpan(int x, int y, int w, int color) override {
+    if (w <= 0) return;
+    if (directAccess()) {
+      frame().fillSpan(x, x + w - 1, y, color);
+    } else {
+      oled.drawFastHLine(x, y, w, color);
+    }
+    markDamage(x, y, w, 1);
+  }
+
+  void doSetCursor(int x, int y) override {
+    oled.setCursor(x, y);
+  }
+
+  // Changes made behind the display's back are not limited by the clip
+  void doInvalidateRect(int x, int y, int w, int h) override {
+    if (w > 0 && h > 0) {
+      markUnclipped(x, y, w, h);
+    }
+  }
+
+  void clipChanged() override {
+    const Rect& clip = clipRect();
+    oled.setClip(clip.x, clip.y, clip.right() - 1, clip.bottom() - 1);
+  }
 };
+
+#endif // DISPLAY_SH1106G_H
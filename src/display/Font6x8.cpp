@@ -0,0 +1,410 @@
+#include "Font6x8.h"
+#include "Sprite.h"
+
+// Printable ASCII glyphs, identical to the corresponding entries of glcdfont.c
+const uint8_t FONT_6X8[FONT_6X8_LAST - FONT_6X8_FIRST + 1][FONT_6X8_COLUMNS] = {
+  { 0x00, 0x00, 0x00, 0x00, 0x00 }, // ' '
+  { 0x00, 0x00, 0x5F, 0x00, 0x00 }, // '!'
+  { 0x00, 0x07, 0x00, 0x07, 0x00 }, // '"'
+  { 0x14, 0x7F, 0x14, 0x7F, 0x14 }, // '#'
+  { 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, // '$'
+  { 0x23, 0x13, 0x08, 0x64, 0x62 }, // '%'
+  { 0x36, 0x49, 0x56, 0x20, 0x50 }, // '&'
+  { 0x00, 0x08, 0x07, 0x03, 0x00 }, // '''
+  { 0x00, 0x1C, 0x22, 0x41, 0x00 }, // '('
+  { 0x00, 0x41, 0x22, 0x1C, 0x00 }, // ')'
+  { 0x2A, 0x1C, 0x7F, 0x1C, 0x2A }, // '*'
+  { 0x08, 0x08, 0x3E, 0x08, 0x08 }, // '+'
+  { 0x00, 0x80, 0x70, 0x30, 0x00 }, // ','
+  { 0x08, 0x08, 0x08, 0x08, 0x08 }, // '-'
+  { 0x00, 0x00, 0x60, 0x60, 0x00 }, // '.'
+  { 0x20, 0x10, 0x08, 0x04, 0x02 }, // '/'
+  { 0x3E, 0x51, 0x49, 0x45, 0x3E }, // '0'
+  { 0x00, 0x42, 0x7F, 0x40, 0x00 }, // '1'
+  { 0x72, 0x49, 0x49, 0x49, 0x46 }, // '2'
+  { 0x21, 0x41, 0x49, 0x4D, 0x33 }, // '3'
+  { 0x18, 0x14, 0x12, 0x7F, 0x10 }, // '4'
+  { 0x27, 0x45, 0x45, 0x45, 0x39 }, // '5'
+  { 0x3C, 0x4A, 0x49, 0x49, 0x31 }, // '6'
+  { 0x41, 0x21, 0x11, 0x09, 0x07 }, // '7'
+  { 0x36, 0x49, 0x49, 0x49, 0x36 }, // '8'
+  { 0x46, 0x49, 0x49, 0x29, 0x1E }, // '9'
+  { 0x00, 0x00, 0x14, 0x00, 0x00 }, // ':'
+  { 0x00, 0x40, 0x34, 0x00, 0x00 }, // ';'
+  { 0x00, 0x08, 0x14, 0x22, 0x41 }, // '<'
+  { 0x14, 0x14, 0x14, 0x14, 0x14 }, // '='
+  { 0x00, 0x41, 0x22, 0x14, 0x08 }, // '>'
+  { 0x02, 0x01, 0x59, 0x09, 0x06 }, // '?'
+  { 0x3E, 0x41, 0x5D, 0x59, 0x4E }, // '@'
+  { 0x7C, 0x12, 0x11, 0x12, 0x7C }, // 'A'
+  { 0x7F, 0x49, 0x49, 0x49, 0x36 }, // 'B'
+  { 0x3E, 0x41, 0x41, 0x41, 0x22 }, // 'C'
+  { 0x7F, 0x41, 0x41, 0x41, 0x3E }, // 'D'
+  { 0x7F, 0x49, 0x49, 0x49, 0x41 }, // 'E'
+  { 0x7F, 0x09, 0x09, 0x09, 0x01 }, // 'F'
+  { 0x3E, 0x41, 0x41, 0x51, 0x73 }, // 'G'
+  { 0x7F, 0x08, 0x08, 0x08, 0x7F }, // 'H'
+  { 0x00, 0x41, 0x7F, 0x41, 0x00 }, // 'I'
+  { 0x20, 0x40, 0x41, 0x3F, 0x01 }, // 'J'
+  { 0x7F, 0x08, 0x14, 0x22, 0x41 }, // 'K'
+  { 0x7F, 0x40, 0x40, 0x40, 0x40 }, // 'L'
+  { 0x7F, 0x02, 0x1C, 0x02, 0x7F }, // 'M'
+  { 0x7F, 0x04, 0x08, 0x10, 0x7F }, // 'N'
+  { 0x3E, 0x41, 0x41, 0x41, 0x3E }, // 'O'
+  { 0x7F, 0x09, 0x09, 0x09, 0x06 }, // 'P'
+  { 0x3E, 0x41, 0x51, 0x21, 0x5E }, // 'Q'
+  { 0x7F, 0x09, 0x19, 0x29, 0x46 }, // 'R'
+  { 0x26, 0x49, 0x49, 0x49, 0x32 }, // 'S'
+  { 0x03, 0x01, 0x7F, 0x01, 0x03 }, // 'T'
+  { 0x3F, 0x40, 0x40, 0x40, 0x3F }, // 'U'
+  { 0x1F, 0x20, 0x40, 0x20, 0x1F }, // 'V'
+  { 0x3F, 0x40, 0x38, 0x40, 0x3F }, // 'W'
+  { 0x63, 0x14, 0x08, 0x14, 0x63 }, // 'X'
+  { 0x03, 0x04, 0x78, 0x04, 0x03 }, // 'Y'
+  { 0x61, 0x59, 0x49, 0x4D, 0x43 }, // 'Z'
+  { 0x00, 0x7F, 0x41, 0x41, 0x41 }, // '['
+  { 0x02, 0x04, 0x08, 0x10, 0x20 }, // '\'
+  { 0x00, 0x41, 0x41, 0x41, 0x7F }, // ']'
+  { 0x04, 0x02, 0x01, 0x02, 0x04 }, // '^'
+  { 0x40, 0x40, 0x40, 0x40, 0x40 }, // '_'
+  { 0x00, 0x03, 0x07, 0x08, 0x00 }, // '`'
+  { 0x20, 0x54, 0x54, 0x78, 0x40 }, // 'a'
+  { 0x7F, 0x28, 0x44, 0x44, 0x38 }, // 'b'
+  { 0x38, 0x44, 0x44, 0x44, 0x28 }, // 'c'
+  { 0x38, 0x44, 0x44, 0x28, 0x7F }, // 'd'
+  { 0x38, 0x54, 0x54, 0x54, 0x18 }, // 'e'
+  { 0x00, 0x08, 0x7E, 0x09, 0x02 }, // 'f'
+  { 0x18, 0xA4, 0xA4, 0x9C, 0x78 }, // 'g'
+  { 0x7F, 0x08, 0x04, 0x04, 0x78 }, // 'h'
+  { 0x00, 0x44, 0x7D, 0x40, 0x00 }, // 'i'
+  { 0x20, 0x40, 0x40, 0x3D, 0x00 }, // 'j'
+  { 0x7F, 0x10, 0x28, 0x44, 0x00 }, // 'k'
+  { 0x00, 0x41, 0x7F, 0x40, 0x00 }, // 'l'
+  { 0x7C, 0x04, 0x78, 0x04, 0x78 }, // 'm'
+  { 0x7C, 0x08, 0x04, 0x04, 0x78 }, // 'n'
+  { 0x38, 0x44, 0x44, 0x44, 0x38 }, // 'o'
+  { 0xFC, 0x18, 0x24, 0x24, 0x18 }, // 'p'
+  { 0x18, 0x24, 0x24, 0x18, 0xFC }, // 'q'
+  { 0x7C, 0x08, 0x04, 0x04, 0x08 }, // 'r'
+  { 0x48, 0x54, 0x54, 0x54, 0x24 }, // 's'
+  { 0x04, 0x04, 0x3F, 0x44, 0x24 }, // 't'
+  { 0x3C, 0x40, 0x40, 0x20, 0x7C }, // 'u'
+  { 0x1C, 0x20, 0x40, 0x20, 0x1C }, // 'v'
+  { 0x3C, 0x40, 0x30, 0x40, 0x3C }, // 'w'
+  { 0x44, 0x28, 0x10, 0x28, 0x44 }, // 'x'
+  { 0x4C, 0x90, 0x90, 0x90, 0x7C }, // 'y'
+  { 0x44, 0x64, 0x54, 0x4C, 0x44 }, // 'z'
+  { 0x00, 0x08, 0x36, 0x41, 0x00 }, // '{'
+  { 0x00, 0x00, 0x77, 0x00, 0x00 }, // '|'
+  { 0x00, 0x41, 0x36, 0x08, 0x00 }, // '}'
+  { 0x02, 0x01, 0x02, 0x04, 0x02 }  // '~'
+};
+
+// Hollow box shown for code points the font has no glyph for
+const uint8_t FONT_6X8_MISSING[FONT_6X8_COLUMNS] = { 0x7F, 0x41, 0x41, 0x41, 0x7F };
+
+// Latin glyphs beyond ASCII, drawn in the style of the classic font: accents
+// above lowercase letters use the two rows over the x-height, capitals are
+// squeezed like the umlauts of glcdfont, and the comma below Ș and Ț uses
+// the descender row.
+namespace
+{
+constexpr auto GLYPH_DEGREE = makeSprite<5, 8>(
+    ".##.."
+    "#..#."
+    "#..#."
+    ".##.."
+    "....."
+    "....."
+    "....."
+    ".....");
+
+constexpr auto GLYPH_A_CIRCUMFLEX_UPPER = makeSprite<5, 8>(
+    "..#.."
+    ".#.#."
+    "..#.."
+    ".#.#."
+    "#...#"
+    "#####"
+    "#...#"
+    ".....");
+
+constexpr auto GLYPH_A_DIAERESIS_UPPER = makeSprite<5, 8>(
+    "#.#.#"
+    ".#.#."
+    "#...#"
+    "#...#"
+    "#####"
+    "#...#"
+    "#...#"
+    ".....");
+
+constexpr auto GLYPH_I_CIRCUMFLEX_UPPER = makeSprite<5, 8>(
+    "..#.."
+    ".#.#."
+    ".###."
+    "..#.."
+    "..#.."
+    "..#.."
+    ".###."
+    ".....");
+
+constexpr auto GLYPH_O_DIAERESIS_UPPER = makeSprite<5, 8>(
+    "#...#"
+    "....."
+    ".###."
+    "#...#"
+    "#...#"
+    "#...#"
+    ".###."
+    ".....");
+
+constexpr auto GLYPH_U_DIAERESIS_UPPER = makeSprite<5, 8>(
+    "#...#"
+    "....."
+    "#...#"
+    "#...#"
+    "#...#"
+    "#...#"
+    ".###."
+    ".....");
+
+constexpr auto GLYPH_SHARP_S = makeSprite<5, 8>(
+    ".##.."
+    "#..#."
+    "#.#.."
+    "#..#."
+    "#...#"
+    "#...#"
+    "#.##."
+    ".....");
+
+constexpr auto GLYPH_A_GRAVE = makeSprite<5, 8>(
+    ".#..."
+    "..#.."
+    ".###."
+    "....#"
+    ".####"
+    "#...#"
+    ".####"
+    ".....");
+
+constexpr auto GLYPH_A_ACUTE = makeSprite<5, 8>(
+    "...#."
+    "..#.."
+    ".###."
+    "....#"
+    ".####"
+    "#...#"
+    ".####"
+    ".....");
+
+constexpr auto GLYPH_A_CIRCUMFLEX = makeSprite<5, 8>(
+    "..#.."
+    ".#.#."
+    ".###."
+    "....#"
+    ".####"
+    "#...#"
+    ".####"
+    ".....");
+
+constexpr auto GLYPH_A_DIAERESIS = makeSprite<5, 8>(
+    ".#.#."
+    "....."
+    ".###."
+    "....#"
+    ".####"
+    "#...#"
+    ".####"
+    ".....");
+
+constexpr auto GLYPH_C_CEDILLA = makeSprite<5, 8>(
+    "....."
+    "....."
+    ".###."
+    "#...."
+    "#...."
+    "#...#"
+    ".###."
+    "..#..");
+
+constexpr auto GLYPH_E_GRAVE = makeSprite<5, 8>(
+    ".#..."
+    "..#.."
+    ".###."
+    "#...#"
+    "#####"
+    "#...."
+    ".###."
+    ".....");
+
+constexpr auto GLYPH_E_ACUTE = makeSprite<5, 8>(
+    "...#."
+    "..#.."
+    ".###."
+    "#...#"
+    "#####"
+    "#...."
+    ".###."
+    ".....");
+
+constexpr auto GLYPH_E_CIRCUMFLEX = makeSprite<5, 8>(
+    "..#.."
+    ".#.#."
+    ".###."
+    "#...#"
+    "#####"
+    "#...."
+    ".###."
+    ".....");
+
+constexpr auto GLYPH_I_CIRCUMFLEX = makeSprite<5, 8>(
+    "..#.."
+    ".#.#."
+    ".##.."
+    "..#.."
+    "..#.."
+    "..#.."
+    ".###."
+    ".....");
+
+constexpr auto GLYPH_O_DIAERESIS = makeSprite<5, 8>(
+    ".#.#."
+    "....."
+    ".###."
+    "#...#"
+    "#...#"
+    "#...#"
+    ".###."
+    ".....");
+
+constexpr auto GLYPH_U_DIAERESIS = makeSprite<5, 8>(
+    ".#.#."
+    "....."
+    "#...#"
+    "#...#"
+    "#...#"
+    "#..##"
+    ".##.#"
+    ".....");
+
+constexpr auto GLYPH_A_BREVE_UPPER = makeSprite<5, 8>(
+    "#...#"
+    ".###."
+    "..#.."
+    ".#.#."
+    "#...#"
+    "#####"
+    "#...#"
+    ".....");
+
+constexpr auto GLYPH_A_BREVE = makeSprite<5, 8>(
+    ".#..#"
+    "..##."
+    ".###."
+    "....#"
+    ".####"
+    "#...#"
+    ".####"
+    ".....");
+
+constexpr auto GLYPH_S_COMMA_UPPER = makeSprite<5, 8>(
+    ".###."
+    "#...#"
+    "#...."
+    ".###."
+    "....#"
+    "#...#"
+    ".###."
+    "..#..");
+
+constexpr auto GLYPH_S_COMMA = makeSprite<5, 8>(
+    "....."
+    "....."
+    ".###."
+    "#...."
+    ".###."
+    "....#"
+    "####."
+    "..#..");
+
+constexpr auto GLYPH_T_COMMA_UPPER = makeSprite<5, 8>(
+    "#####"
+    "..#.."
+    "..#.."
+    "..#.."
+    "..#.."
+    "..#.."
+    "....."
+    "..#..");
+
+constexpr auto GLYPH_T_COMMA = makeSprite<5, 8>(
+    ".#..."
+    ".#..."
+    "###.."
+    ".#..."
+    ".#..."
+    ".#..#"
+    "..##."
+    "..#..");
+} // namespace
+
+// S and T with cedilla (ş, ţ) are still common in Romanian text and share the
+// comma-below glyphs
+const FontExtendedGlyph FONT_6X8_EXTENDED[] = {
+  { 0x00B0, GLYPH_DEGREE.bytes },             // °
+  { 0x00C2, GLYPH_A_CIRCUMFLEX_UPPER.bytes }, // Â
+  { 0x00C4, GLYPH_A_DIAERESIS_UPPER.bytes },  // Ä
+  { 0x00CE, GLYPH_I_CIRCUMFLEX_UPPER.bytes }, // Î
+  { 0x00D6, GLYPH_O_DIAERESIS_UPPER.bytes },  // Ö
+  { 0x00DC, GLYPH_U_DIAERESIS_UPPER.bytes },  // Ü
+  { 0x00DF, GLYPH_SHARP_S.bytes },            // ß
+  { 0x00E0, GLYPH_A_GRAVE.bytes },            // à
+  { 0x00E1, GLYPH_A_ACUTE.bytes },            // á
+  { 0x00E2, GLYPH_A_CIRCUMFLEX.bytes },       // â
+  { 0x00E4, GLYPH_A_DIAERESIS.bytes },        // ä
+  { 0x00E7, GLYPH_C_CEDILLA.bytes },          // ç
+  { 0x00E8, GLYPH_E_GRAVE.bytes },            // è
+  { 0x00E9, GLYPH_E_ACUTE.bytes },            // é
+  { 0x00EA, GLYPH_E_CIRCUMFLEX.bytes },       // ê
+  { 0x00EE, GLYPH_I_CIRCUMFLEX.bytes },       // î
+  { 0x00F6, GLYPH_O_DIAERESIS.bytes },        // ö
+  { 0x00FC, GLYPH_U_DIAERESIS.bytes },        // ü
+  { 0x0102, GLYPH_A_BREVE_UPPER.bytes },      // Ă
+  { 0x0103, GLYPH_A_BREVE.bytes },            // ă
+  { 0x015E, GLYPH_S_COMMA_UPPER.bytes },      // Ş
+  { 0x015F, GLYPH_S_COMMA.bytes },            // ş
+  { 0x0162, GLYPH_T_COMMA_UPPER.bytes },      // Ţ
+  { 0x0163, GLYPH_T_COMMA.bytes },            // ţ
+  { 0x0218, GLYPH_S_COMMA_UPPER.bytes },      // Ș
+  { 0x0219, GLYPH_S_COMMA.bytes },            // ș
+  { 0x021A, GLYPH_T_COMMA_UPPER.bytes },      // Ț
+  { 0x021B, GLYPH_T_COMMA.bytes },            // ț
+};
+
+const uint8_t FONT_6X8_EXTENDED_COUNT = sizeof(FONT_6X8_EXTENDED) / sizeof(FONT_6X8_EXTENDED[0]);
+
+static_assert(sizeof(FONT_6X8_EXTENDED) / sizeof(FONT_6X8_EXTENDED[0]) <= 0x100 - FONT_6X8_EXTENDED_FIRST,
+              "extended glyph indices must fit in a byte");
+
+uint8_t fontGlyphIndex(uint32_t codepoint)
+{
+  if ((codepoint >= FONT_6X8_FIRST && codepoint <= FONT_6X8_LAST) || codepoint == '\n' || codepoint == '\r')
+    return static_cast<uint8_t>(codepoint);
+
+  // Binary search in the sorted extended table
+  int low = 0;
+  int high = FONT_6X8_EXTENDED_COUNT - 1;
+  while (low <= high)
+  {
+    int mid = (low + high) / 2;
+    if (FONT_6X8_EXTENDED[mid].codepoint == codepoint)
+      return static_cast<uint8_t>(FONT_6X8_EXTENDED_FIRST + mid);
+    if (FONT_6X8_EXTENDED[mid].codepoint < codepoint)
+      low = mid + 1;
+    else
+      high = mid - 1;
+  }
+  return FONT_6X8_MISSING_INDEX;
+}
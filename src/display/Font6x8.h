@@ -0,0 +1,48 @@
+#ifndef FONT_6X8_H
+#define FONT_6X8_H
+
+#include <stdint.h>
+
+// The classic 5x7 font used by Adafruit GFX (6x8 cell including spacing).
+// Each glyph is stored as 5 column bytes, bit 0 being the top row, which is
+// the same layout the SH1106 uses for its pages.
+static constexpr uint8_t FONT_6X8_WIDTH = 6;      // Advance per character
+static constexpr uint8_t FONT_6X8_HEIGHT = 8;     // Cell height
+static constexpr uint8_t FONT_6X8_COLUMNS = 5;    // Columns stored per glyph
+static constexpr uint8_t FONT_6X8_FIRST = 0x20;   // First glyph in the table (space)
+static constexpr uint8_t FONT_6X8_LAST = 0x7E;    // Last glyph in the table (~)
+
+
+// Text is drawn from glyph indices, one byte per character: printable ASCII
+// keeps its code, '\n' and '\r' are kept as line controls, and the extra
+// Latin glyphs (Romanian diacritics and a few Western European letters) follow
+// from FONT_6X8_EXTENDED_FIRST. Use fontGlyphIndex() to map a code point.
+static constexpr uint8_t FONT_6X8_MISSING_INDEX = 0x7F;    // Index of the hollow box
+static constexpr uint8_t FONT_6X8_EXTENDED_FIRST = 0x80;   // Index of FONT_6X8_EXTENDED[0]
+
+// Extra glyph and the Unicode code point it stands for
+struct FontExtendedGlyph
+{
+  uint16_t codepoint;
+  const uint8_t* columns; // FONT_6X8_COLUMNS bytes
+};
+
+extern const uint8_t FONT_6X8[FONT_6X8_LAST - FONT_6X8_FIRST + 1][FONT_6X8_COLUMNS];
+extern const uint8_t FONT_6X8_MISSING[FONT_6X8_COLUMNS]; // Drawn for codes outside the table
+extern const FontExtendedGlyph FONT_6X8_EXTENDED[];      // Sorted by code point
+extern const uint8_t FONT_6X8_EXTENDED_COUNT;
+
+// Returns the glyph index used to draw a Unicode code point
+uint8_t fontGlyphIndex(uint32_t codepoint);
+
+// Returns the column bytes for a glyph index
+inline const uint8_t* fontGlyph(uint8_t index)
+{
+  if (index >= FONT_6X8_FIRST && index <= FONT_6X8_LAST)
+    return FONT_6X8[index - FONT_6X8_FIRST];
+  if (index >= FONT_6X8_EXTENDED_FIRST && index - FONT_6X8_EXTENDED_FIRST < FONT_6X8_EXTENDED_COUNT)
+    return FONT_6X8_EXTENDED[index - FONT_6X8_EXTENDED_FIRST].columns;
+  return FONT_6X8_MISSING;
+}
+
+#endif // FONT_6X8_H
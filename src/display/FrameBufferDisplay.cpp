@@ -0,0 +1,813 @@
+#include "FrameBufferDisplay.h"
+#include "Font6x8.h"
+#include "TextRenderer.h"
+#include "PageRotation.h"
+#include "../platform/Profiler.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+  void swapInt(int &a, int &b)
+  {
+    int t = a;
+    a = b;
+    b = t;
+  }
+
+  // --- PNG helpers ---
+
+  uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t length)
+  {
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++)
+    {
+      crc ^= data[i];
+      for (int bit = 0; bit < 8; bit++)
+        crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+    }
+    return ~crc;
+  }
+
+  void putBigEndian32(std::vector<uint8_t> &out, uint32_t value)
+  {
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+  }
+
+  // Appends a PNG chunk (length, type, data, CRC)
+  void putChunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data)
+  {
+    putBigEndian32(out, data.size());
+    size_t typeStart = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    putBigEndian32(out, crc32Update(0, out.data() + typeStart, out.size() - typeStart));
+  }
+}
+
+FrameBufferDisplay::FrameBufferDisplay(int width, int height)
+    : buffer(new uint8_t[width * ((height + 7) / 8)], width, height)
+{
+  buffer.fill(0);
+}
+
+FrameBufferDisplay::~FrameBufferDisplay()
+{
+  delete[] canvas;
+  delete[] buffer.data();
+}
+
+// --- Pixel-level control ---
+
+// Maps logical coordinates through the current rotation, like Adafruit_GrayOLED::drawPixel
+void FrameBufferDisplay::doDrawPixel(int x, int y, int color)
+{
+  if (!clipRect().contains(x, y))
+    return;
+
+  if (canvas)
+  {
+    canvasFrame().setPixel(x, y, color);
+    return;
+  }
+
+  switch (rotation)
+  {
+  case 1:
+    swapInt(x, y);
+    x = buffer.width() - x - 1;
+    break;
+  case 2:
+    x = buffer.width() - x - 1;
+    y = buffer.height() - y - 1;
+    break;
+  case 3:
+    swapInt(x, y);
+    y = buffer.height() - y - 1;
+    break;
+  }
+  buffer.setPixel(x, y, color);
+}
+
+bool FrameBufferDisplay::getPixel(int x, int y) const
+{
+  if (canvas)
+    return canvasFrame().getPixel(x, y);
+
+  switch (rotation)
+  {
+  case 1:
+    swapInt(x, y);
+    x = buffer.width() - x - 1;
+    break;
+  case 2:
+    x = buffer.width() - x - 1;
+    y = buffer.height() - y - 1;
+    break;
+  case 3:
+    swapInt(x, y);
+    y = buffer.height() - y - 1;
+    break;
+  }
+  return buffer.getPixel(x, y);
+}
+
+// --- Line & shape drawing ---
+
+// Like Adafruit GFX, the span covers x .. x + w - 1 in whichever direction that runs
+void FrameBufferDisplay::doDrawFastHLine(int x, int y, int w, int color)
+{
+  if (w > 0 && directAccess())
+    frame().fillSpan(x, x + w - 1, y, color);
+  else
+    doDrawLine(x, y, x + w - 1, y, color);
+}
+
+void FrameBufferDisplay::doDrawFastVLine(int x, int y, int h, int color)
+{
+  if (h > 0 && directAccess())
+    frame().fillColumn(x, y, y + h - 1, color);
+  else
+    doDrawLine(x, y, x, y + h - 1, color);
+}
+
+// Bresenham line, same stepping as Adafruit_GFX::writeLine
+void FrameBufferDisplay::doDrawLine(int x0, int y0, int x1, int y1, int color)
+{
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep)
+  {
+    swapInt(x0, y0);
+    swapInt(x1, y1);
+  }
+  if (x0 > x1)
+  {
+    swapInt(x0, x1);
+    swapInt(y0, y1);
+  }
+
+  int dx = x1 - x0;
+  int dy = abs(y1 - y0);
+  int err = dx / 2;
+  int ystep = (y0 < y1) ? 1 : -1;
+
+  for (; x0 <= x1; x0++)
+  {
+    if (steep)
+      doDrawPixel(y0, x0, color);
+    else
+      doDrawPixel(x0, y0, color);
+
+    err -= dy;
+    if (err < 0)
+    {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+void FrameBufferDisplay::doDrawRect(int x, int y, int w, int h, int color)
+{
+  doDrawFastHLine(x, y, w, color);
+  doDrawFastHLine(x, y + h - 1, w, color);
+  doDrawFastVLine(x, y, h, color);
+  doDrawFastVLine(x + w - 1, y, h, color);
+}
+
+void FrameBufferDisplay::doFillRect(int x, int y, int w, int h, int color)
+{
+  if (w > 0 && h > 0 && directAccess())
+  {
+    frame().fillRect(x, y, x + w - 1, y + h - 1, color);
+    return;
+  }
+
+  for (int i = x; i < x + w; i++)
+  {
+    doDrawFastVLine(i, y, h, color);
+  }
+}
+
+void FrameBufferDisplay::doDrawCircle(int x0, int y0, int r, int color)
+{
+  int f = 1 - r;
+  int ddF_x = 1;
+  int ddF_y = -2 * r;
+  int x = 0;
+  int y = r;
+
+  doDrawPixel(x0, y0 + r, color);
+  doDrawPixel(x0, y0 - r, color);
+  doDrawPixel(x0 + r, y0, color);
+  doDrawPixel(x0 - r, y0, color);
+
+  while (x < y)
+  {
+    if (f >= 0)
+    {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+
+    doDrawPixel(x0 + x, y0 + y, color);
+    doDrawPixel(x0 - x, y0 + y, color);
+    doDrawPixel(x0 + x, y0 - y, color);
+    doDrawPixel(x0 - x, y0 - y, color);
+    doDrawPixel(x0 + y, y0 + x, color);
+    doDrawPixel(x0 - y, y0 + x, color);
+    doDrawPixel(x0 + y, y0 - x, color);
+    doDrawPixel(x0 - y, y0 - x, color);
+  }
+}
+
+// Draws one or more quarter circle outlines (corner bits 1, 2, 4, 8)
+void FrameBufferDisplay::drawCircleHelper(int x0, int y0, int r, uint8_t cornername, int color)
+{
+  int f = 1 - r;
+  int ddF_x = 1;
+  int ddF_y = -2 * r;
+  int x = 0;
+  int y = r;
+
+  while (x < y)
+  {
+    if (f >= 0)
+    {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+
+    if (cornername & 0x4)
+    {
+      doDrawPixel(x0 + x, y0 + y, color);
+      doDrawPixel(x0 + y, y0 + x, color);
+    }
+    if (cornername & 0x2)
+    {
+      doDrawPixel(x0 + x, y0 - y, color);
+      doDrawPixel(x0 + y, y0 - x, color);
+    }
+    if (cornername & 0x8)
+    {
+      doDrawPixel(x0 - y, y0 + x, color);
+      doDrawPixel(x0 - x, y0 + y, color);
+    }
+    if (cornername & 0x1)
+    {
+      doDrawPixel(x0 - y, y0 - x, color);
+      doDrawPixel(x0 - x, y0 - y, color);
+    }
+  }
+}
+
+void FrameBufferDisplay::doFillCircle(int x0, int y0, int r, int color)
+{
+  doDrawFastVLine(x0, y0 - r, 2 * r + 1, color);
+  fillCircleHelper(x0, y0, r, 3, 0, color);
+}
+
+// Fills the right (corner bit 1) and/or left (bit 2) half of a circle,
+// stretched vertically by 'delta' pixels
+void FrameBufferDisplay::fillCircleHelper(int x0, int y0, int r, uint8_t corners, int delta, int color)
+{
+  int f = 1 - r;
+  int ddF_x = 1;
+  int ddF_y = -2 * r;
+  int x = 0;
+  int y = r;
+  int px = x;
+  int py = y;
+
+  delta++;
+
+  while (x < y)
+  {
+    if (f >= 0)
+    {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+
+    // Avoid drawing the same line twice, which matters for PIXEL_INVERSE
+    if (x < (y + 1))
+    {
+      if (corners & 1)
+        doDrawFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+      if (corners & 2)
+        doDrawFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+    }
+    if (y != py)
+    {
+      if (corners & 1)
+        doDrawFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+      if (corners & 2)
+        doDrawFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+      py = y;
+    }
+    px = x;
+  }
+}
+
+void FrameBufferDisplay::doDrawTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color)
+{
+  doDrawLine(x0, y0, x1, y1, color);
+  doDrawLine(x1, y1, x2, y2, color);
+  doDrawLine(x2, y2, x0, y0, color);
+}
+
+// Scanline fill, same edge stepping as Adafruit_GFX::fillTriangle
+void FrameBufferDisplay::doFillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color)
+{
+  int a, b, y, last;
+
+  // Sort coordinates by Y order (y2 >= y1 >= y0)
+  if (y0 > y1)
+  {
+    swapInt(y0, y1);
+    swapInt(x0, x1);
+  }
+  if (y1 > y2)
+  {
+    swapInt(y2, y1);
+    swapInt(x2, x1);
+  }
+  if (y0 > y1)
+  {
+    swapInt(y0, y1);
+    swapInt(x0, x1);
+  }
+
+  // All points on the same line
+  if (y0 == y2)
+  {
+    a = b = x0;
+    if (x1 < a)
+      a = x1;
+    else if (x1 > b)
+      b = x1;
+    if (x2 < a)
+      a = x2;
+    else if (x2 > b)
+      b = x2;
+    doDrawFastHLine(a, y0, b - a + 1, color);
+    return;
+  }
+
+  int dx01 = x1 - x0, dy01 = y1 - y0;
+  int dx02 = x2 - x0, dy02 = y2 - y0;
+  int dx12 = x2 - x1, dy12 = y2 - y1;
+  int32_t sa = 0, sb = 0;
+
+  // Upper part; includes the y1 scanline only if the lower part is flat
+  last = (y1 == y2) ? y1 : y1 - 1;
+
+  for (y = y0; y <= last; y++)
+  {
+    a = x0 + sa / dy01;
+    b = x0 + sb / dy02;
+    sa += dx01;
+    sb += dx02;
+    if (a > b)
+      swapInt(a, b);
+    doDrawFastHLine(a, y, b - a + 1, color);
+  }
+
+  // Lower part
+  sa = (int32_t)dx12 * (y - y1);
+  sb = (int32_t)dx02 * (y - y0);
+  for (; y <= y2; y++)
+  {
+    a = x1 + sa / dy12;
+    b = x0 + sb / dy02;
+    sa += dx12;
+    sb += dx02;
+    if (a > b)
+      swapInt(a, b);
+    doDrawFastHLine(a, y, b - a + 1, color);
+  }
+}
+
+void FrameBufferDisplay::doDrawRoundRect(int x, int y, int w, int h, int r, int color)
+{
+  int maxRadius = ((w < h) ? w : h) / 2;
+  if (r > maxRadius)
+    r = maxRadius;
+
+  doDrawFastHLine(x + r, y, w - 2 * r, color);         // Top
+  doDrawFastHLine(x + r, y + h - 1, w - 2 * r, color); // Bottom
+  doDrawFastVLine(x, y + r, h - 2 * r, color);         // Left
+  doDrawFastVLine(x + w - 1, y + r, h - 2 * r, color); // Right
+
+  drawCircleHelper(x + r, y + r, r, 1, color);
+  drawCircleHelper(x + w - r - 1, y + r, r, 2, color);
+  drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, color);
+  drawCircleHelper(x + r, y + h - r - 1, r, 8, color);
+}
+
+void FrameBufferDisplay::doFillRoundRect(int x, int y, int w, int h, int r, int color)
+{
+  int maxRadius = ((w < h) ? w : h) / 2;
+  if (r > maxRadius)
+    r = maxRadius;
+
+  doFillRect(x + r, y, w - 2 * r, h, color);
+  fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+  fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, color);
+}
+
+// --- Bulk drawing ---
+
+void FrameBufferDisplay::doDrawBitmap(int x, int y, const Bitmap &bitmap, int srcX, int srcY, int w, int h, RasterOp op)
+{
+  if (directAccess())
+    frame().blit(x, y, bitmap, srcX, srcY, w, h, op);
+  else
+    DisplayInterface::doDrawBitmap(x, y, bitmap, srcX, srcY, w, h, op);
+}
+
+void FrameBufferDisplay::doFillSpan(int x, int y, int w, int color)
+{
+  if (w > 0)
+    doDrawFastHLine(x, y, w, color);
+}
+
+// --- Text handling ---
+
+void FrameBufferDisplay::doSetCursor(int x, int y)
+{
+  cursorX = x;
+  cursorY = y;
+}
+
+void FrameBufferDisplay::setTextColor(int color)
+{
+  textColor = textBgColor = color;
+}
+
+void FrameBufferDisplay::setTextColor(int color, int background)
+{
+  textColor = color;
+  textBgColor = background;
+}
+
+void FrameBufferDisplay::setTextSize(int size)
+{
+  textSize = size > 0 ? size : 1;
+}
+
+void FrameBufferDisplay::setTextWrap(bool wrap)
+{
+  textWrap = wrap;
+}
+
+void FrameBufferDisplay::print(const char *text)
+{
+  // Size 1 text in the native orientation goes straight into the pages
+  if (textSize == 1 && directAccess())
+  {
+    TextRenderer(frame()).print(text, cursorX, cursorY, textColor, textBgColor, textWrap);
+    return;
+  }
+
+  while (*text)
+  {
+    writeGlyph(fontGlyphIndex(utf8Next(text)));
+  }
+}
+
+void FrameBufferDisplay::printGlyphs(const uint8_t *glyphs, size_t count)
+{
+  if (textSize == 1 && directAccess())
+  {
+    TextRenderer(frame()).printGlyphs(glyphs, count, cursorX, cursorY, textColor, textBgColor, textWrap);
+    return;
+  }
+
+  for (size_t i = 0; i < count; i++)
+  {
+    writeGlyph(glyphs[i]);
+  }
+}
+
+void FrameBufferDisplay::println(const char *text)
+{
+  print(text);
+  print("\r\n");
+}
+
+void FrameBufferDisplay::printf(const char *format, ...)
+{
+  char text[128];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+  print(text);
+}
+
+// Cursor handling of Adafruit_GFX::write for the built-in font
+void FrameBufferDisplay::writeGlyph(uint8_t glyph)
+{
+  if (glyph == '\n')
+  {
+    cursorX = 0;
+    cursorY += textSize * FONT_6X8_HEIGHT;
+  }
+  else if (glyph != '\r')
+  {
+    if (textWrap && (cursorX + textSize * FONT_6X8_WIDTH) > width())
+    {
+      cursorX = 0;
+      cursorY += textSize * FONT_6X8_HEIGHT;
+    }
+    drawGlyph(cursorX, cursorY, glyph, textColor, textBgColor, textSize);
+    cursorX += textSize * FONT_6X8_WIDTH;
+  }
+}
+
+void FrameBufferDisplay::drawGlyph(int x, int y, uint8_t glyph, int color, int bg, int size)
+{
+  if (x >= width() || y >= height() ||
+      x + FONT_6X8_WIDTH * size - 1 < 0 || y + FONT_6X8_HEIGHT * size - 1 < 0)
+    return;
+
+  const uint8_t *columns = fontGlyph(glyph);
+  for (int i = 0; i < FONT_6X8_COLUMNS; i++)
+  {
+    uint8_t line = columns[i];
+    for (int j = 0; j < FONT_6X8_HEIGHT; j++, line >>= 1)
+    {
+      if (line & 1)
+      {
+        if (size == 1)
+          doDrawPixel(x + i, y + j, color);
+        else
+          doFillRect(x + i * size, y + j * size, size, size, color);
+      }
+      else if (bg != color)
+      {
+        if (size == 1)
+          doDrawPixel(x + i, y + j, bg);
+        else
+          doFillRect(x + i * size, y + j * size, size, size, bg);
+      }
+    }
+  }
+
+  // Opaque text also paints the spacing column
+  if (bg != color)
+  {
+    if (size == 1)
+      doDrawFastVLine(x + 5, y, FONT_6X8_HEIGHT, bg);
+    else
+      doFillRect(x + 5 * size, y, size, FONT_6X8_HEIGHT * size, bg);
+  }
+}
+
+// --- Display buffer control ---
+
+void FrameBufferDisplay::display()
+{
+  PROFILE_SCOPE("FrameBufferDisplay::display");
+  if (canvas)
+    rotateFrame(canvasFrame(), buffer, rotation);
+  frameCount++;
+}
+
+void FrameBufferDisplay::clearDisplay()
+{
+  PROFILE_SCOPE("FrameBufferDisplay::clearDisplay");
+  buffer.fill(0);
+  if (canvas)
+    canvasFrame().fill(0);
+}
+
+// Rotations 1 and 3 draw into an unrotated portrait canvas when
+// transpose-on-flush is enabled; what is already in the frame stays where it is
+void FrameBufferDisplay::setRotation(int newRotation)
+{
+  releaseCanvas();
+  rotation = newRotation & 3;
+
+  if ((rotation & 1) && transposeOnFlush && buffer.width() % 8 == 0 && buffer.height() % 8 == 0)
+  {
+    canvas = new uint8_t[buffer.size()];
+    PageBuffer portrait = canvasFrame();
+    rotateFrame(buffer, portrait, 4 - rotation);
+  }
+}
+
+void FrameBufferDisplay::setTransposeOnFlush(bool enabled)
+{
+  transposeOnFlush = enabled;
+  setRotation(rotation);
+}
+
+PageBuffer FrameBufferDisplay::frame() const
+{
+  PageBuffer target = canvas ? canvasFrame() : buffer;
+  const Rect &clip = clipRect();
+  target.setClip(clip.x, clip.y, clip.right() - 1, clip.bottom() - 1);
+  return target;
+}
+
+PageBuffer FrameBufferDisplay::canvasFrame() const
+{
+  return PageBuffer(canvas, buffer.height(), buffer.width());
+}
+
+// Copies the canvas into the physical frame and releases it
+void FrameBufferDisplay::releaseCanvas()
+{
+  if (!canvas)
+    return;
+  rotateFrame(canvasFrame(), buffer, rotation);
+  delete[] canvas;
+  canvas = nullptr;
+}
+
+void FrameBufferDisplay::invertDisplay(bool invert)
+{
+  inverted = invert;
+}
+
+// --- Display dimensions ---
+
+int FrameBufferDisplay::width() const
+{
+  return (rotation & 1) ? buffer.height() : buffer.width();
+}
+
+int FrameBufferDisplay::height() const
+{
+  return (rotation & 1) ? buffer.width() : buffer.height();
+}
+
+// --- Frame access ---
+
+void FrameBufferDisplay::loadFrame(const uint8_t *frame)
+{
+  memcpy(buffer.data(), frame, buffer.size());
+  if (canvas)
+  {
+    PageBuffer portrait = canvasFrame();
+    rotateFrame(buffer, portrait, 4 - rotation);
+  }
+}
+
+long FrameBufferDisplay::compare(const FrameBufferDisplay &other) const
+{
+  if (other.buffer.width() != buffer.width() || other.buffer.height() != buffer.height())
+    return -1;
+
+  long differences = 0;
+  const uint8_t *a = buffer.data();
+  const uint8_t *b = other.buffer.data();
+  for (int i = 0; i < buffer.size(); i++)
+  {
+    uint8_t diff = a[i] ^ b[i];
+    while (diff)
+    {
+      differences += diff & 1;
+      diff >>= 1;
+    }
+  }
+  return differences;
+}
+
+// Lit pixel as seen on the panel, taking the invert command into account
+bool FrameBufferDisplay::physicalPixel(int x, int y) const
+{
+  return getPixel(x, y) != inverted;
+}
+
+// --- Image export ---
+
+// Binary PBM (P4). In PBM a set bit is black, so lit pixels are written as 0.
+bool FrameBufferDisplay::writePBM(FILE *file) const
+{
+  if (!file)
+    return false;
+
+  const int w = width();
+  const int h = height();
+  fprintf(file, "P4\n%d %d\n", w, h);
+
+  std::vector<uint8_t> row((w + 7) / 8);
+  for (int y = 0; y < h; y++)
+  {
+    for (size_t i = 0; i < row.size(); i++)
+      row[i] = 0;
+    for (int x = 0; x < w; x++)
+    {
+      if (!physicalPixel(x, y))
+        row[x / 8] |= 0x80 >> (x & 7);
+    }
+    if (fwrite(row.data(), 1, row.size(), file) != row.size())
+      return false;
+  }
+  return true;
+}
+
+// 1-bit grayscale PNG; the image data is stored in uncompressed deflate blocks
+bool FrameBufferDisplay::writePNG(FILE *file) const
+{
+  if (!file)
+    return false;
+
+  const int w = width();
+  const int h = height();
+  const int rowBytes = (w + 7) / 8;
+
+  // Raw scanlines: filter type 0 followed by the packed pixels, MSB first
+  std::vector<uint8_t> raw;
+  raw.reserve(h * (rowBytes + 1));
+  for (int y = 0; y < h; y++)
+  {
+    raw.push_back(0);
+    size_t rowStart = raw.size();
+    raw.resize(rowStart + rowBytes, 0);
+    for (int x = 0; x < w; x++)
+    {
+      if (physicalPixel(x, y))
+        raw[rowStart + x / 8] |= 0x80 >> (x & 7);
+    }
+  }
+
+  // zlib stream made of stored blocks
+  std::vector<uint8_t> zlib = {0x78, 0x01};
+  uint32_t adlerA = 1, adlerB = 0;
+  size_t offset = 0;
+  do
+  {
+    size_t blockSize = raw.size() - offset > 65535 ? 65535 : raw.size() - offset;
+    bool finalBlock = offset + blockSize == raw.size();
+    zlib.push_back(finalBlock ? 1 : 0);
+    zlib.push_back(blockSize & 0xFF);
+    zlib.push_back(blockSize >> 8);
+    zlib.push_back(~blockSize & 0xFF);
+    zlib.push_back((~blockSize >> 8) & 0xFF);
+    for (size_t i = 0; i < blockSize; i++)
+    {
+      uint8_t value = raw[offset + i];
+      zlib.push_back(value);
+      adlerA = (adlerA + value) % 65521;
+      adlerB = (adlerB + adlerA) % 65521;
+    }
+    offset += blockSize;
+  } while (offset < raw.size());
+  putBigEndian32(zlib, (adlerB << 16) | adlerA);
+
+  std::vector<uint8_t> header;
+  putBigEndian32(header, w);
+  putBigEndian32(header, h);
+  header.push_back(1); // Bit depth
+  header.push_back(0); // Grayscale
+  header.push_back(0); // Deflate
+  header.push_back(0); // Adaptive filtering
+  header.push_back(0); // No interlace
+
+  static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  std::vector<uint8_t> png(signature, signature + 8);
+  putChunk(png, "IHDR", header);
+  putChunk(png, "IDAT", zlib);
+  putChunk(png, "IEND", std::vector<uint8_t>());
+
+  return fwrite(png.data(), 1, png.size(), file) == png.size();
+}
+
+bool FrameBufferDisplay::savePBM(const char *path) const
+{
+  FILE *file = fopen(path, "wb");
+  if (!file)
+    return false;
+  bool ok = writePBM(file);
+  return (fclose(file) == 0) && ok;
+}
+
+bool FrameBufferDisplay::savePNG(const char *path) const
+{
+  FILE *file = fopen(path, "wb");
+  if (!file)
+    return false;
+  bool ok = writePNG(file);
+  return (fclose(file) == 0) && ok;
+}
@@ -0,0 +1,128 @@
+#ifndef FRAME_BUFFER_DISPLAY_H
+#define FRAME_BUFFER_DISPLAY_H
+
+#include "DisplayBase.h"
+#include "PageBuffer.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// DisplayInterface implementation that renders into a plain in-memory 1bpp
+// page-major buffer, without any hardware. All primitives follow the Adafruit
+// GFX algorithms (including the classic 6x8 font), so a frame drawn here
+// matches what DisplaySH1106G puts on the panel pixel for pixel.
+// Frames can be exported as PBM or PNG images for inspection and comparison.
+class FrameBufferDisplay final : public DisplayBase<FrameBufferDisplay>
+{
+  friend class DisplayBase<FrameBufferDisplay>;
+
+public:
+  FrameBufferDisplay(int width = 128, int height = 64);
+  ~FrameBufferDisplay();
+
+  FrameBufferDisplay(const FrameBufferDisplay &) = delete;
+  FrameBufferDisplay &operator=(const FrameBufferDisplay &) = delete;
+
+  // --- Text handling ---
+  void setTextColor(int color) override;
+  void setTextColor(int color, int background) override;
+  void setTextSize(int size) override;
+  void setTextWrap(bool wrap) override;
+  using DisplayInterface::print;
+  void print(const char *text) override;
+  using DisplayInterface::printGlyphs;
+  void printGlyphs(const uint8_t *glyphs, size_t count) override;
+  void println(const char *text) override;
+  void printf(const char *format, ...) override;
+
+  // --- Display buffer control ---
+  void display() override;      // Counts the frame; there is nothing to push
+  void clearDisplay() override;
+  void setRotation(int rotation) override;
+  void invertDisplay(bool invert) override;
+  void setContrast(uint8_t contrast) override { this->contrast = contrast; }
+  void setPowerSave(bool enabled) override { powerSave = enabled; }
+  uint8_t getContrast() const { return contrast; }
+  bool isPowerSaving() const { return powerSave; }
+
+  // In rotations 1 and 3 draw into an unrotated portrait canvas with the
+  // landscape fast paths and rotate it into the physical frame in display(),
+  // as DisplaySH1106G does (enabled by default). Until display() is called
+  // the exported frame does not show what was drawn since the last one.
+  void setTransposeOnFlush(bool enabled);
+  bool getTransposeOnFlush() const { return transposeOnFlush; }
+
+  // --- Display dimensions ---
+  int width() const override;
+  int height() const override;
+
+  // --- Frame access ---
+  bool getPixel(int x, int y) const;              // Logical (rotated) coordinates
+  const uint8_t *getBuffer() const { return buffer.data(); }
+  int getBufferSize() const { return buffer.size(); }
+  unsigned long getFrameCount() const { return frameCount; }
+
+  // Replaces the physical frame with 'frame' (getBufferSize() bytes), e.g. a
+  // frame recorded on the device, so that it can be compared or exported
+  void loadFrame(const uint8_t *frame);
+
+  // Number of physical pixels that differ from another frame of the same size,
+  // or -1 if the sizes differ
+  long compare(const FrameBufferDisplay &other) const;
+
+  // --- Image export (lit pixels are white, as on the panel) ---
+  bool writePBM(FILE *file) const;
+  bool writePNG(FILE *file) const;
+  bool savePBM(const char *path) const;
+  bool savePNG(const char *path) const;
+
+protected:
+  // --- Drawing hooks (see DisplayInterface) ---
+  void doDrawPixel(int x, int y, int color) override;
+  void doDrawFastHLine(int x, int y, int w, int color) override;
+  void doDrawFastVLine(int x, int y, int h, int color) override;
+  void doDrawLine(int x0, int y0, int x1, int y1, int color) override;
+  void doDrawRect(int x, int y, int w, int h, int color) override;
+  void doFillRect(int x, int y, int w, int h, int color) override;
+  void doDrawCircle(int x0, int y0, int r, int color) override;
+  void doFillCircle(int x0, int y0, int r, int color) override;
+  void doDrawTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) override;
+  void doFillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int color) override;
+  void doDrawRoundRect(int x, int y, int w, int h, int r, int color) override;
+  void doFillRoundRect(int x, int y, int w, int h, int r, int color) override;
+  void doDrawBitmap(int x, int y, const Bitmap &bitmap, int srcX, int srcY, int w, int h, RasterOp op) override;
+  void doFillSpan(int x, int y, int w, int color) override;
+  void doSetCursor(int x, int y) override;
+
+private:
+  PageBuffer buffer;       // Physical (unrotated) frame
+  int rotation = 0;
+  uint8_t *canvas = nullptr;    // Portrait frame while transposing on flush
+  bool transposeOnFlush = true;
+  bool inverted = false;   // Applied when exporting, like the panel's invert command
+  uint8_t contrast = 0x2F; // Recorded only, as is the power state
+  bool powerSave = false;
+
+  int cursorX = 0;
+  int cursorY = 0;
+  int textColor = 1;
+  int textBgColor = 1;     // Same as textColor means transparent background
+  int textSize = 1;
+  bool textWrap = true;
+
+  unsigned long frameCount = 0;
+
+  // Fast paths draw into frame() whenever it is in logical coordinates;
+  // it comes clipped to clipRect()
+  bool directAccess() const { return rotation == 0 || canvas; }
+  PageBuffer frame() const;
+  PageBuffer canvasFrame() const;
+  void releaseCanvas();
+
+  void writeGlyph(uint8_t glyph);
+  void drawGlyph(int x, int y, uint8_t glyph, int color, int bg, int size);
+  void drawCircleHelper(int x0, int y0, int r, uint8_t cornername, int color);
+  void fillCircleHelper(int x0, int y0, int r, uint8_t corners, int delta, int color);
+  bool physicalPixel(int x, int y) const;
+};
+
+#endif // FRAME_BUFFER_DISPLAY_H
@@ -0,0 +1,49 @@
+#ifndef GLYPH_STRING_H
+#define GLYPH_STRING_H
+
+#include "Font6x8.h"
+#include "Utf8.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Text decoded once from UTF-8 into glyph indices of the 6x8 font, one byte
+// per character (see fontGlyphIndex). Widgets keep their labels in this form
+// so widths, truncation and scrolling count characters instead of bytes and
+// nothing is decoded again when they are drawn.
+class GlyphString
+{
+public:
+  GlyphString() = default;
+  explicit GlyphString(const char *utf8) { assign(utf8); }
+
+  void assign(const char *utf8)
+  {
+    glyphs.clear();
+    if (utf8)
+    {
+      while (*utf8)
+        glyphs.push_back(fontGlyphIndex(utf8Next(utf8)));
+    }
+    glyphs.shrink_to_fit();
+  }
+
+  void clear()
+  {
+    glyphs.clear();
+    glyphs.shrink_to_fit();
+  }
+
+  size_t length() const { return glyphs.size(); }
+  bool isEmpty() const { return glyphs.empty(); }
+  const uint8_t *data() const { return glyphs.data(); }
+  uint8_t operator[](size_t index) const { return glyphs[index]; }
+
+  // Width in pixels at text size 1
+  int width() const { return static_cast<int>(glyphs.size()) * FONT_6X8_WIDTH; }
+
+private:
+  std::vector<uint8_t> glyphs;
+};
+
+#endif // GLYPH_STRING_H
@@ -0,0 +1,261 @@
+#ifndef PAGE_BUFFER_H
+#define PAGE_BUFFER_H
+
+#include <stdint.h>
+#include <string.h>
+#include "Bitmap.h"
+
+// Pixel colors understood by page buffers (same values as SH110X_BLACK/WHITE/INVERSE)
+enum PixelColor {
+  PIXEL_BLACK = 0,
+  PIXEL_WHITE = 1,
+  PIXEL_INVERSE = 2
+};
+
+// View over a 1bpp, page-major frame buffer as used by the SH1106:
+// byte (page * width + x) holds the 8 vertical pixels x,(page*8 .. page*8+7),
+// bit 0 being the top one. The buffer memory is owned by the caller.
+// Drawing is limited to a clip rectangle, the whole buffer by default.
+class PageBuffer
+{
+public:
+  PageBuffer(uint8_t *data, int width, int height)
+      : bytes(data), bufferWidth(width), bufferHeight(height),
+        clipX0(0), clipY0(0), clipX1(width - 1), clipY1(height - 1) {}
+
+  // Limits drawing to the rectangle with inclusive corners (x0, y0) and
+  // (x1, y1), kept inside the buffer
+  void setClip(int x0, int y0, int x1, int y1)
+  {
+    clipX0 = x0 > 0 ? x0 : 0;
+    clipY0 = y0 > 0 ? y0 : 0;
+    clipX1 = x1 < bufferWidth - 1 ? x1 : bufferWidth - 1;
+    clipY1 = y1 < bufferHeight - 1 ? y1 : bufferHeight - 1;
+  }
+
+  int clipLeft() const { return clipX0; }
+  int clipTop() const { return clipY0; }
+  int clipRight() const { return clipX1; }   // Inclusive
+  int clipBottom() const { return clipY1; }  // Inclusive
+
+  // Sets, clears or inverts one pixel; coordinates outside the clip are ignored
+  void setPixel(int x, int y, int color)
+  {
+    if (x < clipX0 || y < clipY0 || x > clipX1 || y > clipY1)
+      return;
+
+    uint8_t &cell = bytes[(y / 8) * bufferWidth + x];
+    uint8_t mask = 1 << (y & 7);
+    switch (color)
+    {
+    case PIXEL_WHITE:
+      cell |= mask;
+      break;
+    case PIXEL_BLACK:
+      cell &= ~mask;
+      break;
+    case PIXEL_INVERSE:
+      cell ^= mask;
+      break;
+    }
+  }
+
+  bool getPixel(int x, int y) const
+  {
+    if (x < 0 || y < 0 || x >= bufferWidth || y >= bufferHeight)
+      return false;
+    return bytes[(y / 8) * bufferWidth + x] & (1 << (y & 7));
+  }
+
+  // Fills columns x0..x1 (inclusive, x0 <= x1) of row y
+  void fillSpan(int x0, int x1, int y, int color)
+  {
+    if (y < clipY0 || y > clipY1)
+      return;
+    if (x0 < clipX0)
+      x0 = clipX0;
+    if (x1 > clipX1)
+      x1 = clipX1;
+    if (x0 > x1)
+      return;
+
+    uint8_t *cell = bytes + (y / 8) * bufferWidth + x0;
+    applyMask(cell, x1 - x0 + 1, 1 << (y & 7), color);
+  }
+
+  // Fills rows y0..y1 (inclusive, y0 <= y1) of column x
+  void fillColumn(int x, int y0, int y1, int color)
+  {
+    fillRect(x, y0, x, y1, color);
+  }
+
+  // Fills the rectangle with corners (x0, y0) and (x1, y1), both inclusive,
+  // one masked byte run per page
+  void fillRect(int x0, int y0, int x1, int y1, int color)
+  {
+    if (x0 < clipX0)
+      x0 = clipX0;
+    if (y0 < clipY0)
+      y0 = clipY0;
+    if (x1 > clipX1)
+      x1 = clipX1;
+    if (y1 > clipY1)
+      y1 = clipY1;
+    if (x0 > x1 || y0 > y1)
+      return;
+
+    for (int page = y0 / 8; page <= y1 / 8; page++)
+    {
+      int top = page * 8 > y0 ? 0 : y0 & 7;
+      int bottom = page * 8 + 7 < y1 ? 7 : y1 & 7;
+      uint8_t mask = static_cast<uint8_t>((0xFF << top) & (0xFF >> (7 - bottom)));
+      applyMask(bytes + page * bufferWidth + x0, x1 - x0 + 1, mask, color);
+    }
+  }
+
+  // Combines the source rectangle (srcX, srcY, w, h) of a bitmap with the
+  // buffer at (x, y). Works a destination page at a time: when the rows line up
+  // with page boundaries each column is a single byte operation, otherwise the
+  // byte is assembled from the two source pages it straddles.
+  void blit(int x, int y, const Bitmap &bitmap, int srcX, int srcY, int w, int h, RasterOp op)
+  {
+    // Clip the source rectangle to the bitmap
+    if (srcX < 0)
+    {
+      x -= srcX;
+      w += srcX;
+      srcX = 0;
+    }
+    if (srcY < 0)
+    {
+      y -= srcY;
+      h += srcY;
+      srcY = 0;
+    }
+    if (srcX + w > bitmap.width)
+      w = bitmap.width - srcX;
+    if (srcY + h > bitmap.height)
+      h = bitmap.height - srcY;
+
+    // Clip the destination rectangle
+    if (x < clipX0)
+    {
+      srcX += clipX0 - x;
+      w -= clipX0 - x;
+      x = clipX0;
+    }
+    if (y < clipY0)
+    {
+      srcY += clipY0 - y;
+      h -= clipY0 - y;
+      y = clipY0;
+    }
+    if (x + w > clipX1 + 1)
+      w = clipX1 + 1 - x;
+    if (y + h > clipY1 + 1)
+      h = clipY1 + 1 - y;
+    if (w <= 0 || h <= 0)
+      return;
+
+    const int srcPages = (bitmap.height + 7) / 8;
+    const int y1 = y + h - 1;
+
+    for (int page = y / 8; page <= y1 / 8; page++)
+    {
+      int top = page * 8 > y ? 0 : y & 7;
+      int bottom = page * 8 + 7 < y1 ? 7 : y1 & 7;
+      uint8_t mask = static_cast<uint8_t>((0xFF << top) & (0xFF >> (7 - bottom)));
+
+      // Source row that lands on bit 0 of this destination page
+      int srcRow = srcY + page * 8 - y;
+      int srcPage = srcRow >= 0 ? srcRow / 8 : -1;
+      int shift = srcRow >= 0 ? srcRow & 7 : 0;
+
+      uint8_t *dst = bytes + page * bufferWidth + x;
+      const uint8_t *src = bitmap.data + srcX;
+
+      for (int i = 0; i < w; i++)
+      {
+        uint8_t value;
+        if (srcRow < 0)
+        {
+          value = static_cast<uint8_t>(src[i] << -srcRow);
+        }
+        else if (shift == 0)
+        {
+          value = src[srcPage * bitmap.width + i];
+        }
+        else
+        {
+          value = src[srcPage * bitmap.width + i] >> shift;
+          if (srcPage + 1 < srcPages)
+            value |= static_cast<uint8_t>(src[(srcPage + 1) * bitmap.width + i] << (8 - shift));
+        }
+        dst[i] = combine(dst[i], value, mask, op);
+      }
+    }
+  }
+
+  // Sets every byte of the buffer to 'value' (0 clears the frame)
+  void fill(uint8_t value)
+  {
+    memset(bytes, value, size());
+  }
+
+  uint8_t *data() { return bytes; }
+  const uint8_t *data() const { return bytes; }
+  int width() const { return bufferWidth; }
+  int height() const { return bufferHeight; }
+  int pages() const { return (bufferHeight + 7) / 8; }
+  int size() const { return bufferWidth * pages(); }
+
+  // Applies a raster operation to the bits of 'dst' selected by 'mask'
+  static uint8_t combine(uint8_t dst, uint8_t src, uint8_t mask, RasterOp op)
+  {
+    switch (op)
+    {
+    case RasterOp::COPY:
+      return (dst & ~mask) | (src & mask);
+    case RasterOp::OR:
+      return dst | (src & mask);
+    case RasterOp::AND:
+      return dst & (src | ~mask);
+    case RasterOp::XOR:
+      return dst ^ (src & mask);
+    case RasterOp::COPY_INVERTED:
+      return (dst & ~mask) | (~src & mask);
+    case RasterOp::AND_INVERTED:
+      return dst & ~(src & mask);
+    }
+    return dst;
+  }
+
+private:
+  uint8_t *bytes;
+  int bufferWidth;
+  int bufferHeight;
+  int clipX0, clipY0, clipX1, clipY1; // Inclusive, inside the buffer
+
+  // Sets, clears or inverts the 'mask' bits of 'count' consecutive bytes
+  static void applyMask(uint8_t *cell, int count, uint8_t mask, int color)
+  {
+    switch (color)
+    {
+    case PIXEL_WHITE:
+      while (count--)
+        *cell++ |= mask;
+      break;
+    case PIXEL_BLACK:
+      mask = ~mask;
+      while (count--)
+        *cell++ &= mask;
+      break;
+    case PIXEL_INVERSE:
+      while (count--)
+        *cell++ ^= mask;
+      break;
+    }
+  }
+};
+
+#endif // PAGE_BUFFER_H
@@ -0,0 +1,95 @@
+#ifndef PAGE_ROTATION_H
+#define PAGE_ROTATION_H
+
+#include "DirtyRegion.h"
+#include "PageBuffer.h"
+#include <stdint.h>
+
+// Quarter-turn rotation between page-major frames, used to render portrait
+// layouts into an unrotated canvas and turn it into the panel layout on flush.
+// An 8x8 block of pixels is 8 column bytes in both frames, so each block is
+// rotated with one bit-matrix transpose instead of 64 pixel moves.
+
+// Transposes an 8x8 bit matrix: bit j of in[i] becomes bit i of out[j]
+inline void transpose8x8(const uint8_t *in, uint8_t *out)
+{
+  uint64_t x = 0;
+  for (int i = 0; i < 8; i++)
+    x |= static_cast<uint64_t>(in[i]) << (8 * i);
+
+  // Swap 1x1, 2x2 and 4x4 sub-blocks across the diagonal (Hacker's Delight 7-3)
+  uint64_t t;
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  x ^= t ^ (t << 28);
+
+  for (int j = 0; j < 8; j++)
+    out[j] = static_cast<uint8_t>(x >> (8 * j));
+}
+
+inline uint8_t reverseBits(uint8_t b)
+{
+  b = static_cast<uint8_t>((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+  b = static_cast<uint8_t>((b & 0xCC) >> 2 | (b & 0x33) << 2);
+  b = static_cast<uint8_t>((b & 0xAA) >> 1 | (b & 0x55) << 1);
+  return b;
+}
+
+// Rebuilds the 8x8 block of 'dst' at page 'page', columns x..x+7, from 'src'
+// turned by 'turns' quarter turns (1 or 3) with the Adafruit GFX rotation
+// mapping: with turns = 1 the pixel (sx, sy) of src lands on
+// (dst.width() - 1 - sy, sx), with turns = 3 on (sy, dst.height() - 1 - sx).
+// Both frames must have dimensions that are multiples of 8, and dst must be
+// src with width and height swapped.
+inline void rotateBlock(const PageBuffer &src, PageBuffer &dst, int turns, int page, int x)
+{
+  uint8_t block[8];
+  uint8_t *out = dst.data() + page * dst.width() + x;
+
+  if (turns == 1)
+  {
+    // Source rows become destination columns, right to left
+    const int srcPage = (dst.width() - 8 - x) / 8;
+    transpose8x8(src.data() + srcPage * src.width() + page * 8, block);
+    for (int j = 0; j < 8; j++)
+      out[j] = block[7 - j];
+  }
+  else
+  {
+    // Source columns become destination rows, bottom to top
+    const int srcX = dst.height() - 8 - page * 8;
+    transpose8x8(src.data() + (x / 8) * src.width() + srcX, block);
+    for (int j = 0; j < 8; j++)
+      out[j] = reverseBits(block[j]);
+  }
+}
+
+// Rebuilds all of 'dst' from 'src' (see rotateBlock)
+inline void rotateFrame(const PageBuffer &src, PageBuffer &dst, int turns)
+{
+  for (int page = 0; page < dst.pages(); page++)
+  {
+    for (int x = 0; x < dst.width(); x += 8)
+      rotateBlock(src, dst, turns, page, x);
+  }
+}
+
+// Rebuilds the damaged parts of 'dst' from 'src', a whole block at a time;
+// 'damage' is in dst coordinates
+inline void rotateFrame(const PageBuffer &src, PageBuffer &dst, int turns, const DirtyRegion &damage)
+{
+  for (int page = 0; page < dst.pages(); page++)
+  {
+    if (!damage.isPageDirty(page))
+      continue;
+
+    const int end = damage.pageEnd(page);
+    for (int x = damage.pageStart(page) & ~7; x <= end; x += 8)
+      rotateBlock(src, dst, turns, page, x);
+  }
+}
+
+#endif // PAGE_ROTATION_H
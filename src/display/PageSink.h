@@ -0,0 +1,67 @@
+#ifndef PAGE_SINK_H
+#define PAGE_SINK_H
+
+#include "DirtyRegion.h"
+#include <stdint.h>
+#include <string.h>
+
+// Destination for page spans of a page-major frame buffer, e.g. a panel on a bus
+class PageSink
+{
+public:
+  virtual ~PageSink() = default;
+
+  virtual void beginTransfer() {} // Before a batch of writeSpan calls
+  virtual void endTransfer() {}   // After a batch of writeSpan calls
+
+  // Sends columns [x0, x1] of one page taken from 'frame'
+  virtual void writeSpan(uint8_t page, uint8_t x0, uint8_t x1, const uint8_t *frame) = 0;
+};
+
+// Sends the damaged parts of 'frame' to 'sink' and updates 'shown', the copy of
+// what the sink currently holds. With 'compare' set each damaged span is first
+// shrunk to the bytes that differ from 'shown', and unchanged spans are skipped.
+// Returns the number of bytes sent.
+inline int flushPageSpans(PageSink &sink, const uint8_t *frame, uint8_t *shown,
+                          const DirtyRegion &damage, bool compare = true)
+{
+  const int width = damage.getWidth();
+  bool transferStarted = false;
+  int bytesSent = 0;
+
+  for (uint8_t page = 0; page < damage.getPageCount(); page++)
+  {
+    if (!damage.isPageDirty(page))
+      continue;
+
+    const uint8_t *current = frame + page * width;
+    uint8_t *previous = shown + page * width;
+    int start = damage.pageStart(page);
+    int end = damage.pageEnd(page);
+
+    if (compare)
+    {
+      while (start <= end && current[start] == previous[start])
+        start++;
+      while (end >= start && current[end] == previous[end])
+        end--;
+      if (start > end)
+        continue;
+    }
+
+    if (!transferStarted)
+    {
+      sink.beginTransfer();
+      transferStarted = true;
+    }
+    sink.writeSpan(page, start, end, frame);
+    memcpy(previous + start, current + start, end - start + 1);
+    bytesSent += end - start + 1;
+  }
+
+  if (transferStarted)
+    sink.endTransfer();
+  return bytesSent;
+}
+
+#endif // PAGE_SINK_H
@@ -0,0 +1,69 @@
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include "Bitmap.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Storage for a W x H sprite, bit-packed in the SH1106 page layout (see Bitmap.h).
+// Instances are built at compile time with makeSprite() and declared constexpr,
+// so the bytes end up in flash (.rodata) rather than RAM.
+template <uint8_t W, uint8_t H>
+struct SpriteData
+{
+  static constexpr uint8_t WIDTH = W;
+  static constexpr uint8_t HEIGHT = H;
+  static constexpr size_t SIZE = static_cast<size_t>(W) * ((H + 7) / 8);
+
+  uint8_t bytes[SIZE];
+
+  constexpr Bitmap bitmap() const { return Bitmap{bytes, W, H}; }
+};
+
+// Converts ASCII art to a packed sprite. The art is one string of W * H
+// characters, row after row; '#' (or any character other than ' ' and '.')
+// is a lit pixel. Writing each row as its own literal keeps it readable:
+//
+//   constexpr auto ARROW = makeSprite<3, 3>(
+//       " # "
+//       "###"
+//       " # ");
+template <uint8_t W, uint8_t H, size_t N>
+constexpr SpriteData<W, H> makeSprite(const char (&art)[N])
+{
+  static_assert(N == static_cast<size_t>(W) * H + 1, "sprite art must contain exactly W * H characters");
+
+  SpriteData<W, H> sprite{};
+  for (uint8_t y = 0; y < H; y++)
+  {
+    for (uint8_t x = 0; x < W; x++)
+    {
+      char c = art[y * W + x];
+      if (c != ' ' && c != '.')
+        sprite.bytes[(y / 8) * W + x] |= static_cast<uint8_t>(1 << (y & 7));
+    }
+  }
+  return sprite;
+}
+
+// Named sprite in an atlas. Atlases are plain constexpr arrays of entries,
+// usually indexed by an enum, with the names kept for lookups from tools and logs.
+struct SpriteEntry
+{
+  const char *name;
+  Bitmap bitmap;
+};
+
+// Finds an atlas entry by name; returns nullptr if there is none
+inline const SpriteEntry *findSprite(const SpriteEntry *atlas, size_t count, const char *name)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    if (strcmp(atlas[i].name, name) == 0)
+      return &atlas[i];
+  }
+  return nullptr;
+}
+
+#endif // SPRITE_H
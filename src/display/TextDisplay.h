@@ -2,10 +2,15 @@
 #define TEXT_DISPLAY_H
 #include <Arduino.h>
 #include "DisplayInterface.h"
+#include "GlyphString.h"
 #include "../button/ButtonManager.h"
+#include "../ui/Widget.h"
+#include "../ui/DamageList.h"
+#include "../platform/Profiler.h"
 #include <algorithm>
+#include <vector>
 
-class TextDisplay
+class TextDisplay : public Widget
 {
 private:
     DisplayInterface &display;
@@ -22,7 +27,7 @@ private:
 
     struct TextLine
     {
-        String text;
+        GlyphString text; // Decoded once in addLine
     };
 
     TextLine *lines;
@@ -31,6 +36,25 @@ private:
     uint16_t selectedIndex;
     uint16_t firstVisibleIndex;
     uint16_t horizontalScroll;
+    uint32_t textVersion = 0; // Bumped when existing lines change (shift, clear)
+
+    // Retained mode: what a screen row showed when it was last drawn
+    struct RowState
+    {
+        int32_t line = -1; // Line shown, -1 for an empty row
+        bool selected = false;
+        uint16_t scroll = 0;
+        uint32_t textVersion = 0;
+
+        bool operator!=(const RowState &other) const
+        {
+            return line != other.line || selected != other.selected ||
+                   scroll != other.scroll || textVersion != other.textVersion;
+        }
+    };
+
+    std::vector<RowState> drawnRows;
+    Rect drawnMarker;
 
 public:
     TextDisplay(DisplayInterface &disp, uint16_t maxLines = 300)
@@ -57,13 +81,15 @@ public:
         charsPerLine = (display.width() - SCROLL_BAR_WIDTH) / charWidth;
         lineSpacing = static_cast<uint16_t>(charHeight * 1.2);
         visibleLines = display.height() / lineSpacing;
+        drawnRows.assign(visibleLines, RowState());
+        invalidateLayout();
     }
 
     void addLine(const String &text)
     {
         if (currentLines < maxLines)
         {
-            lines[currentLines++].text = text;
+            lines[currentLines++].text.assign(text.c_str());
         }
         else
         {
@@ -72,7 +98,8 @@ public:
             {
                 lines[i - 1] = lines[i];
             }
-            lines[maxLines - 1].text = text;
+            lines[maxLines - 1].text.assign(text.c_str());
+            textVersion++;
         }
 
         // Mută selecția la ultima linie
@@ -83,18 +110,21 @@ public:
         {
             firstVisibleIndex = currentLines - visibleLines;
         }
+        invalidate();
     }
 
     void clear()
     {
         for (uint16_t i = 0; i < currentLines; ++i)
         {
-            lines[i].text = "";
+            lines[i].text.clear();
         }
         currentLines = 0;
         selectedIndex = 0;
         firstVisibleIndex = 0;
         horizontalScroll = 0;
+        textVersion++;
+        invalidate();
     }
 
     void scrollUp()
@@ -106,6 +136,7 @@ public:
             {
                 firstVisibleIndex = selectedIndex;
             }
+            invalidate();
         }
     }
 
@@ -118,17 +149,26 @@ public:
             {
                 firstVisibleIndex = selectedIndex - visibleLines + 1;
             }
+            invalidate();
         }
     }
 
     void scrollLeft(uint16_t step = 1)
     {
         uint16_t maxScroll = getMaxHorizontalScroll();
-        horizontalScroll = std::min<uint16_t>(horizontalScroll + step, maxScroll);
+        uint16_t scroll = std::min<uint16_t>(horizontalScroll + step, maxScroll);
+        if (scroll != horizontalScroll)
+        {
+            horizontalScroll = scroll;
+            invalidate();
+        }
     }
 
     void scrollRight(uint16_t step = 1)
     {
+        if (horizontalScroll == 0)
+            return;
+
         if (horizontalScroll >= step)
         {
             horizontalScroll -= step;
@@ -137,54 +177,144 @@ public:
         {
             horizontalScroll = 0;
         }
+        invalidate();
     }
 
-    void draw()
+    // In retained mode only rows whose line, selection or scroll changed are
+    // repainted, plus the scroll marker when it moved
+    void draw() { draw(display); }
+
+    // Same, calling the primitives on the concrete display type (see
+    // DisplayInterface.h); 'target' must be the display given to the constructor
+    template <typename Display>
+    void draw(Display &target)
     {
-        display.setTextWrap(false);
-        display.setTextSize(1);
-        display.setTextColor(1);
+        PROFILE_SCOPE("TextDisplay::draw");
+        target.setTextWrap(false);
+        target.setTextSize(1);
+        target.setTextColor(1);
+
+        const Rect bounds(0, 0, target.width(), target.height());
+        const Rect marker = getScrollMarker();
+        const bool full = needsFullRepaint(bounds);
+        DamageList damage;
+
+        if (full)
+        {
+            damage.add(getDrawnBounds());
+            damage.add(bounds);
+        }
+        else
+        {
+            for (uint16_t i = 0; i < visibleLines; i++)
+            {
+                if (getRowState(i) != drawnRows[i])
+                    damage.add(getRowRect(i));
+            }
+            if (marker != drawnMarker)
+            {
+                damage.add(drawnMarker);
+                damage.add(marker);
+            }
+        }
+
+        if (isRetained())
+            damage.erase(target);
 
         uint16_t maxVisible = std::min(visibleLines, static_cast<uint16_t>(currentLines - firstVisibleIndex));
 
         for (uint16_t i = 0; i < maxVisible; i++)
         {
+            if (!full && !damage.intersects(getRowRect(i)))
+                continue;
+
             uint16_t lineIdx = firstVisibleIndex + i;
-            String displayText = getDisplayText(lines[lineIdx].text);
 
-            display.setCursor(0, i * lineSpacing);
-            display.print((lineIdx == selectedIndex) ? ">" : " ");
-            display.print(displayText.c_str());
+            target.setCursor(0, i * lineSpacing);
+            target.print((lineIdx == selectedIndex) ? ">" : " ");
+            printVisibleText(target, lines[lineIdx].text);
         }
 
-        drawScrollIndicator();
+        if (!damage.isEmpty())
+            drawScrollIndicator(target);
+
+        for (uint16_t i = 0; i < visibleLines; i++)
+            drawnRows[i] = getRowState(i);
+        drawnMarker = marker;
+        setDrawnBounds(bounds);
+    }
+
+    // Gestures handleInput() uses, for ButtonManager::setGestures()
+    uint8_t gestures(uint8_t buttonId) const
+    {
+        if (buttonId == BUTTON_UP || buttonId == BUTTON_DOWN)
+            return GESTURE_CLICK | GESTURE_REPEAT;
+        if (buttonId == BUTTON_LEFT || buttonId == BUTTON_RIGHT)
+            return GESTURE_CLICK | GESTURE_REPEAT | GESTURE_DOUBLE_CLICK;
+        return 0;
     }
 
     void handleInput(ButtonEvent buttonEvent)
     {
-        if (buttonEvent.buttonName == "UP" && buttonEvent.action == ButtonAction::SHORT_CLICK)
+        if (buttonEvent.buttonId == BUTTON_UP && buttonEvent.isStep())
             scrollUp();
-        else if (buttonEvent.buttonName == "DOWN" && buttonEvent.action == ButtonAction::SHORT_CLICK)
+        else if (buttonEvent.buttonId == BUTTON_DOWN && buttonEvent.isStep())
             scrollDown();
-        else if (buttonEvent.buttonName == "RIGHT" && buttonEvent.action == ButtonAction::SHORT_CLICK)
+        else if (buttonEvent.buttonId == BUTTON_RIGHT && buttonEvent.isStep())
             scrollRight();
-        else if (buttonEvent.buttonName == "LEFT" && buttonEvent.action == ButtonAction::SHORT_CLICK)
+        else if (buttonEvent.buttonId == BUTTON_LEFT && buttonEvent.isStep())
             scrollLeft();
-        else if (buttonEvent.buttonName == "RIGHT" && buttonEvent.action == ButtonAction::DOUBLE_CLICK)
+        else if (buttonEvent.buttonId == BUTTON_RIGHT && buttonEvent.action == ButtonAction::DOUBLE_CLICK)
             scrollRight(5);
-        else if (buttonEvent.buttonName == "LEFT" && buttonEvent.action == ButtonAction::DOUBLE_CLICK)
+        else if (buttonEvent.buttonId == BUTTON_LEFT && buttonEvent.action == ButtonAction::DOUBLE_CLICK)
             scrollLeft(5);
     }
 
 private:
-    String getDisplayText(const String &text)
+    RowState getRowState(uint16_t row) const
     {
-        String paddedText = text;
-        while (paddedText.length() < horizontalScroll + charsPerLine)
+        RowState state;
+        uint32_t line = firstVisibleIndex + row;
+        if (line < currentLines)
         {
-            paddedText += " ";
+            state.line = line;
+            state.selected = line == selectedIndex;
+            state.scroll = horizontalScroll;
+            state.textVersion = textVersion;
         }
-        return paddedText.substring(horizontalScroll, horizontalScroll + charsPerLine);
+        return state;
+    }
+
+    Rect getRowRect(uint16_t row) const
+    {
+        return Rect(0, row * lineSpacing, display.width(), lineSpacing);
+    }
+
+    // 3x3 marker on the scroll bar, kept inside the bar; empty if everything fits
+    Rect getScrollMarker() const
+    {
+        if (currentLines <= visibleLines)
+            return Rect();
+
+        const int barX = display.width() - 2;
+        const int barHeight = display.height();
+        float percent = selectedIndex / static_cast<float>(currentLines - 1);
+        int centerY = static_cast<int>(percent * (barHeight - 1));
+
+        int top = std::max(centerY - 1, 0);
+        int bottom = std::min(centerY + 1, barHeight - 1);
+        return Rect(barX - 1, top, 3, bottom - top + 1);
+    }
+
+    // Prints the characters of a line that fall inside the horizontal window
+    template <typename Display>
+    void printVisibleText(Display &target, const GlyphString &text)
+    {
+        if (text.length() <= horizontalScroll)
+            return;
+
+        size_t count = std::min<size_t>(text.length() - horizontalScroll, charsPerLine);
+        target.printGlyphs(text.data() + horizontalScroll, count);
     }
 
     uint16_t getMaxHorizontalScroll()
@@ -194,7 +324,7 @@ private:
 
         for (uint16_t i = firstVisibleIndex; i < endLine; ++i)
         {
-            const String &text = lines[i].text;
+            const GlyphString &text = lines[i].text;
             uint16_t totalLength = std::max<uint16_t>(charsPerLine, static_cast<uint16_t>(text.length()));
             uint16_t possible = totalLength > charsPerLine ? totalLength - charsPerLine : 0;
             if (possible > maxScroll)
@@ -206,35 +336,25 @@ private:
         return maxScroll;
     }
 
-    void drawScrollIndicator() const
+    template <typename Display>
+    void drawScrollIndicator(Display &target) const
     {
-        const int barX = display.width() - 2;
-        const int barHeight = display.height();
-        const int totalItems = currentLines;
+        // One column of alternating pixels, 64 rows tall
+        static const uint8_t DOTTED_TRACK[8] = {0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55};
+        static const Bitmap track = {DOTTED_TRACK, 1, 64};
 
-        for (int y = 0; y < barHeight; ++y)
+        const int barX = target.width() - 2;
+        const int barHeight = target.height();
+
+        for (int y = 0; y < barHeight; y += track.height)
         {
-            if (y % 2 == 0)
-            {
-                display.drawPixel(barX, y, 1);
-            }
+            target.drawBitmap(barX, y, track, 0, 0, 1, std::min<int>(track.height, barHeight - y), RasterOp::OR);
         }
 
-        if (totalItems > visibleLines)
+        Rect marker = getScrollMarker();
+        if (!marker.isEmpty())
         {
-            float percent = selectedIndex / static_cast<float>(totalItems - 1);
-            int centerY = static_cast<int>(percent * (barHeight - 1));
-
-            for (int dy = -1; dy <= 1; ++dy)
-            {
-                int y = centerY + dy;
-                if (y >= 0 && y < barHeight)
-                {
-                    display.drawPixel(barX - 1, y, 1);
-                    display.drawPixel(barX, y, 1);
-                    display.drawPixel(barX + 1, y, 1);
-                }
-            }
+            target.fillRect(marker.x, marker.y, marker.w, marker.h, 1);
         }
     }
 
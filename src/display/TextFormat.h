@@ -0,0 +1,344 @@
+#ifndef TEXT_FORMAT_H
+#define TEXT_FORMAT_H
+
+#include "Font6x8.h"
+#include "Utf8.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+// Allocation-free number and text formatting for the frame loop. Values are
+// rendered digit by digit straight into glyph indices of the 6x8 font (see
+// GlyphString.h), so drawing a number needs neither vsnprintf nor a
+// char buffer. DisplayInterface::print has overloads for everything here.
+
+// Integer right-aligned in at least 'width' characters. With '0' as fill the
+// sign comes before the zeros, as with printf("%05d").
+struct IntField
+{
+  long value;
+  uint8_t width;
+  char fill;
+};
+
+constexpr IntField padded(long value, uint8_t width, char fill = ' ') { return IntField{value, width, fill}; }
+constexpr IntField zeroPadded(long value, uint8_t width) { return IntField{value, width, '0'}; }
+
+// Fixed-point number value / 10^decimals, right-aligned in at least 'width'
+// characters: fixedPoint(-305, 2) prints "-3.05"
+struct FixedPoint
+{
+  long value;
+  uint8_t decimals;
+  uint8_t width;
+};
+
+constexpr FixedPoint fixedPoint(long value, uint8_t decimals, uint8_t width = 0)
+{
+  return FixedPoint{value, decimals, width};
+}
+
+// Characters a single field can take: the digits of any long with sign and
+// decimal point. Wider field widths are clamped to it.
+static constexpr uint8_t TEXT_FIELD_CAPACITY = 24;
+
+// Short text of at most CAPACITY characters, built on the stack from glyphs,
+// strings and numbers. Characters past the capacity are dropped; size the
+// buffer for the longest text it has to hold.
+template <size_t CAPACITY>
+class TextBuffer
+{
+public:
+  static_assert(CAPACITY > 0 && CAPACITY <= 255, "TextBuffer holds 1 to 255 characters");
+
+  void clear() { count = 0; }
+
+  void append(uint8_t glyph)
+  {
+    if (count < CAPACITY)
+      glyphs[count++] = glyph;
+  }
+
+  void append(char c) { append(fontGlyphIndex(static_cast<uint8_t>(c))); }
+
+  // UTF-8 text
+  void append(const char *text)
+  {
+    while (*text)
+      append(fontGlyphIndex(utf8Next(text)));
+  }
+
+  void append(long value) { append(IntField{value, 0, ' '}); }
+  void append(int value) { append(static_cast<long>(value)); }
+
+  void append(const IntField &field)
+  {
+    uint8_t digits[TEXT_FIELD_CAPACITY];
+    int length = toDigits(field.value, digits, 1);
+    int width = field.width < TEXT_FIELD_CAPACITY ? field.width : TEXT_FIELD_CAPACITY;
+    int padding = width - length - (field.value < 0);
+
+    if (field.fill == '0')
+    {
+      appendSign(field.value);
+      appendRepeated('0', padding);
+    }
+    else
+    {
+      appendRepeated(field.fill, padding);
+      appendSign(field.value);
+    }
+    appendReversed(digits, length);
+  }
+
+  void append(const FixedPoint &number)
+  {
+    uint8_t digits[TEXT_FIELD_CAPACITY];
+    int decimals = number.decimals < TEXT_FIELD_CAPACITY - 2 ? number.decimals : TEXT_FIELD_CAPACITY - 2;
+    int length = toDigits(number.value, digits, decimals + 1); // At least one digit before the point
+    int width = number.width < TEXT_FIELD_CAPACITY ? number.width : TEXT_FIELD_CAPACITY;
+
+    appendRepeated(' ', width - length - (decimals > 0) - (number.value < 0));
+    appendSign(number.value);
+    appendReversed(digits + decimals, length - decimals);
+    if (decimals > 0)
+    {
+      append('.');
+      appendReversed(digits, decimals);
+    }
+  }
+
+  size_t length() const { return count; }
+  bool isEmpty() const { return count == 0; }
+  const uint8_t *data() const { return glyphs; }
+
+  // Width in pixels at text size 1
+  int width() const { return count * FONT_6X8_WIDTH; }
+
+private:
+  uint8_t glyphs[CAPACITY];
+  uint8_t count = 0;
+
+  // Writes the digits of |value| into 'digits', least significant first, and
+  // returns how many were written (at least 'minDigits', with leading zeros)
+  static int toDigits(long value, uint8_t *digits, int minDigits)
+  {
+    // Through unsigned long so that the most negative value works too
+    unsigned long magnitude = value < 0 ? 0UL - static_cast<unsigned long>(value) : static_cast<unsigned long>(value);
+    int length = 0;
+    do
+    {
+      digits[length++] = static_cast<uint8_t>('0' + magnitude % 10);
+      magnitude /= 10;
+    } while (magnitude > 0 && length < TEXT_FIELD_CAPACITY);
+
+    while (length < minDigits && length < TEXT_FIELD_CAPACITY)
+      digits[length++] = '0';
+    return length;
+  }
+
+  void appendSign(long value)
+  {
+    if (value < 0)
+      append('-');
+  }
+
+  void appendRepeated(char c, int times)
+  {
+    for (int i = 0; i < times; i++)
+      append(c);
+  }
+
+  void appendReversed(const uint8_t *digits, int length)
+  {
+    for (int i = length - 1; i >= 0; i--)
+      append(digits[i]);
+  }
+};
+
+// Called by makeFormat() for a bad format. It is not constexpr, so in a
+// constexpr declaration the call stops the build with 'message' in the error.
+inline void textFormatError(const char *message) { (void)message; }
+
+// printf-like format parsed and checked at compile time by makeFormat().
+// Supported conversions:
+//   %d, %Nd, %0Nd  integer, right-aligned in at least N characters
+//   %Ns            string, clipped or space-padded to exactly N characters
+//   %%             a percent sign
+// Literal text must be printable ASCII. The argument types are part of the
+// format type, so print() checks them and their number when it is compiled.
+template <typename... Args>
+struct TextFormat
+{
+  static constexpr uint8_t MAX_SEGMENTS = 8;
+  static constexpr uint8_t CAPACITY = 64; // Longest output, checked by makeFormat()
+
+  struct Segment
+  {
+    char kind = 0;        // 'l' literal, 'd' integer, 's' string
+    uint8_t start = 0;    // Literal: first character in 'literals'
+    uint8_t length = 0;   // Literal: number of characters
+    uint8_t width = 0;    // Field width
+    char fill = ' ';      // Padding of integers
+  };
+
+  Segment segments[MAX_SEGMENTS] = {};
+  uint8_t segmentCount = 0;
+  char literals[CAPACITY] = {};
+  uint8_t width = 0;     // Output width in characters when every integer fits its field
+  uint8_t maxLength = 0; // Longest possible output in characters
+
+  // Width in pixels at text size 1, for layouts sized at compile time
+  constexpr int pixelWidth() const { return width * FONT_6X8_WIDTH; }
+
+  template <size_t N>
+  void render(TextBuffer<N> &out, typename std::common_type<Args>::type... values) const
+  {
+    static_assert(N >= CAPACITY, "buffer too small for a TextFormat");
+    renderFrom(out, 0, values...);
+  }
+
+private:
+  template <size_t N>
+  void renderFrom(TextBuffer<N> &out, uint8_t index) const
+  {
+    for (; index < segmentCount; index++)
+      appendLiteral(out, segments[index]);
+  }
+
+  template <size_t N, typename T, typename... Rest>
+  void renderFrom(TextBuffer<N> &out, uint8_t index, T value, Rest... rest) const
+  {
+    while (segments[index].kind == 'l')
+      appendLiteral(out, segments[index++]);
+    appendField(out, segments[index], value);
+    renderFrom(out, index + 1, rest...);
+  }
+
+  template <size_t N>
+  void appendLiteral(TextBuffer<N> &out, const Segment &segment) const
+  {
+    for (uint8_t i = 0; i < segment.length; i++)
+      out.append(literals[segment.start + i]);
+  }
+
+  template <size_t N>
+  static void appendField(TextBuffer<N> &out, const Segment &segment, long value)
+  {
+    out.append(IntField{value, segment.width, segment.fill});
+  }
+
+  template <size_t N>
+  static void appendField(TextBuffer<N> &out, const Segment &segment, const char *text)
+  {
+    uint8_t written = 0;
+    while (*text && written < segment.width)
+    {
+      out.append(fontGlyphIndex(utf8Next(text)));
+      written++;
+    }
+    for (; written < segment.width; written++)
+      out.append(' ');
+  }
+};
+
+// Conversion character a format argument of type T needs
+template <typename T>
+constexpr char textFormatKind()
+{
+  return std::is_integral<T>::value ? 'd' : std::is_convertible<T, const char *>::value ? 's' : 0;
+}
+
+// Parses 'format' for arguments of the types Args. Declare the result
+// constexpr so that mistakes are reported by the compiler:
+//
+//   static constexpr auto TIME_FORMAT = makeFormat<int, int>("%02d:%02d");
+//   display.print(TIME_FORMAT, hours, minutes);
+template <typename... Args, size_t N>
+constexpr TextFormat<Args...> makeFormat(const char (&format)[N])
+{
+  using Format = TextFormat<Args...>;
+  using Segment = typename Format::Segment;
+  constexpr char kinds[] = {textFormatKind<Args>()..., 0};
+  constexpr uint8_t INT_MAX_LENGTH = 20; // Digits and sign of a 64-bit long
+
+  Format result{};
+  uint8_t literalLength = 0;
+  uint8_t argument = 0;
+  unsigned maxLength = 0;
+  unsigned width = 0;
+
+  for (size_t i = 0; i + 1 < N;)
+  {
+    char c = format[i++];
+    if (c != '%' || format[i] == '%')
+    {
+      if (c == '%')
+        i++; // "%%"
+      if (c < 0x20 || c > 0x7E)
+        textFormatError("format literals must be printable ASCII");
+
+      // Extend the current literal segment or start a new one
+      if (result.segmentCount == 0 || result.segments[result.segmentCount - 1].kind != 'l')
+      {
+        if (result.segmentCount == Format::MAX_SEGMENTS)
+          textFormatError("too many segments in format");
+        Segment &segment = result.segments[result.segmentCount++];
+        segment.kind = 'l';
+        segment.start = literalLength;
+      }
+      if (literalLength == Format::CAPACITY)
+        textFormatError("format too long");
+      result.literals[literalLength++] = c;
+      result.segments[result.segmentCount - 1].length++;
+      maxLength++;
+      width++;
+      continue;
+    }
+
+    Segment segment;
+    if (format[i] == '0')
+    {
+      segment.fill = '0';
+      i++;
+    }
+    while (format[i] >= '0' && format[i] <= '9')
+      segment.width = segment.width * 10 + (format[i++] - '0');
+    segment.kind = format[i++];
+
+    if (segment.kind != 'd' && segment.kind != 's')
+      textFormatError("unsupported conversion in format (use %d, %Nd, %0Nd, %Ns or %%)");
+    if (segment.kind == 's' && (segment.width == 0 || segment.fill == '0'))
+      textFormatError("%s needs a width (%Ns)");
+    if (argument == sizeof...(Args))
+      textFormatError("format has more conversions than arguments");
+    if (kinds[argument] != segment.kind)
+      textFormatError("argument type does not match its conversion");
+    if (result.segmentCount == Format::MAX_SEGMENTS)
+      textFormatError("too many segments in format");
+
+    result.segments[result.segmentCount++] = segment;
+    argument++;
+    if (segment.kind == 'd')
+    {
+      maxLength += segment.width > INT_MAX_LENGTH ? segment.width : INT_MAX_LENGTH;
+      width += segment.width > 0 ? segment.width : 1;
+    }
+    else
+    {
+      maxLength += segment.width;
+      width += segment.width;
+    }
+  }
+
+  if (argument != sizeof...(Args))
+    textFormatError("format has fewer conversions than arguments");
+  if (maxLength > Format::CAPACITY)
+    textFormatError("format output may not fit in TextFormat::CAPACITY");
+
+  result.width = static_cast<uint8_t>(width);
+  result.maxLength = static_cast<uint8_t>(maxLength);
+  return result;
+}
+
+#endif // TEXT_FORMAT_H
@@ -0,0 +1,168 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include "Font6x8.h"
+#include "PageBuffer.h"
+#include "Utf8.h"
+#include <algorithm>
+#include <stddef.h>
+#include <stdint.h>
+
+// Text engine for the built-in 6x8 font that writes glyph columns straight
+// into a page-major frame instead of plotting pixel by pixel. When the top
+// row of a line is on a page boundary every glyph column is one masked byte
+// write; otherwise the column is shifted and split over the two pages it covers.
+//
+// Output matches Adafruit_GFX::write/drawChar at text size 1: lit glyph pixels
+// take the text color, and when the background color differs from it the rest
+// of the 6x8 cell (including the spacing column) takes the background color,
+// so setTextColor(0, 1) gives inverse video. Drawing is limited to a clip rectangle.
+class TextRenderer
+{
+public:
+  // Starts with the clip rectangle of 'frame'
+  explicit TextRenderer(const PageBuffer &frame)
+      : frame(frame),
+        clipX0(frame.clipLeft()), clipY0(frame.clipTop()),
+        clipX1(frame.clipRight()), clipY1(frame.clipBottom()) {}
+
+  // Limits drawing to the rectangle with inclusive corners (x0, y0) and (x1, y1)
+  void setClip(int x0, int y0, int x1, int y1)
+  {
+    clipX0 = std::max(x0, 0);
+    clipY0 = std::max(y0, 0);
+    clipX1 = std::min(x1, frame.width() - 1);
+    clipY1 = std::min(y1, frame.height() - 1);
+  }
+
+  // Draws the 6x8 cell of one glyph (5 column bytes, bit 0 on top) at (x, y)
+  void drawGlyph(int x, int y, const uint8_t *columns, int color, int bg)
+  {
+    drawCell(x, cellRows(y), columns, color, bg);
+  }
+
+  // Writes UTF-8 text like Adafruit_GFX::write: '\n' starts a new line, '\r'
+  // is ignored and with 'wrap' a character that does not fit goes to the next
+  // line. The cursor is left after the last character.
+  void print(const char *text, int &cursorX, int &cursorY, int color, int bg, bool wrap)
+  {
+    CellRows rows = cellRows(cursorY);
+    while (*text)
+      put(fontGlyphIndex(utf8Next(text)), cursorX, cursorY, rows, color, bg, wrap);
+  }
+
+  // Same for 'count' glyph indices that are already decoded (see GlyphString.h)
+  void printGlyphs(const uint8_t *glyphs, size_t count, int &cursorX, int &cursorY, int color, int bg, bool wrap)
+  {
+    CellRows rows = cellRows(cursorY);
+    for (size_t i = 0; i < count; i++)
+      put(glyphs[i], cursorX, cursorY, rows, color, bg, wrap);
+  }
+
+private:
+  // Where the rows of a text line land: the page of its top row, the shift
+  // within that page and, for each of the two pages, the rows inside the clip
+  struct CellRows
+  {
+    int page;
+    int shift;
+    uint8_t upperMask; // Rows in 'page'
+    uint8_t lowerMask; // Rows in 'page + 1' (only when shift != 0)
+  };
+
+  PageBuffer frame;
+  int clipX0, clipY0, clipX1, clipY1; // Inclusive, inside the frame
+
+  // Draws one glyph at the cursor and advances it; 'rows' follows cursorY
+  void put(uint8_t glyph, int &cursorX, int &cursorY, CellRows &rows, int color, int bg, bool wrap)
+  {
+    if (glyph == '\n')
+    {
+      cursorX = 0;
+      cursorY += FONT_6X8_HEIGHT;
+      rows = cellRows(cursorY);
+    }
+    else if (glyph != '\r')
+    {
+      if (wrap && cursorX + FONT_6X8_WIDTH > frame.width())
+      {
+        cursorX = 0;
+        cursorY += FONT_6X8_HEIGHT;
+        rows = cellRows(cursorY);
+      }
+      drawCell(cursorX, rows, fontGlyph(glyph), color, bg);
+      cursorX += FONT_6X8_WIDTH;
+    }
+  }
+
+  CellRows cellRows(int y) const
+  {
+    const int top = std::max(y, clipY0);
+    const int bottom = std::min(y + FONT_6X8_HEIGHT - 1, clipY1);
+
+    CellRows rows;
+    rows.page = y >= 0 ? y / 8 : (y - 7) / 8; // Rounded down for lines above the frame
+    rows.shift = y - rows.page * 8;
+    rows.upperMask = rowMask(rows.page, top, bottom);
+    rows.lowerMask = rows.shift ? rowMask(rows.page + 1, top, bottom) : 0;
+    return rows;
+  }
+
+  // Bits of 'page' covering rows top..bottom
+  static uint8_t rowMask(int page, int top, int bottom)
+  {
+    int first = std::max(top - page * 8, 0);
+    int last = std::min(bottom - page * 8, 7);
+    if (first > last)
+      return 0;
+    return static_cast<uint8_t>((0xFF << first) & (0xFF >> (7 - last)));
+  }
+
+  void drawCell(int x, const CellRows &rows, const uint8_t *columns, int color, int bg)
+  {
+    const int x0 = std::max(x, clipX0);
+    const int x1 = std::min(x + FONT_6X8_WIDTH - 1, clipX1);
+    if (x0 > x1 || (rows.upperMask | rows.lowerMask) == 0)
+      return;
+
+    uint8_t *upper = frame.data() + rows.page * frame.width();
+    uint8_t *lower = upper + frame.width();
+
+    for (int col = x0; col <= x1; col++)
+    {
+      // The sixth column is the spacing between characters
+      uint8_t bits = col - x < FONT_6X8_COLUMNS ? columns[col - x] : 0;
+
+      if (rows.upperMask)
+        paint(upper[col], static_cast<uint8_t>(bits << rows.shift), rows.upperMask, color, bg);
+      if (rows.lowerMask)
+        paint(lower[col], static_cast<uint8_t>(bits >> (8 - rows.shift)), rows.lowerMask, color, bg);
+    }
+  }
+
+  // Lit bits take 'color'; with an opaque background the others take 'bg'
+  static void paint(uint8_t &cell, uint8_t bits, uint8_t mask, int color, int bg)
+  {
+    apply(cell, bits & mask, color);
+    if (bg != color)
+      apply(cell, ~bits & mask, bg);
+  }
+
+  static void apply(uint8_t &cell, uint8_t mask, int color)
+  {
+    switch (color)
+    {
+    case PIXEL_WHITE:
+      cell |= mask;
+      break;
+    case PIXEL_BLACK:
+      cell &= ~mask;
+      break;
+    case PIXEL_INVERSE:
+      cell ^= mask;
+      break;
+    }
+  }
+};
+
+#endif // TEXT_RENDERER_H
@@ -0,0 +1,61 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <stdint.h>
+
+static constexpr uint32_t UTF8_REPLACEMENT = 0xFFFD; // Returned for malformed input
+
+// Decodes the code point that starts at 'text' and moves 'text' past it.
+// A malformed or truncated sequence yields UTF8_REPLACEMENT and skips one
+// byte, so decoding always makes progress. 'text' must not be at the end.
+// constexpr, so literals can be checked at compile time.
+constexpr uint32_t utf8Next(const char *&text)
+{
+  const uint8_t lead = static_cast<uint8_t>(*text++);
+  if (lead < 0x80)
+    return lead;
+
+  int continuation = 0;
+  uint32_t codepoint = 0;
+  uint32_t minimum = 0;
+  if ((lead & 0xE0) == 0xC0)
+  {
+    continuation = 1;
+    codepoint = lead & 0x1F;
+    minimum = 0x80;
+  }
+  else if ((lead & 0xF0) == 0xE0)
+  {
+    continuation = 2;
+    codepoint = lead & 0x0F;
+    minimum = 0x800;
+  }
+  else if ((lead & 0xF8) == 0xF0)
+  {
+    continuation = 3;
+    codepoint = lead & 0x07;
+    minimum = 0x10000;
+  }
+  else
+  {
+    return UTF8_REPLACEMENT; // Stray continuation byte or invalid lead byte
+  }
+
+  const char *next = text;
+  for (int i = 0; i < continuation; i++, next++)
+  {
+    const uint8_t byte = static_cast<uint8_t>(*next);
+    if ((byte & 0xC0) != 0x80)
+      return UTF8_REPLACEMENT; // Also stops at the terminating zero
+    codepoint = (codepoint << 6) | (byte & 0x3F);
+  }
+
+  // Overlong forms, surrogates and values above U+10FFFF are not characters
+  if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+    return UTF8_REPLACEMENT;
+
+  text = next;
+  return codepoint;
+}
+
+#endif // UTF8_H
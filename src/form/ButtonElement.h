@@ -23,6 +23,7 @@ public:
 
     void draw(DisplayInterface &display, int x, int y, int /*elementWidth*/) override
     {
+        PROFILE_SCOPE("ButtonElement::draw");
         int textWidth = label.length() * CHAR_WIDTH;
         int rectWidth = textWidth + 6 * CHAR_WIDTH; // 3 chars padding left + right
         int rectHeight = getHeight();
@@ -47,10 +48,15 @@ public:
         display.print(label.c_str());
     }
 
+    uint8_t gestures(uint8_t buttonId) const override
+    {
+        return buttonId == BUTTON_CENTER ? GESTURE_CLICK : 0;
+    }
+
     bool handleInput(ButtonEvent buttonEvent) override
     {
         if (buttonEvent.action == ButtonAction::SHORT_CLICK &&
-            buttonEvent.buttonName == "CENTER")
+            buttonEvent.buttonId == BUTTON_CENTER)
         {
             if (callback)
                 callback(label);
@@ -68,7 +74,14 @@ public:
 
     void setEditing(bool /*editing*/) override {} // not used
 
-    void setSelected(bool select) { isSelected = select; }
+    void setSelected(bool select) override
+    {
+        if (isSelected != select)
+        {
+            isSelected = select;
+            invalidate();
+        }
+    }
 
     const String &getLabel() const { return label; }
 };
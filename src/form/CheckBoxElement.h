@@ -30,6 +30,8 @@ private:
     unsigned long lastScrollTime = 0;
     int scrollOffset = 0;
     int scrollDirection = 1; // 1 for right, -1 for left
+    bool labelScrolling = false; // Whether the last draw scrolled the label
+    unsigned long lastDrawTime = 0; // Clock::now() of the last draw, for the cursor blink
 
 public:
     // Constructor with label and optional default state
@@ -39,6 +41,7 @@ public:
     // Draws the checkbox element on the screen
     void draw(DisplayInterface &display, int x, int y, int elementWidth) override
     {
+        PROFILE_SCOPE("CheckBoxElement::draw");
         if (isSelected)
         {
             display.drawFastVLine(x, y, getHeight(), 1);
@@ -67,9 +70,10 @@ public:
 
         String visibleText = label;
 
-        if (isSelected && label.length() > maxVisibleChars)
+        labelScrolling = isSelected && label.length() > static_cast<unsigned int>(maxVisibleChars);
+        if (labelScrolling)
         {
-            unsigned long now = millis();
+            unsigned long now = Clock::now();
             if (now - lastScrollTime > 200)
             {
                 scrollOffset += scrollDirection;
@@ -78,7 +82,7 @@ public:
                     scrollOffset = 0;
                     scrollDirection = 1;
                 }
-                else if (scrollOffset > label.length() - maxVisibleChars)
+                else if (static_cast<unsigned int>(scrollOffset) > label.length() - maxVisibleChars)
                 {
                     scrollOffset = label.length() - maxVisibleChars;
                     scrollDirection = -1;
@@ -92,7 +96,7 @@ public:
         {
             scrollOffset = 0;
             scrollDirection = 1;
-            if (label.length() > maxVisibleChars)
+            if (label.length() > static_cast<unsigned int>(maxVisibleChars))
             {
                 visibleText = label.substring(0, maxVisibleChars);
             }
@@ -100,13 +104,21 @@ public:
 
         display.print(visibleText.c_str());
 
-        if (isEditing && (millis() % 1000 < 500))
+        lastDrawTime = Clock::now();
+        if (isEditing && (lastDrawTime % 1000 < 500))
         {
             int cursorY = boxY + BOX_SIZE + CURSOR_OFFSET;
             display.drawFastHLine(boxX, cursorY, BOX_SIZE, 1);
         }
     }
 
+    uint8_t gestures(uint8_t buttonId) const override
+    {
+        if (buttonId == BUTTON_CENTER)
+            return GESTURE_CLICK | GESTURE_DOUBLE_CLICK;
+        return buttonId == BUTTON_UP || buttonId == BUTTON_DOWN ? GESTURE_CLICK : 0;
+    }
+
     // Handles user input based on button events
     bool handleInput(ButtonEvent buttonEvent) override
     {
@@ -115,24 +127,27 @@ public:
 
         if (buttonEvent.action == ButtonAction::SHORT_CLICK)
         {
-            if (buttonEvent.buttonName == "UP")
+            if (buttonEvent.buttonId == BUTTON_UP)
             {
                 isChecked = true;
+                invalidate();
                 return true;
             }
-            else if (buttonEvent.buttonName == "DOWN")
+            else if (buttonEvent.buttonId == BUTTON_DOWN)
             {
                 isChecked = false;
+                invalidate();
                 return true;
             }
-            else if (buttonEvent.buttonName == "CENTER")
+            else if (buttonEvent.buttonId == BUTTON_CENTER)
             {
                 isChecked = !isChecked;
+                invalidate();
                 return true;
             }
         }
         else if (buttonEvent.action == ButtonAction::DOUBLE_CLICK &&
-                 buttonEvent.buttonName == "CENTER")
+                 buttonEvent.buttonId == BUTTON_CENTER)
         {
             setEditing(false);
             return true;
@@ -154,10 +169,29 @@ public:
     void setEditing(bool editing) override
     {
         isEditing = editing;
+        invalidate();
     }
 
     // Sets whether this element is selected in the UI
-    void setSelected(bool select) { isSelected = select; }
+    void setSelected(bool select) override
+    {
+        if (isSelected != select)
+        {
+            isSelected = select;
+            invalidate();
+        }
+    }
+
+    // Next label scroll step or cursor blink
+    unsigned long nextDeadline(unsigned long /*now*/) const override
+    {
+        unsigned long deadline = NO_DEADLINE;
+        if (labelScrolling)
+            deadline = lastScrollTime + 201; // draw() scrolls once more than 200 ms passed
+        if (isEditing)
+            deadline = earliest(deadline, nextMultiple(lastDrawTime, 500));
+        return deadline;
+    }
 
     // Returns the current checkbox state
     bool getValue() const { return isChecked; }
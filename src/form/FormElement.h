@@ -3,8 +3,13 @@
 
 #include "../display/DisplayInterface.h"
 #include "../button/ButtonManager.h"
+#include "../ui/Widget.h"
+#include "../platform/Profiler.h"
+#include "../platform/Clock.h"
 
-class FormElement
+// Elementele se invalidează singure când starea lor se schimbă și raportează
+// termene (nextDeadline) pentru animații: derulare, cursor care clipește
+class FormElement : public Widget
 {
 public:
   virtual ~FormElement() = default; // Asigură ștergerea corectă a obiectelor derivate
@@ -15,6 +20,9 @@ public:
   // Gestionează evenimentele de intrare
   // Returnează true dacă evenimentul a fost procesat
   virtual bool handleInput(ButtonEvent buttonEvent) = 0;
+
+  // Gesturile (ButtonGesture) folosite de handleInput() pentru un buton
+  virtual uint8_t gestures(uint8_t /*buttonId*/) const { return GESTURE_ALL; }
   
   // Returnează înălțimea elementului în pixeli
   virtual int getHeight() = 0;
@@ -25,10 +33,10 @@ public:
   
   // Activează/dezactivează modul editare
   // Parametrul editing: true pentru intrare în mod editare, false pentru ieșire
-  virtual void setEditing(bool editing) {}
+  virtual void setEditing(bool /*editing*/) {}
 
-  virtual bool getEditing();
-  virtual void setSelected(bool selected);
+  virtual bool getEditing() { return false; }
+  virtual void setSelected(bool /*selected*/) {}
 };
 
 #endif
\ No newline at end of file
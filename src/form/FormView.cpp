@@ -8,6 +8,7 @@ FormView::FormView(DisplayInterface& disp) : display(disp) {}
 void FormView::addElement(const std::shared_ptr<FormElement>& element) {
     if (element) {
         elements.push_back(element);
+        invalidate();
     }
 }
 
@@ -21,41 +22,6 @@ int FormView::getVisibleHeight() const {
     return display.height() - offsetY - reduceHeight;
 }
 
-// Draws the form elements that are currently visible on screen
-void FormView::draw() {
-    if (elements.empty()) return;
-
-    const int spacing = 5;
-    const int visibleHeight = getVisibleHeight();
-
-    // Începem de la elementul curent și încercăm să ne întoarcem cât putem în sus
-    size_t startIndex = currentElement;
-    int totalHeight = elements[currentElement]->getHeight();
-
-    // Extindem în sus cât ne permite spațiul
-    while (startIndex > 0) {
-        int h = elements[startIndex - 1]->getHeight() + spacing;
-        if (totalHeight + h > visibleHeight) break;
-        totalHeight += h;
-        startIndex--;
-    }
-
-    // Acum desenăm în jos cât încape
-    int yPos = offsetY;
-    for (size_t i = startIndex; i < elements.size(); ++i) {
-        int elemHeight = elements[i]->getHeight();
-        if (yPos + elemHeight > offsetY + visibleHeight) break;
-
-        elements[i]->setSelected(i == currentElement);
-        elements[i]->draw(display, offsetX, yPos, getVisibleWidth());
-
-        yPos += elemHeight + spacing;
-    }
-}
-
-
-
-
 // Handles input events like UP, DOWN, and CENTER button presses
 void FormView::handleInput(ButtonEvent buttonEvent) {
     if (elements.empty()) return;
@@ -66,13 +32,15 @@ void FormView::handleInput(ButtonEvent buttonEvent) {
         if (handled) return;
     }
 
-    // Navigation or selection input
-    if (buttonEvent.action == ButtonAction::SHORT_CLICK) {
-        if (buttonEvent.buttonName == "UP" && currentElement > 0) {
+    // Navigation (held UP/DOWN repeat) or selection input
+    if (buttonEvent.isStep()) {
+        if (buttonEvent.buttonId == BUTTON_UP && currentElement > 0) {
             currentElement--; // Move selection up
-        } else if (buttonEvent.buttonName == "DOWN" && currentElement < elements.size() - 1) {
+            invalidate();
+        } else if (buttonEvent.buttonId == BUTTON_DOWN && currentElement < elements.size() - 1) {
             currentElement++; // Move selection down
-        } else if (buttonEvent.buttonName == "CENTER") {
+            invalidate();
+        } else if (buttonEvent.buttonId == BUTTON_CENTER && buttonEvent.action == ButtonAction::SHORT_CLICK) {
             // Start editing if the selected element is editable
             if (elements[currentElement]->canEdit()) {
                 elements[currentElement]->setEditing(true);
@@ -84,22 +52,65 @@ void FormView::handleInput(ButtonEvent buttonEvent) {
     }
 }
 
+uint8_t FormView::gestures(uint8_t buttonId) const {
+    uint8_t used = 0;
+    if (buttonId == BUTTON_UP || buttonId == BUTTON_DOWN) {
+        used = GESTURE_CLICK | GESTURE_REPEAT;
+    } else if (buttonId == BUTTON_CENTER) {
+        used = GESTURE_CLICK;
+    }
+    if (!elements.empty() && elements[currentElement]->getEditing()) {
+        used |= elements[currentElement]->gestures(buttonId);
+    }
+    return used;
+}
+
+// True if the view or any of its elements needs a redraw
+bool FormView::isInvalid() const {
+    if (Widget::isInvalid()) return true;
+    for (const auto& element : elements) {
+        if (element->isInvalid()) return true;
+    }
+    return false;
+}
+
+// Marks the view and all its elements as drawn
+void FormView::markDrawn() {
+    Widget::markDrawn();
+    for (const auto& element : elements) {
+        element->markDrawn();
+    }
+}
+
+// Elements only animate while selected or edited, so they are on screen
+unsigned long FormView::nextDeadline(unsigned long now) const {
+    unsigned long deadline = NO_DEADLINE;
+    for (const auto& element : elements) {
+        deadline = earliest(deadline, element->nextDeadline(now));
+    }
+    return deadline;
+}
+
 // Set horizontal offset for rendering
 void FormView::setOffsetX(int x) {
     offsetX = x;
+    invalidate();
 }
 
 // Set vertical offset for rendering
 void FormView::setOffsetY(int y) {
     offsetY = y;
+    invalidate();
 }
 
 // Reduce the visible width by a number of pixels
 void FormView::reduceVisibleWidth(int pixels) {
     reduceWidth = pixels;
+    invalidate();
 }
 
 // Reduce the visible height by a number of pixels
 void FormView::reduceVisibleHeight(int pixels) {
     reduceHeight = pixels;
+    invalidate();
 }
@@ -4,12 +4,16 @@
 #include "../display/DisplayInterface.h"
 #include "../button/ButtonManager.h"
 #include "FormElement.h"
+#include "../ui/Widget.h"
+#include "../ui/DamageList.h"
+#include "../platform/Profiler.h"
+#include "../platform/Clock.h"
 #include <memory>
 #include <vector>
 
 // The FormView class is responsible for displaying and interacting with a list of FormElements.
 // It manages layout, input handling, and rendering within a specified visible area.
-class FormView {
+class FormView : public Widget {
 private:
     DisplayInterface& display; // Reference to the display interface used to draw elements
     std::vector<std::shared_ptr<FormElement>> elements; // List of form elements to be displayed
@@ -34,11 +38,28 @@ public:
     void addElement(const std::shared_ptr<FormElement>& element);
 
     // Renders the form elements currently visible on the screen
-    void draw();
+    void draw() { draw(display); }
+
+    // Same, calling the primitives on the concrete display type (see
+    // DisplayInterface.h); 'target' must be the display given to the constructor.
+    // Elements still draw through DisplayInterface.
+    template <typename Display>
+    void draw(Display& target);
 
     // Handles button input events (e.g., navigation and editing)
     void handleInput(ButtonEvent buttonEvent);
 
+    // Gestures handleInput() uses in the current mode: the navigation ones,
+    // plus those of the element being edited (for ButtonManager::setGestures())
+    uint8_t gestures(uint8_t buttonId) const;
+
+    // The view is invalid when it or one of its elements changed
+    bool isInvalid() const override;
+    void markDrawn() override;
+
+    // Earliest animation deadline of the elements
+    unsigned long nextDeadline(unsigned long now) const override;
+
     // Sets the horizontal offset for rendering
     void setOffsetX(int x);
 
@@ -52,4 +73,89 @@ public:
     void reduceVisibleHeight(int pixels);
 };
 
+// Draws the form elements that are currently visible on screen.
+// In retained mode only elements that changed, moved or have an animation
+// step due are cleared and redrawn; elements that scrolled out are erased.
+template <typename Display>
+void FormView::draw(Display& target) {
+    PROFILE_SCOPE("FormView::draw");
+    if (elements.empty()) return;
+
+    const int spacing = 5;
+    const int visibleHeight = getVisibleHeight();
+    const Rect bounds(offsetX, offsetY, getVisibleWidth(), visibleHeight);
+    const unsigned long now = Clock::now();
+
+    // Începem de la elementul curent și încercăm să ne întoarcem cât putem în sus
+    size_t startIndex = currentElement;
+    int totalHeight = elements[currentElement]->getHeight();
+
+    // Extindem în sus cât ne permite spațiul
+    while (startIndex > 0) {
+        int h = elements[startIndex - 1]->getHeight() + spacing;
+        if (totalHeight + h > visibleHeight) break;
+        totalHeight += h;
+        startIndex--;
+    }
+
+    // Acum stabilim ce încape în jos
+    size_t endIndex = startIndex;
+    int yPos = offsetY;
+    for (; endIndex < elements.size(); ++endIndex) {
+        int elemHeight = elements[endIndex]->getHeight();
+        if (yPos + elemHeight > offsetY + visibleHeight) break;
+        elements[endIndex]->setSelected(endIndex == currentElement);
+        yPos += elemHeight + spacing;
+    }
+
+    const bool full = needsFullRepaint(bounds);
+    DamageList damage;
+
+    if (full) {
+        damage.add(getDrawnBounds());
+        damage.add(bounds);
+    } else {
+        yPos = offsetY;
+        for (size_t i = 0; i < elements.size(); ++i) {
+            FormElement& element = *elements[i];
+            if (i < startIndex || i >= endIndex) {
+                damage.add(element.getDrawnBounds()); // Scrolled out of view
+                continue;
+            }
+            Rect rect(offsetX, yPos, bounds.w, element.getHeight());
+            if (element.needsRepaint(rect, now)) {
+                damage.add(element.getDrawnBounds());
+                damage.add(rect);
+            }
+            yPos += rect.h + spacing;
+        }
+    }
+
+    if (isRetained()) damage.erase(target);
+
+    // Elements cannot draw outside the form, e.g. over a status bar
+    ScopedClip clip(target, bounds);
+
+    // Acum desenăm în jos cât încape
+    yPos = offsetY;
+    for (size_t i = 0; i < elements.size(); ++i) {
+        FormElement& element = *elements[i];
+        if (i < startIndex || i >= endIndex) {
+            element.setDrawnBounds(Rect());
+            continue;
+        }
+
+        Rect rect(offsetX, yPos, bounds.w, element.getHeight());
+        if ((full || damage.intersects(rect)) && target.isVisible(rect)) {
+            element.draw(target, offsetX, yPos, getVisibleWidth());
+            element.markDrawn();
+        }
+        element.setDrawnBounds(rect);
+
+        yPos += rect.h + spacing;
+    }
+
+    setDrawnBounds(bounds);
+}
+
 #endif
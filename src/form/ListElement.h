@@ -28,6 +28,7 @@ private:
     int scrollDirection = 1; // 1 = right, -1 = left
     unsigned long lastScrollTime = 0;
     const int SCROLL_INTERVAL = 200; // ms
+    bool valueScrolling = false; // Whether the last draw scrolled the value
 
 public:
     ListElement(const String &label, const std::vector<String> &options, int defaultIndex = 0)
@@ -39,6 +40,7 @@ public:
 
     void draw(DisplayInterface &display, int x, int y, int elementWidth) override
     {
+        PROFILE_SCOPE("ListElement::draw");
         if (isSelected)
         {
             display.drawFastVLine(x, y, getHeight(), 1);
@@ -59,10 +61,11 @@ public:
         String value = options.empty() ? "" : options[selectedIndex];
 
         // Scroll logic (ping-pong)
-        if ((isSelected || isEditing) && value.length() > maxVisibleChars)
+        valueScrolling = (isSelected || isEditing) && value.length() > static_cast<unsigned int>(maxVisibleChars);
+        if (valueScrolling)
         {
-            unsigned long currentTime = millis();
-            if (currentTime - lastScrollTime > SCROLL_INTERVAL)
+            unsigned long currentTime = Clock::now();
+            if (currentTime - lastScrollTime > static_cast<unsigned long>(SCROLL_INTERVAL))
             {
                 scrollOffset += scrollDirection;
 
@@ -87,7 +90,7 @@ public:
         }
 
         String visibleValue = value;
-        if (value.length() > maxVisibleChars)
+        if (value.length() > static_cast<unsigned int>(maxVisibleChars))
         {
             visibleValue = value.substring(scrollOffset, scrollOffset + maxVisibleChars);
         }
@@ -135,8 +138,8 @@ public:
         // Blinking underline cursor
         if (isEditing && !options.empty())
         {
-            unsigned long currentTime = millis();
-            if (currentTime - lastBlinkTime > BLINK_INTERVAL)
+            unsigned long currentTime = Clock::now();
+            if (currentTime - lastBlinkTime > static_cast<unsigned long>(BLINK_INTERVAL))
             {
                 blinkState = !blinkState;
                 lastBlinkTime = currentTime;
@@ -152,33 +155,42 @@ public:
         }
     }
 
+    uint8_t gestures(uint8_t buttonId) const override
+    {
+        if (buttonId == BUTTON_LEFT || buttonId == BUTTON_RIGHT)
+            return GESTURE_CLICK | GESTURE_REPEAT;
+        return buttonId == BUTTON_CENTER ? GESTURE_DOUBLE_CLICK : 0;
+    }
+
     bool handleInput(ButtonEvent buttonEvent) override
     {
         if (!isEditing)
             return false;
 
-        if (buttonEvent.action == ButtonAction::SHORT_CLICK)
+        if (buttonEvent.isStep())
         {
-            if (buttonEvent.buttonName == "LEFT")
+            if (buttonEvent.buttonId == BUTTON_LEFT)
             {
                 if (selectedIndex > 0)
                 {
                     selectedIndex--;
+                    invalidate();
                     return true;
                 }
             }
-            else if (buttonEvent.buttonName == "RIGHT")
+            else if (buttonEvent.buttonId == BUTTON_RIGHT)
             {
                 if (selectedIndex < (int)options.size() - 1)
                 {
                     selectedIndex++;
+                    invalidate();
                     return true;
                 }
             }
         }
         else if (buttonEvent.action == ButtonAction::DOUBLE_CLICK)
         {
-            if (buttonEvent.buttonName == "CENTER")
+            if (buttonEvent.buttonId == BUTTON_CENTER)
             {
                 setEditing(false);
                 return true;
@@ -201,13 +213,32 @@ public:
     {
         isEditing = editing;
         blinkState = true;
-        lastBlinkTime = millis();
-        lastScrollTime = millis();
+        lastBlinkTime = Clock::now();
+        lastScrollTime = Clock::now();
         scrollOffset = 0;
         scrollDirection = 1;
+        invalidate();
     }
 
-    void setSelected(bool select) { isSelected = select; }
+    void setSelected(bool select) override
+    {
+        if (isSelected != select)
+        {
+            isSelected = select;
+            invalidate();
+        }
+    }
+
+    // Next value scroll step or cursor blink; draw() acts once an interval has been exceeded
+    unsigned long nextDeadline(unsigned long /*now*/) const override
+    {
+        unsigned long deadline = NO_DEADLINE;
+        if (valueScrolling)
+            deadline = lastScrollTime + SCROLL_INTERVAL + 1;
+        if (isEditing && !options.empty())
+            deadline = earliest(deadline, lastBlinkTime + BLINK_INTERVAL + 1);
+        return deadline;
+    }
 
     int getSelectedIndex() const { return selectedIndex; }
 
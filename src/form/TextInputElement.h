@@ -21,6 +21,7 @@ private:
     int visibleStart = 0;       // Index of the first visible character
     bool isEditing = false;     // Whether the element is currently being edited
     bool isSelected = false;    // Whether the element is currently selected
+    unsigned long lastDrawTime = 0; // Clock::now() of the last draw, for the cursor blink
 
     // Enumeration of supported character sets
     enum CharSet
@@ -52,6 +53,7 @@ public:
     // Draws the text input element on the screen
     void draw(DisplayInterface &display, int x, int y, int elementWidth) override
     {
+        PROFILE_SCOPE("TextInputElement::draw");
         if (isSelected)
         {
             display.drawFastVLine(x, y, getHeight(), 1);
@@ -84,80 +86,98 @@ public:
         display.print(visibleValue.c_str());
 
         // Draw cursor if in editing mode and blinking
-        if (isEditing && (millis() % 1000 < 500))
+        lastDrawTime = Clock::now();
+        if (isEditing && (lastDrawTime % 1000 < 500))
         {
             int cursorX = textX + (cursorPos - visibleStart) * CHAR_WIDTH;
             int cursorY1 = textY + 8;
-            int cursorY2 = boxY + BOX_HEIGHT - CURSOR_HEIGHT_OFFSET;
             display.drawFastHLine(cursorX, cursorY1, 5, 1);
         }
     }
 
     // Handles user input based on button events
+    uint8_t gestures(uint8_t buttonId) const override
+    {
+        if (buttonId == BUTTON_LEFT || buttonId == BUTTON_RIGHT)
+            return GESTURE_CLICK | GESTURE_REPEAT | GESTURE_LONG_PRESS;
+        if (buttonId == BUTTON_UP || buttonId == BUTTON_DOWN)
+            return GESTURE_CLICK | GESTURE_REPEAT | GESTURE_DOUBLE_CLICK;
+        return buttonId == BUTTON_CENTER ? GESTURE_DOUBLE_CLICK : 0;
+    }
+
     bool handleInput(ButtonEvent buttonEvent) override
     {
         if (!isEditing)
             return false;
 
-        // Handle single-click events
-        if (buttonEvent.action == ButtonAction::SHORT_CLICK)
+        // Handle single-click and repeat events
+        if (buttonEvent.isStep())
         {
-            if (buttonEvent.buttonName == "LEFT")
+            if (buttonEvent.buttonId == BUTTON_LEFT)
             {
-                cursorPos = constrain(cursorPos - 1, 0, value.length());
+                cursorPos = constrain(cursorPos - 1, 0, static_cast<int>(value.length()));
                 updateCharSetByCursor();
+                invalidate();
                 return true;
             }
-            else if (buttonEvent.buttonName == "RIGHT")
+            else if (buttonEvent.buttonId == BUTTON_RIGHT)
             {
-                cursorPos = constrain(cursorPos + 1, 0, value.length());
+                cursorPos = constrain(cursorPos + 1, 0, static_cast<int>(value.length()));
                 updateCharSetByCursor();
+                invalidate();
                 return true;
             }
-            else if (buttonEvent.buttonName == "UP")
+            else if (buttonEvent.buttonId == BUTTON_UP)
             {
                 cycleCharAtCursor();
+                invalidate();
                 return true;
             }
-            else if (buttonEvent.buttonName == "DOWN")
+            else if (buttonEvent.buttonId == BUTTON_DOWN)
             {
                 cycleCharAtCursorReverse();
+                invalidate();
                 return true;
             }
         }else if (buttonEvent.action == ButtonAction::DOUBLE_CLICK){
-            if (buttonEvent.buttonName == "CENTER")
+            if (buttonEvent.buttonId == BUTTON_CENTER)
             {
                 setEditing(false);
                 return true;
             }
-        }
-        // Handle long-click events for editing operations
-        else if (buttonEvent.action == ButtonAction::LONG_PRESS)
-        {
-            if (buttonEvent.buttonName == "UP")
+            // UP/DOWN repeat while held, so the character set changes on a double click
+            else if (buttonEvent.buttonId == BUTTON_UP)
             {
                 charSet = static_cast<CharSet>((charSet + 1) % 4);
                 setCharToStartOfCharSet();
+                invalidate();
                 return true;
             }
-            else if (buttonEvent.buttonName == "DOWN")
+            else if (buttonEvent.buttonId == BUTTON_DOWN)
             {
                 charSet = static_cast<CharSet>((charSet + 3) % 4);
                 setCharToStartOfCharSet();
+                invalidate();
                 return true;
             }
-            else if (buttonEvent.buttonName == "LEFT")
+        }
+        // Handle long-click events for editing operations
+        else if (buttonEvent.action == ButtonAction::LONG_PRESS)
+        {
+            if (buttonEvent.buttonId == BUTTON_LEFT)
             {
-                if (cursorPos < value.length())
+                if (cursorPos < static_cast<int>(value.length()))
                 {
                     value.remove(cursorPos, 1);
+                    invalidate();
                 }
                 return true;
             }
-            else if (buttonEvent.buttonName == "RIGHT")
+            else if (buttonEvent.buttonId == BUTTON_RIGHT)
             {
                 value = value.substring(0, cursorPos) + ' ' + value.substring(cursorPos);
                 cursorPos++;
+                invalidate();
                 return true;
             }
         }
@@ -180,16 +200,30 @@ public:
         isEditing = editing;
         if (editing)
         {
-            if (cursorPos >= value.length())
+            if (cursorPos >= static_cast<int>(value.length()))
             {
                 value += 'a'; // Default character when starting editing
             }
             charSet = LOWER;
         }
+        invalidate();
     }
 
     // Sets whether this element is selected in the UI
-    void setSelected(bool select) { isSelected = select; }
+    void setSelected(bool select) override
+    {
+        if (isSelected != select)
+        {
+            isSelected = select;
+            invalidate();
+        }
+    }
+
+    // The cursor blinks on Clock::now() % 1000 while editing
+    unsigned long nextDeadline(unsigned long /*now*/) const override
+    {
+        return isEditing ? nextMultiple(lastDrawTime, 500) : NO_DEADLINE;
+    }
 
     // Returns the current text value
     const String &getValue() const { return value; }
@@ -201,7 +235,7 @@ private:
     // Ensures that the cursor does not go beyond the current value
     void ensureCursorInValue()
     {
-        while (cursorPos >= value.length())
+        while (cursorPos >= static_cast<int>(value.length()))
         {
             value += ' ';
         }
@@ -211,7 +245,7 @@ private:
     void setCharToStartOfCharSet()
     {
         ensureCursorInValue();
-        char c;
+        char c = 'a';
         switch (charSet)
         {
         case LOWER: c = 'a'; break;
@@ -281,10 +315,10 @@ private:
     // Updates the current charset based on the character at the cursor
     void updateCharSetByCursor()
     {
-        if (cursorPos < value.length())
+        if (cursorPos < static_cast<int>(value.length()))
         {
             char c = value.charAt(cursorPos);
-            if (c >= 'a' && c <= 'z' || c == ' ')
+            if ((c >= 'a' && c <= 'z') || c == ' ')
                 charSet = LOWER;
             else if (c >= 'A' && c <= 'Z')
                 charSet = UPPER;
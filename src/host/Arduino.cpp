@@ -0,0 +1,81 @@
+#include <Arduino.h>
+#include <chrono>
+#include <stdarg.h>
+#include <thread>
+
+HostSerial Serial;
+
+namespace
+{
+  const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+  int pinLevels[256];
+  bool pinsInitialized = false;
+
+  void initPins()
+  {
+    if (pinsInitialized)
+      return;
+    for (int &level : pinLevels)
+      level = HIGH; // Buttons are active low with pull-ups
+    pinsInitialized = true;
+  }
+}
+
+unsigned long millis()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long micros()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void delay(unsigned long ms)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield()
+{
+  std::this_thread::yield();
+}
+
+void pinMode(uint8_t /*pin*/, uint8_t /*mode*/)
+{
+  initPins();
+}
+
+int digitalRead(uint8_t pin)
+{
+  initPins();
+  return pinLevels[pin];
+}
+
+void digitalWrite(uint8_t pin, uint8_t level)
+{
+  hostSetPinLevel(pin, level);
+}
+
+void hostSetPinLevel(uint8_t pin, int level)
+{
+  initPins();
+  pinLevels[pin] = level;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+  char text[256];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+  if (length < 0)
+    return 0;
+  return write(reinterpret_cast<const uint8_t *>(text), std::min<size_t>(length, sizeof(text) - 1));
+}
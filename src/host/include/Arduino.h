@@ -0,0 +1,103 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Minimal Arduino core for host (native) builds: timing, simulated GPIO levels
+// and a Serial object that writes to stdout. Only what the UI code uses.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "WString.h"
+
+#define LOW 0x0
+#define HIGH 0x1
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define PROGMEM
+#define IRAM_ATTR
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+
+using std::max;
+using std::min;
+
+template <typename T>
+T constrain(T value, T low, T high)
+{
+  return value < low ? low : (value > high ? high : value);
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t level);
+
+// Host only: sets the level digitalRead() reports for a pin
+void hostSetPinLevel(uint8_t pin, int level);
+
+class Print
+{
+public:
+  virtual ~Print() = default;
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *data, size_t length)
+  {
+    size_t n = 0;
+    while (length--)
+      n += write(*data++);
+    return n;
+  }
+
+  size_t print(const char *text) { return write(reinterpret_cast<const uint8_t *>(text), strlen(text)); }
+  size_t print(const String &text) { return print(text.c_str()); }
+  size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+  size_t print(int value) { return printf("%d", value); }
+  size_t print(unsigned int value) { return printf("%u", value); }
+  size_t print(long value) { return printf("%ld", value); }
+  size_t print(unsigned long value) { return printf("%lu", value); }
+  size_t print(double value, int digits = 2) { return printf("%.*f", digits, value); }
+
+  template <typename T>
+  size_t println(const T &value) { return print(value) + println(); }
+  size_t println() { return print("\r\n"); }
+
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+};
+
+// Serial port backed by stdout (writes) and nothing (reads)
+class HostSerial : public Stream
+{
+public:
+  void begin(unsigned long /*baud*/) {}
+  operator bool() const { return true; }
+  size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+  size_t write(const uint8_t *data, size_t length) override { return fwrite(data, 1, length, stdout); }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int availableForWrite() override { return 4096; }
+  void flush() override { fflush(stdout); }
+};
+
+extern HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,95 @@
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+#include <string>
+#include <string.h>
+
+// Subset of the Arduino String class used by the UI code, for host builds
+class String
+{
+public:
+  String(const char *text = "") : value(text ? text : "") {}
+  String(const std::string &text) : value(text) {}
+  explicit String(char c) : value(1, c) {}
+  explicit String(int number) : value(std::to_string(number)) {}
+  explicit String(unsigned int number) : value(std::to_string(number)) {}
+  explicit String(long number) : value(std::to_string(number)) {}
+  explicit String(unsigned long number) : value(std::to_string(number)) {}
+
+  unsigned int length() const { return value.size(); }
+  const char *c_str() const { return value.c_str(); }
+
+  String substring(unsigned int from) const
+  {
+    return from >= value.size() ? String() : String(value.substr(from));
+  }
+
+  String substring(unsigned int from, unsigned int to) const
+  {
+    if (from > to)
+    {
+      unsigned int t = from;
+      from = to;
+      to = t;
+    }
+    if (from >= value.size())
+      return String();
+    if (to > value.size())
+      to = value.size();
+    return String(value.substr(from, to - from));
+  }
+
+  char charAt(unsigned int index) const { return index < value.size() ? value[index] : 0; }
+  void setCharAt(unsigned int index, char c)
+  {
+    if (index < value.size())
+      value[index] = c;
+  }
+
+  void remove(unsigned int index) { remove(index, value.size()); }
+  void remove(unsigned int index, unsigned int count)
+  {
+    if (index < value.size())
+      value.erase(index, count);
+  }
+
+  int indexOf(char c) const
+  {
+    size_t pos = value.find(c);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+  }
+
+  char operator[](unsigned int index) const { return charAt(index); }
+
+  String &operator+=(const String &other)
+  {
+    value += other.value;
+    return *this;
+  }
+  String &operator+=(const char *text)
+  {
+    value += text;
+    return *this;
+  }
+  String &operator+=(char c)
+  {
+    value += c;
+    return *this;
+  }
+
+  friend String operator+(const String &a, const String &b) { return String(a.value + b.value); }
+  friend String operator+(const String &a, const char *b) { return String(a.value + b); }
+  friend String operator+(const char *a, const String &b) { return String(a + b.value); }
+  friend String operator+(const String &a, char b) { return String(a.value + b); }
+
+  bool operator==(const String &other) const { return value == other.value; }
+  bool operator==(const char *text) const { return value == text; }
+  bool operator!=(const String &other) const { return value != other.value; }
+  bool operator!=(const char *text) const { return value != text; }
+  bool operator<(const String &other) const { return value < other.value; }
+
+private:
+  std::string value;
+};
+
+#endif // HOST_WSTRING_H
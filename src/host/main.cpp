@@ -0,0 +1,113 @@
+// Host entry point (env:native): draws the sample views into a FrameBufferDisplay,
+// reports the average draw time of each, through DisplayInterface and through
+// the concrete display type, and exports one frame per view.
+//
+// Usage: program [output-dir] [iterations]
+
+#include "../display/FrameBufferDisplay.h"
+#include "../display/TextDisplay.h"
+#include "../menu/MenuListView.h"
+#include "../menu/MenuBuilder.h"
+#include "../form/FormView.h"
+#include "../form/TextInputElement.h"
+#include "../form/CheckBoxElement.h"
+#include "../form/ListElement.h"
+#include "../form/ButtonElement.h"
+#include "../status/StatusBar.h"
+#include "../status/StatusBattery.h"
+#include "../status/StatusTime.h"
+#include "../platform/Profiler.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+#ifndef PIO_UNIT_TESTING // The test runner brings its own main()
+
+namespace
+{
+  // Draws one view 'iterations' times and returns the mean cost in microseconds
+  double timeFrames(FrameBufferDisplay &display, const std::function<void()> &draw, int iterations)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+      display.clearDisplay();
+      draw();
+      display.display();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+  }
+
+  // Times a view drawn through DisplayInterface (draw()) and through the
+  // concrete display type (draw(display)) and saves the last frame
+  template <typename View>
+  void benchmark(FrameBufferDisplay &display, const char *name, View &view,
+                 const std::string &outputDir, int iterations)
+  {
+    double virtualUs = timeFrames(display, [&] { view.draw(); }, iterations);
+    double staticUs = timeFrames(display, [&] { view.draw(display); }, iterations);
+
+    std::string base = outputDir + "/" + name;
+    bool saved = display.savePBM((base + ".pbm").c_str()) && display.savePNG((base + ".png").c_str());
+    printf("%-12s %9.2f %9.2f us/frame%s\n", name, virtualUs, staticUs, saved ? "" : "  (export failed)");
+  }
+
+  void noAction() {}
+}
+
+int main(int argc, char **argv)
+{
+  std::string outputDir = argc > 1 ? argv[1] : ".";
+  int iterations = argc > 2 ? atoi(argv[2]) : 1000;
+  if (iterations <= 0)
+    iterations = 1;
+
+  FrameBufferDisplay display(128, 64);
+
+  TextDisplay text(display);
+  text.addLine("1. Acesta este un text extrem de lung care nu incape pe ecran");
+  text.addLine("2. Linie medie de text");
+  text.addLine("3. Scurta");
+  text.addLine("4. Alt exemplu de text lung pentru demonstratie");
+  text.addLine("5. Ultimul element din lista");
+  text.addLine("6. Acesta este un text extrem de lung care nu incape pe ecran");
+
+  MenuListView menu(display);
+  menu.setMenu({
+      MenuBuilder::createItem("Start", noAction),
+      MenuBuilder::createMenu("Settings", {MenuBuilder::createItem("Brightness", noAction),
+                                           MenuBuilder::createItem("Sleep timeout", noAction)}),
+      MenuBuilder::createItem("A very long menu label that needs scrolling", noAction),
+      MenuBuilder::createItem("About", noAction),
+      MenuBuilder::createItem("Exit", noAction),
+  });
+
+  FormView form(display);
+  form.addElement(std::make_shared<TextInputElement>("Username"));
+  form.addElement(std::make_shared<CheckBoxElement>("Asddasd sdf"));
+  form.addElement(std::make_shared<ListElement>("Color", std::vector<String>{"Red", "Green", "Blue", "Yellow Green"}));
+  form.addElement(std::make_shared<ButtonElement>("Save", [](String) {}));
+
+  StatusBar status(display);
+  auto battery = std::make_shared<StatusBattery>();
+  battery->setLevel(64);
+  auto clock = std::make_shared<StatusTime>();
+  clock->setTime(12, 34);
+  status.addLeftElement(clock);
+  status.addRightElement(battery);
+
+  printf("%-12s %9s %9s\n", "view", "virtual", "static");
+  benchmark(display, "text", text, outputDir, iterations);
+  benchmark(display, "menu", menu, outputDir, iterations);
+  benchmark(display, "form", form, outputDir, iterations);
+  benchmark(display, "statusbar", status, outputDir, iterations);
+
+#if defined(UI_PROFILING)
+  printf("\n");
+  Profiler::report(Serial);
+#endif
+  return 0;
+}
+#endif // PIO_UNIT_TESTING
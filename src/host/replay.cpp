@@ -0,0 +1,125 @@
+// Host replay tool (env:replay): rebuilds the frames of a screen recording
+// (segments copied off the device's SPIFFS partition, e.g. screen0.rec and
+// screen1.rec) and exports each one as a PNG, listing frames and input events
+// with their device time on stdout.
+//
+// Usage: program output-dir segment.rec [segment.rec ...]
+
+#include "../display/FrameBufferDisplay.h"
+#include "../record/ScreenPlayer.h"
+#include <algorithm>
+#include <memory>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+  struct Segment
+  {
+    std::string path;
+    std::vector<uint8_t> data;
+    record::Header header;
+  };
+
+  bool readFile(const char *path, std::vector<uint8_t> &data)
+  {
+    FILE *file = fopen(path, "rb");
+    if (!file)
+      return false;
+    uint8_t block[4096];
+    size_t n;
+    while ((n = fread(block, 1, sizeof(block), file)) > 0)
+      data.insert(data.end(), block, block + n);
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+  }
+
+  const char *actionName(ButtonAction action)
+  {
+    switch (action)
+    {
+    case SHORT_CLICK:
+      return "SHORT_CLICK";
+    case LONG_PRESS:
+      return "LONG_PRESS";
+    case DOUBLE_CLICK:
+      return "DOUBLE_CLICK";
+    case REPEAT:
+      return "REPEAT";
+    default:
+      return "NO_ACTION";
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 3)
+  {
+    fprintf(stderr, "usage: %s output-dir segment.rec [segment.rec ...]\n", argv[0]);
+    return 2;
+  }
+  std::string outputDir = argv[1];
+
+  std::vector<Segment> segments;
+  for (int i = 2; i < argc; i++)
+  {
+    Segment segment;
+    segment.path = argv[i];
+    if (!readFile(argv[i], segment.data))
+    {
+      fprintf(stderr, "%s: cannot read\n", argv[i]);
+      continue;
+    }
+    if (!ScreenPlayer::readHeader(segment.data.data(), segment.data.size(), segment.header))
+    {
+      fprintf(stderr, "%s: not a screen recording\n", argv[i]);
+      continue;
+    }
+    segments.push_back(std::move(segment));
+  }
+
+  // Oldest first, so the frames follow each other across the ring
+  std::sort(segments.begin(), segments.end(),
+            [](const Segment &a, const Segment &b) { return a.header.sequence < b.header.sequence; });
+
+  std::unique_ptr<FrameBufferDisplay> display;
+  unsigned long frameIndex = 0;
+  bool ok = true;
+
+  ScreenPlayer player;
+  player.onFrame([&](uint32_t timeMs, const uint8_t *frame) {
+    display->loadFrame(frame);
+    char name[32];
+    snprintf(name, sizeof(name), "/frame%05lu.png", frameIndex);
+    if (!display->savePNG((outputDir + name).c_str()))
+    {
+      fprintf(stderr, "%s%s: cannot write\n", outputDir.c_str(), name);
+      ok = false;
+    }
+    printf("%10lu ms  frame %05lu\n", (unsigned long)timeMs, frameIndex);
+    frameIndex++;
+  });
+  player.onEvent([](const RecordedEvent &event) {
+    printf("%10lu ms  %-12s %.*s (id %u, pin %u)\n", (unsigned long)event.timeMs, actionName(event.action),
+           event.nameLength, event.name, event.buttonId, event.buttonPin);
+  });
+
+  for (const Segment &segment : segments)
+  {
+    const record::Header &header = segment.header;
+    if (!display || display->getBufferSize() != header.width * header.pages)
+      display.reset(new FrameBufferDisplay(header.width, header.pages * 8));
+
+    printf("# %s: sequence %lu, %dx%d\n", segment.path.c_str(), (unsigned long)header.sequence,
+           header.width, header.pages * 8);
+    player.play(segment.data.data(), segment.data.size());
+    if (player.isTruncated())
+      printf("# %s: ends with an incomplete record\n", segment.path.c_str());
+  }
+
+  printf("# %lu frames, %lu events\n", player.getFramesPlayed(), player.getEventsPlayed());
+  return ok && !segments.empty() ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+// Host session runner (env:session): plays an input trace (InputTrace.h,
+// e.g. input.trc copied off the device's SPIFFS partition) through the same
+// buttons, views, scheduler and power governor as src/main.cpp, on a
+// ManualClock. The run is deterministic: the same trace always gives the same
+// events and frames, so the printed frame hash catches behaviour changes and
+// the render times catch performance regressions.
+//
+// Usage: program [-o output-dir] [-t tail-ms] trace.trc
+//
+// The clock jumps from one deadline (edge, gesture timer, animation step,
+// power stage) to the next and stops tail-ms (default 1000) after the last
+// edge. With -o every frame is saved as a PNG.
+
+#include "../display/FrameBufferDisplay.h"
+#include "../display/TextDisplay.h"
+#include "../platform/Clock.h"
+#include "../record/InputTrace.h"
+#include "../ui/FrameScheduler.h"
+#include "../ui/PowerGovernor.h"
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const ButtonConfig buttonConfig[] = {
+      {BUTTON_UP, 4, "UP"},
+      {BUTTON_DOWN, 5, "DOWN"},
+      {BUTTON_CENTER, 15, "CENTER"},
+      {BUTTON_RIGHT, 16, "RIGHT"},
+      {BUTTON_LEFT, 17, "LEFT"}};
+
+  bool readFile(const char *path, std::vector<uint8_t> &data)
+  {
+    FILE *file = fopen(path, "rb");
+    if (!file)
+      return false;
+    uint8_t block[4096];
+    size_t n;
+    while ((n = fread(block, 1, sizeof(block), file)) > 0)
+      data.insert(data.end(), block, block + n);
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+  }
+
+  const char *actionName(ButtonAction action)
+  {
+    switch (action)
+    {
+    case SHORT_CLICK:
+      return "SHORT_CLICK";
+    case LONG_PRESS:
+      return "LONG_PRESS";
+    case DOUBLE_CLICK:
+      return "DOUBLE_CLICK";
+    case REPEAT:
+      return "REPEAT";
+    default:
+      return "NO_ACTION";
+    }
+  }
+
+  // FNV-1a, chained over every frame of the run
+  uint32_t hash(uint32_t h, const uint8_t *data, size_t size)
+  {
+    for (size_t i = 0; i < size; i++)
+      h = (h ^ data[i]) * 16777619u;
+    return h;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  std::string outputDir;
+  unsigned long tail = 1000;
+  const char *tracePath = nullptr;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      outputDir = argv[++i];
+    else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+      tail = strtoul(argv[++i], nullptr, 10);
+    else if (!tracePath)
+      tracePath = argv[i];
+    else
+    {
+      tracePath = nullptr;
+      break;
+    }
+  }
+  if (!tracePath)
+  {
+    fprintf(stderr, "usage: %s [-o output-dir] [-t tail-ms] trace.trc\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<uint8_t> data;
+  InputTracePlayer player;
+  if (!readFile(tracePath, data) || !player.load(data.data(), data.size()))
+  {
+    fprintf(stderr, "%s: not an input trace\n", tracePath);
+    return 1;
+  }
+
+  ManualClock clock(player.getStartMs());
+  Clock::install(&clock);
+  InputSource::install(&player);
+
+  // The UI of src/main.cpp
+  FrameBufferDisplay display(128, 64);
+  ButtonManager buttons(buttonConfig);
+  TextDisplay text(display);
+  FrameScheduler scheduler;
+  PowerGovernor governor(display, scheduler, 30000, 120000);
+
+  buttons.setRepeat(BUTTON_UP);
+  buttons.setRepeat(BUTTON_DOWN);
+  buttons.setGestures(text);
+  buttons.begin(true); // Edges come from the trace only
+
+  text.addLine("1. Acesta este un text extrem de lung care nu încape pe ecran");
+  text.addLine("2. Linie medie de text");
+  text.addLine("3. Scurtă");
+  text.addLine("4. Alt exemplu de text lung pentru demonstratie");
+  text.addLine("5. Ultimul element din listă");
+  text.addLine("6. Acesta este un text extrem de lung care nu încape pe ecran");
+  text.addLine("7. Linie medie de text");
+  text.addLine("8. Scurtă");
+  text.addLine("9. Alt exemplu de text lung pentru demonstratie");
+  text.addLine("10. Ultimul element din listă");
+  text.setRetained(true);
+  scheduler.addWidget(text);
+
+  unsigned long events = 0;
+  unsigned long frames = 0;
+  double renderUs = 0;
+  double worstUs = 0;
+  uint32_t frameHash = 2166136261u;
+  unsigned long stopAt = Widget::NO_DEADLINE;
+
+  while (true)
+  {
+    const unsigned long now = clock.millis();
+    player.feed(buttons, now);
+    buttons.update();
+    governor.update(buttons.isActive(), now);
+    buttons.drainEvents([&](const ButtonEvent &event) {
+      if (!governor.accept(event, now))
+        return;
+      printf("%10lu ms  %-12s %s\n", now, actionName(event.action), buttons.name(event.buttonId));
+      text.handleInput(event);
+      buttons.setGestures(text);
+      events++;
+    });
+
+    if (scheduler.frameDue(now))
+    {
+      auto start = std::chrono::steady_clock::now();
+      text.draw(display);
+      display.display();
+      double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+      scheduler.frameDrawn();
+
+      renderUs += us;
+      worstUs = std::max(worstUs, us);
+      frameHash = hash(frameHash, display.getBuffer(), display.getBufferSize());
+      if (!outputDir.empty())
+      {
+        char name[32];
+        snprintf(name, sizeof(name), "/session%05lu.png", frames);
+        if (!display.savePNG((outputDir + name).c_str()))
+          fprintf(stderr, "%s%s: cannot write\n", outputDir.c_str(), name);
+      }
+      frames++;
+    }
+
+    if (player.finished() && stopAt == Widget::NO_DEADLINE)
+      stopAt = now + tail;
+
+    // Jump to whatever happens next
+    unsigned long next = player.nextTime();
+    for (unsigned long deadline : {buttons.nextDeadline(), governor.nextDeadline(), scheduler.nextDeadline(now), stopAt})
+      next = Widget::earliest(next, deadline);
+    if (Widget::isDue(stopAt, now) || next == Widget::NO_DEADLINE)
+      break;
+    clock.set(static_cast<long>(next - now) > 0 ? next : now + 1);
+  }
+
+  Clock::install(nullptr);
+  InputSource::install(nullptr);
+
+  printf("%lu edges%s, %lu events, %lu frames, hash %08x\n", player.getEdgesPlayed(),
+         player.isTruncated() ? " (trace truncated)" : "", events, frames, frameHash);
+  printf("render %.2f us/frame, worst %.2f us\n", frames ? renderUs / frames : 0.0, worstUs);
+  return 0;
+}
@@ -0,0 +1,131 @@
+// Host viewer of the live screen mirror (env:viewer): reads the device's
+// serial port, shows every frame streamed by FrameMirror in the terminal and
+// passes the device's text output through to stderr.
+//
+// Usage: program [-o output-dir] [device]
+//
+// 'device' is the CDC port (e.g. /dev/ttyACM0) or any tty/pty standing in for
+// it; without one the stream is read from stdin, in which case the viewer
+// cannot send the 'm' that starts it. With -o every frame is also saved as a PNG.
+
+#include "../display/FrameBufferDisplay.h"
+#include "../record/MirrorReceiver.h"
+#include <fcntl.h>
+#include <memory>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <termios.h>
+#include <unistd.h>
+
+namespace
+{
+  volatile sig_atomic_t interrupted = 0;
+
+  // Draws a frame with half blocks, two pixel rows per line
+  void render(const uint8_t *frame, int width, int pages)
+  {
+    std::string out = "\x1b[H";
+    for (int y = 0; y < pages * 8; y += 2)
+    {
+      for (int x = 0; x < width; x++)
+      {
+        const uint8_t column = frame[(y / 8) * width + x];
+        const bool top = column & (1 << (y & 7));
+        const bool bottom = column & (1 << ((y + 1) & 7));
+        out += top ? (bottom ? "█" : "▀") : (bottom ? "▄" : " ");
+      }
+      out += "\x1b[K\n";
+    }
+    fwrite(out.data(), 1, out.size(), stdout);
+    fflush(stdout);
+  }
+
+  bool sendCommand(int fd, char command)
+  {
+    return fd >= 0 && write(fd, &command, 1) == 1;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  std::string outputDir;
+  const char *device = nullptr;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      outputDir = argv[++i];
+    else if (!device)
+      device = argv[i];
+    else
+    {
+      fprintf(stderr, "usage: %s [-o output-dir] [device]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  int fd = STDIN_FILENO;
+  int commandFd = -1;
+  if (device)
+  {
+    fd = open(device, O_RDWR | O_NOCTTY);
+    if (fd < 0)
+    {
+      perror(device);
+      return 1;
+    }
+    commandFd = fd;
+  }
+
+  termios saved;
+  const bool tty = isatty(fd) && tcgetattr(fd, &saved) == 0;
+  if (tty)
+  {
+    termios raw = saved;
+    cfmakeraw(&raw);
+    tcsetattr(fd, TCSANOW, &raw);
+  }
+
+  std::unique_ptr<FrameBufferDisplay> display;
+  unsigned long frameIndex = 0;
+
+  MirrorReceiver receiver;
+  receiver.onText([](char c) { fputc(c, stderr); });
+  receiver.onFrame([&](const uint8_t *frame, int width, int pages) {
+    render(frame, width, pages);
+    if (outputDir.empty())
+      return;
+    if (!display || display->getBufferSize() != width * pages)
+      display.reset(new FrameBufferDisplay(width, pages * 8));
+    display->loadFrame(frame);
+    char name[32];
+    snprintf(name, sizeof(name), "/mirror%05lu.png", frameIndex++);
+    if (!display->savePNG((outputDir + name).c_str()))
+      fprintf(stderr, "%s%s: cannot write\n", outputDir.c_str(), name);
+  });
+
+  // Ctrl-C ends the read below instead of the process, so the port is restored
+  struct sigaction action = {};
+  action.sa_handler = [](int) { interrupted = 1; };
+  sigaction(SIGINT, &action, nullptr);
+
+  printf("\x1b[2J");
+  sendCommand(commandFd, mirror::COMMAND_START);
+
+  uint8_t buffer[512];
+  ssize_t n;
+  while (!interrupted && (n = read(fd, buffer, sizeof(buffer))) > 0)
+  {
+    const unsigned long lost = receiver.getPacketsLost();
+    receiver.feed(buffer, n);
+    if (receiver.getPacketsLost() != lost && receiver.needsKeyframe())
+      sendCommand(commandFd, mirror::COMMAND_START); // Lost a packet; ask for a keyframe
+  }
+
+  sendCommand(commandFd, mirror::COMMAND_STOP);
+  if (tty)
+    tcsetattr(fd, TCSANOW, &saved);
+  fprintf(stderr, "\n%lu frames, %lu packets lost\n", receiver.getFramesReceived(), receiver.getPacketsLost());
+  return 0;
+}
@@ -5,39 +5,70 @@
 #include "form/CheckBoxElement.h"
 #include "form/ListElement.h"
 #include "form/ButtonElement.h"
+#include <algorithm>
 #include <memory>
 #include <Wire.h>
 #include <map>
 #include <string>
 
 #include "display/TextDisplay.h"
+#include "ui/FrameScheduler.h"
+#include "ui/PowerGovernor.h"
+#include "platform/Profiler.h"
+#include "record/ScreenRecorder.h"
+#include "record/FrameMirror.h"
+#include "record/InputTrace.h"
+#include <SPIFFS.h>
 
-std::map<String, uint8_t> buttonConfig = {
-    {"UP", 4},
-    {"DOWN", 5},
-    {"CENTER", 15},
-    {"RIGHT", 16},
-    {"LEFT", 17}};
+const ButtonConfig buttonConfig[] = {
+    {BUTTON_UP, 4, "UP"},
+    {BUTTON_DOWN, 5, "DOWN"},
+    {BUTTON_CENTER, 15, "CENTER"},
+    {BUTTON_RIGHT, 16, "RIGHT"},
+    {BUTTON_LEFT, 17, "LEFT"}};
 
 ButtonManager btnManager(buttonConfig);
 
 DisplaySH1106G oled(128, 64, -1);
 FormView formW(oled);
+TextDisplay tdisplay(oled);
+FrameScheduler scheduler;
+PowerGovernor governor(oled, scheduler, 30000, 120000); // Dim after 30 s idle, panel off after 2 min
+ScreenRecorder recorder(128, 64); // Flight log of the panel on the spiffs partition
+FrameMirror mirror(Serial, 128, 64); // Live copy of the panel for src/host/viewer.cpp
+InputTraceRecorder inputTrace;       // Button edges for src/host/session.cpp (-DINPUT_TRACE)
+
 void saveAction(String label)
 {
-  Serial.println("Pressed: " + label);
+  if (!mirror.isEnabled()) // Text would corrupt the mirror's packets
+    Serial.println("Pressed: " + label);
 }
 
-TextDisplay tdisplay(oled);
-
 void setup()
 {
+  Serial.setTxBufferSize(2048); // Room for a whole mirror keyframe
   Serial.begin(115200);
   delay(2000);
   Wire.begin(8, 9);
 
-  btnManager.begin();
+  // Button edges are timestamped in the GPIO interrupt and wake the loop, so
+  // it only has to poll as a safety net
+  btnManager.setEdgeHook([](void *) { scheduler.wakeFromISR(); }, nullptr);
+  btnManager.setRepeat(BUTTON_UP); // Hold to scroll menus, lists and text
+  btnManager.setRepeat(BUTTON_DOWN);
+  btnManager.setGestures(tdisplay); // Clicks without a double click are reported on release
+  btnManager.begin(true);
+  scheduler.setPollInterval(1000);
+  scheduler.setSuspendedPollInterval(1000);
   oled.begin();
+  oled.setDoubleBuffered(true); // Flush on core 0 while the loop renders on core 1
+
+  if (!SPIFFS.begin(true) || !recorder.begin())
+    Serial.println("Screen recorder disabled");
+#if defined(INPUT_TRACE)
+  if (inputTrace.begin())
+    btnManager.setEdgeTrace(InputTraceRecorder::onEdge, &inputTrace);
+#endif
 
   // oled.setRotation(1);
 
@@ -63,20 +94,56 @@ void setup()
   tdisplay.addLine("8. Scurtă");
   tdisplay.addLine("9. Alt exemplu de text lung pentru demonstratie");
   tdisplay.addLine("10. Ultimul element din listă");
+
+  tdisplay.setRetained(true); // Repaint only changed rows; the frame is never cleared
+  scheduler.addWidget(tdisplay);
 }
 
 void loop()
 {
   btnManager.update();
-  oled.clearDisplay();
-  tdisplay.draw();
-  oled.display();
+  governor.update(btnManager.isActive(), millis());
 
-  ButtonEvent event = btnManager.getAction();
+  // Every event since the last pass, in order, even after a slow frame
+  btnManager.drainEvents([](const ButtonEvent &event) {
+    recorder.recordEvent(event, btnManager.name(event.buttonId), millis());
+    if (!governor.accept(event, millis()))
+      return; // The press that woke the panel
 
-  if (event.action != NO_ACTION)
-  {
-    Serial.println(event.buttonName);
     tdisplay.handleInput(event);
+    btnManager.setGestures(tdisplay); // The view may have changed mode
+  });
+
+  // Render only when a widget changed or an animation step is due (never
+  // while the governor has the panel asleep)
+  if (scheduler.frameDue(millis()))
+  {
+    PROFILE_SCOPE("frame");
+    tdisplay.draw(oled); // Primitives bound to DisplaySH1106G at compile time
+    oled.display();
+    recorder.recordFrame(oled.getDisplay().getBuffer(), millis());
+    mirror.submit(oled.getDisplay().getBuffer());
+    scheduler.frameDrawn();
+  }
+
+  // Commands from the host: 'm' / 'M' start and stop the screen mirror,
+  // 'p' prints the frame timing report
+  while (Serial.available())
+  {
+    int c = Serial.read();
+    if (mirror.handleCommand(c))
+      continue;
+#if defined(UI_PROFILING)
+    if (c == 'p')
+      Profiler::report(Serial);
+#endif
   }
+  mirror.poll(); // Rest of a frame the port could not take at once
+  recorder.service(!btnManager.isActive()); // Commit the events of a gesture once it is over
+#if defined(INPUT_TRACE)
+  inputTrace.service(!btnManager.isActive()); // Batched SPIFFS writes, between gestures
+#endif
+
+  // Sleep until the next deadline or input poll
+  scheduler.waitForWork(millis(), Widget::earliest(btnManager.nextDeadline(), governor.nextDeadline()));
 }
@@ -1,6 +1,7 @@
 #ifndef MENU_ITEM_H
 #define MENU_ITEM_H
 
+#include "../display/GlyphString.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -12,13 +13,14 @@ using MenuAction = void(*)();
 class MenuItem {
 private:
     std::string label;  // The label text displayed for this menu item
+    GlyphString glyphs; // The label decoded for drawing
     MenuAction action = nullptr;  // Optional action to execute when item is selected
     std::vector<std::shared_ptr<MenuItem>> submenu;  // Optional submenu items
 
 public:
     // Constructor with label and optional action
     MenuItem(const std::string& label, MenuAction action = nullptr)
-        : label(label), action(action) {}
+        : label(label), glyphs(label.c_str()), action(action) {}
 
     virtual ~MenuItem() = default;
 
@@ -27,6 +29,11 @@ public:
         return label;
     }
 
+    // Returns the label as glyphs of the built-in font (one per character)
+    const GlyphString& getGlyphs() const {
+        return glyphs;
+    }
+
     // Sets the submenu items for this menu item
     void setSubmenu(const std::vector<std::shared_ptr<MenuItem>>& items) {
         submenu = items;
@@ -1,167 +1,149 @@
 #include "MenuListView.h"
+#include "../platform/Clock.h"
 
-// Draws the menu and scroll indicator
-void MenuListView::draw()
+// Restarts the label marquee when the selection changed, then advances it
+void MenuListView::updateMarquee()
 {
-  drawMenu();
-  drawScrollIndicator();
-}
-
-// Draws the visible portion of the menu
-void MenuListView::drawMenu()
-{
-  const int visibleElements = menuListViewHeight / lineHeight;
-  const unsigned long pauseDuration = 1500; // ms pause at text edges
-  const int scrollBarWidth = charWidth;
-  const int prefixWidth = selectedPrefix.length() * charWidth;
-  const int paddingRight = 1;
-
-  const int maxCharsThatFit = (menuListViewWidth - paddingRight) / charWidth;
-  const int availableWidth = maxCharsThatFit * charWidth;
-
-  if (visibleElements <= 0)
+  if (selectedIndex < 0 || static_cast<size_t>(selectedIndex) >= currentMenu.size())
     return;
 
-  int x = offsetX;
-  int y = offsetY;
-
-  display.setTextWrap(false);
-  display.setTextColor(1);
-
-  for (int i = 0; i < visibleElements; i++)
+  // Reset scroll if a new item is selected
+  if (selectedIndex != lastSelectedIndex)
   {
-    int idx = i + scrollOffset;
-    if (idx >= currentMenu.size())
-      break;
+    labelScrollOffset = 0;
+    scrollingRight = false;
+    isPausing = false;
+    lastScrollUpdate = Clock::now();
+    lastSelectedIndex = selectedIndex;
+  }
 
-    const std::string &label = currentMenu[idx]->getLabel();
-    int textX = x;
-    int textY = y + i * lineHeight;
+  const int marqueeRange = labelLayouts[selectedIndex].marqueeRange;
+  if (marqueeRange == 0)
+    return;
 
-    bool isSelected = (idx == selectedIndex);
+  unsigned long now = Clock::now();
 
-    if (isSelected)
+  // Handle scrolling pause at the start/end
+  if (isPausing)
+  {
+    if (now - lastScrollUpdate >= pauseDuration)
     {
-      // Draw selection prefix (e.g. "> ")
-      display.setCursor(textX, textY);
-      display.print(selectedPrefix.c_str());
-      textX += prefixWidth;
-
-      int labelPixelWidth = label.length() * charWidth;
-      int textAvailableWidth = menuListViewWidth - prefixWidth - scrollBarWidth - paddingRight;
-
-      // Reset scroll if a new item is selected
-      if (idx != lastSelectedIndex)
+      isPausing = false;
+      lastScrollUpdate = now;
+    }
+  }
+  else if (now - lastScrollUpdate >= static_cast<unsigned long>(scrollSpeed))
+  {
+    // Scroll label left or right
+    if (scrollingRight)
+    {
+      labelScrollOffset = std::max(0, labelScrollOffset - scrollStep);
+      if (labelScrollOffset == 0)
       {
-        labelScrollOffset = 0;
+        isPausing = true;
         scrollingRight = false;
-        isPausing = false;
-        lastScrollUpdate = millis();
-        lastSelectedIndex = idx;
-      }
-
-      if (labelPixelWidth > textAvailableWidth)
-      {
-        unsigned long now = millis();
-
-        // Handle scrolling pause at the start/end
-        if (isPausing)
-        {
-          if (now - lastScrollUpdate >= pauseDuration)
-          {
-            isPausing = false;
-            lastScrollUpdate = now;
-          }
-        }
-        else if (now - lastScrollUpdate >= scrollSpeed)
-        {
-          // Scroll label left or right
-          if (scrollingRight)
-          {
-            labelScrollOffset = std::max(0, labelScrollOffset - scrollStep);
-            if (labelScrollOffset == 0)
-            {
-              isPausing = true;
-              scrollingRight = false;
-            }
-          }
-          else
-          {
-            labelScrollOffset = std::min(labelPixelWidth - textAvailableWidth, labelScrollOffset + scrollStep);
-            if (labelScrollOffset >= labelPixelWidth - textAvailableWidth)
-            {
-              isPausing = true;
-              scrollingRight = true;
-            }
-          }
-          lastScrollUpdate = now;
-        }
-
-        // Calculate and render visible portion of the label
-        int startChar = labelScrollOffset / charWidth;
-        int remainingWidth = textAvailableWidth;
-        std::string visibleText;
-
-        for (int j = startChar; j < label.length() && remainingWidth > 0; j++)
-        {
-          visibleText += label[j];
-          remainingWidth -= charWidth;
-        }
-
-        display.setCursor(textX, textY);
-        display.print(visibleText.c_str());
-      }
-      else
-      {
-        // Label fits fully
-        display.setCursor(textX, textY);
-        display.print(label.c_str());
       }
     }
     else
     {
-      // Non-selected item
-      display.setCursor(textX, textY);
-      if (label.length() > maxCharsThatFit)
-      {
-        std::string clipped = label.substr(0, maxCharsThatFit - 2) + "..";
-        display.print(clipped.c_str());
-      }
-      else
+      labelScrollOffset = std::min(marqueeRange, labelScrollOffset + scrollStep);
+      if (labelScrollOffset >= marqueeRange)
       {
-        display.print(label.c_str());
+        isPausing = true;
+        scrollingRight = true;
       }
     }
+    lastScrollUpdate = now;
+  }
+}
+
+// What a row shows; rows are repainted in retained mode when this changes
+MenuListView::RowState MenuListView::getRowState(int row) const
+{
+  RowState state;
+  int idx = row + scrollOffset;
+  if (static_cast<size_t>(idx) < currentMenu.size())
+  {
+    state.item = currentMenu[idx].get();
+    state.selected = idx == selectedIndex;
+    state.firstChar = state.selected ? labelScrollOffset / charWidth : 0;
   }
+  return state;
 }
 
-// Renders the scroll indicator on the right side of the display
-void MenuListView::drawScrollIndicator() const
+// Area of a menu row, across the full width of the view
+Rect MenuListView::getRowRect(int row) const
+{
+  return Rect(offsetX, offsetY + row * lineHeight, menuListViewWidth, lineHeight);
+}
+
+// Rows plus the scroll bar, which may reach past the rows
+Rect MenuListView::getViewBounds() const
 {
   int barX = menuListViewWidth - 2;
-  int totalItems = currentMenu.size();
   int barHeight = menuListViewHeight - offsetY + charWidth;
+  Rect rows(offsetX, offsetY, menuListViewWidth, menuListViewHeight);
+  return rows.united(Rect(barX - 1, offsetY - 1, 3, barHeight + 2));
+}
 
-  // Draw dotted vertical scrollbar
-  for (int y = 0; y < barHeight; y++)
-  {
-    int pixelY = y + offsetY;
-    if (y % 2 == 0)
-    {
-      display.drawPixel(barX, pixelY, 1);
-    }
-  }
+// 3x3 scroll position marker; empty if there is no position to show
+Rect MenuListView::getScrollMarker() const
+{
+  int totalItems = currentMenu.size();
+  if (totalItems == 1)
+    return Rect(); // The marker position is undefined for a single item
 
-  // Draw scroll position marker
+  int barX = menuListViewWidth - 2;
+  int barHeight = menuListViewHeight - offsetY + charWidth;
   float percent = selectedIndex / (float)(totalItems - 1);
   int centerY = offsetY + static_cast<int>(percent * (barHeight - 1));
+  return Rect(barX - 1, centerY - 1, 3, 3);
+}
+
+// Width available to the selected label
+int MenuListView::getLabelAvailableWidth() const
+{
+  const int scrollBarWidth = charWidth;
+  const int paddingRight = 1;
+  return menuListViewWidth - prefixGlyphs.length() * charWidth - scrollBarWidth - paddingRight;
+}
 
-  for (int dy = -1; dy <= 1; dy++)
+// Measures every label once, so drawing a frame only looks the results up
+void MenuListView::updateLabelLayouts()
+{
+  const int paddingRight = 1;
+  const int maxCharsThatFit = (menuListViewWidth - paddingRight) / charWidth;
+  const int textAvailableWidth = getLabelAvailableWidth();
+
+  // Every character that starts inside the available width
+  marqueeChars = std::max(0, (textAvailableWidth + charWidth - 1) / charWidth);
+
+  labelLayouts.resize(currentMenu.size());
+  for (size_t i = 0; i < currentMenu.size(); i++)
   {
-    display.drawPixel(barX - 1, centerY + dy, 1);
-    display.drawPixel(barX, centerY + dy, 1);
-    display.drawPixel(barX + 1, centerY + dy, 1);
+    const int length = currentMenu[i]->getGlyphs().length();
+    LabelLayout &layout = labelLayouts[i];
+
+    layout.width = length * charWidth;
+    layout.ellipsized = length > maxCharsThatFit;
+    layout.clippedLength = layout.ellipsized ? std::max(maxCharsThatFit - 2, 0) : length;
+    layout.marqueeRange = std::max(layout.width - textAvailableWidth, 0);
   }
+
+  // Offsets of the previous layout do not apply any more
+  lastSelectedIndex = -1;
+}
+
+// The only animation is the marquee of a selected label that does not fit
+unsigned long MenuListView::nextDeadline(unsigned long /*now*/) const
+{
+  if (selectedIndex < 0 || static_cast<size_t>(selectedIndex) >= currentMenu.size() || selectedIndex != lastSelectedIndex)
+    return NO_DEADLINE; // A new selection invalidates the view anyway
+
+  if (labelLayouts[selectedIndex].marqueeRange == 0)
+    return NO_DEADLINE;
+
+  return lastScrollUpdate + (isPausing ? pauseDuration : scrollSpeed);
 }
 
 // Sets the current menu and clears submenu history
@@ -171,6 +153,8 @@ void MenuListView::setMenu(const std::vector<std::shared_ptr<MenuItem>> &menu)
   selectedIndex = scrollOffset = 0;
   while (!menuHistory.empty())
     menuHistory.pop();
+  updateLabelLayouts();
+  invalidate();
 }
 
 // Moves selection up by one item
@@ -181,6 +165,7 @@ void MenuListView::moveSelectionUp()
     selectedIndex--;
     if (selectedIndex < scrollOffset)
       scrollOffset--;
+    invalidate();
   }
 }
 
@@ -188,18 +173,19 @@ void MenuListView::moveSelectionUp()
 void MenuListView::moveSelectionDown()
 {
   int visibleElements = menuListViewHeight / lineHeight;
-  if (selectedIndex < currentMenu.size() - 1)
+  if (static_cast<size_t>(selectedIndex) < currentMenu.size() - 1)
   {
     selectedIndex++;
     if (selectedIndex >= scrollOffset + visibleElements)
       scrollOffset++;
+    invalidate();
   }
 }
 
 // Enters submenu
 void MenuListView::enterSubmenu()
 {
-  if (selectedIndex >= 0 && selectedIndex < currentMenu.size())
+  if (selectedIndex >= 0 && static_cast<size_t>(selectedIndex) < currentMenu.size())
   {
     auto selected = currentMenu[selectedIndex];
     if (selected && selected->hasSubmenu())
@@ -207,18 +193,21 @@ void MenuListView::enterSubmenu()
       menuHistory.push(currentMenu);
       currentMenu = selected->getSubmenu();
       selectedIndex = scrollOffset = 0;
+      updateLabelLayouts();
+      invalidate();
     }
   }
 }
 
 void MenuListView::activateSelectedItem()
 {
-  if (selectedIndex >= 0 && selectedIndex < currentMenu.size())
+  if (selectedIndex >= 0 && static_cast<size_t>(selectedIndex) < currentMenu.size())
   {
     auto selected = currentMenu[selectedIndex];
     if (selected && !selected->hasSubmenu())
     {
       selected->activate(); // Execute associated action
+      invalidate();         // The action may have changed what the menu shows
     }
   }
 }
@@ -231,6 +220,8 @@ void MenuListView::navigateBack()
     currentMenu = menuHistory.top();
     menuHistory.pop();
     selectedIndex = scrollOffset = 0;
+    updateLabelLayouts();
+    invalidate();
   }
 }
 
@@ -240,26 +231,36 @@ bool MenuListView::canGoBack() const
   return !menuHistory.empty();
 }
 
+// No double clicks: every click is handled as soon as the button is released
+uint8_t MenuListView::gestures(uint8_t buttonId) const
+{
+  if (buttonId == BUTTON_UP || buttonId == BUTTON_DOWN)
+    return GESTURE_CLICK | GESTURE_REPEAT;
+  if (buttonId == BUTTON_LEFT || buttonId == BUTTON_RIGHT || buttonId == BUTTON_CENTER)
+    return GESTURE_CLICK;
+  return 0;
+}
+
 void MenuListView::handleInput(ButtonEvent buttonEvent)
 {
 
-  if (buttonEvent.buttonName == "UP" && buttonEvent.action == ButtonAction::SHORT_CLICK)
+  if (buttonEvent.buttonId == BUTTON_UP && buttonEvent.isStep())
   {
     moveSelectionUp();
   }
-  else if (buttonEvent.buttonName == "DOWN" && buttonEvent.action == ButtonAction::SHORT_CLICK)
+  else if (buttonEvent.buttonId == BUTTON_DOWN && buttonEvent.isStep())
   {
     moveSelectionDown();
   }
-  else if (buttonEvent.buttonName == "RIGHT" && buttonEvent.action == ButtonAction::SHORT_CLICK)
+  else if (buttonEvent.buttonId == BUTTON_RIGHT && buttonEvent.action == ButtonAction::SHORT_CLICK)
   {
     enterSubmenu();
   }
-  else if (buttonEvent.buttonName == "LEFT" && buttonEvent.action == ButtonAction::SHORT_CLICK)
+  else if (buttonEvent.buttonId == BUTTON_LEFT && buttonEvent.action == ButtonAction::SHORT_CLICK)
   {
     navigateBack();
   }
-  else if (buttonEvent.buttonName == "CENTER" && buttonEvent.action == ButtonAction::SHORT_CLICK)
+  else if (buttonEvent.buttonId == BUTTON_CENTER && buttonEvent.action == ButtonAction::SHORT_CLICK)
   {
     activateSelectedItem();
   }
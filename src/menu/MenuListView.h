@@ -5,12 +5,15 @@
 #include "../button/ButtonManager.h"
 #include <Arduino.h>  // Arduino utility functions like millis()
 #include "MenuItem.h" // Menu item structure/class
+#include "../ui/Widget.h" // Invalidation and animation deadlines
+#include "../ui/DamageList.h" // Retained-mode repaint areas
+#include "../platform/Profiler.h" // Frame timing
 #include <vector>     // Used to hold lists of menu items
 #include <memory>     // For using shared_ptr with menu items
 #include <stack>      // For tracking menu navigation history
 
 // Class responsible for rendering and navigating a list of menu items
-class MenuListView
+class MenuListView : public Widget
 {
 private:
   DisplayInterface &display; // Reference to the display used for rendering
@@ -32,8 +35,10 @@ private:
   int scrollOffset = 0; // Vertical scroll offset (index of first visible item)
   int scrollSpeed = 80; // Time between each scroll step in ms
   int scrollStep = 1;   // Number of pixels to scroll each step
+  unsigned long pauseDuration = 1500; // ms pause at label edges
 
   std::string selectedPrefix = "> "; // Prefix shown before selected item
+  GlyphString prefixGlyphs{"> "};    // selectedPrefix decoded for drawing
 
   // State variables
   int selectedIndex = 0;              // Index of the currently selected item
@@ -43,6 +48,35 @@ private:
   int lastSelectedIndex = -1;         // Tracks the previously selected item index
   bool isPausing = false;             // Used to delay scroll when selection changes
 
+  // Layout of each label of currentMenu, rebuilt by updateLabelLayouts()
+  // when the menu, the view width or the prefix changes
+  struct LabelLayout
+  {
+    int width = 0;              // Label width in pixels
+    uint16_t clippedLength = 0; // Characters shown on an unselected row
+    bool ellipsized = false;    // Unselected row shows clippedLength characters and ".."
+    int marqueeRange = 0;       // Pixels the selected label scrolls by, 0 if it fits
+  };
+
+  std::vector<LabelLayout> labelLayouts; // One per item of currentMenu
+  int marqueeChars = 0;                  // Characters of a scrolling label drawn at once
+
+  // Retained mode: what a row showed when it was last drawn
+  struct RowState
+  {
+    const MenuItem *item = nullptr; // Item shown, nullptr for an empty row
+    bool selected = false;
+    int firstChar = 0; // First visible character of a scrolled label
+
+    bool operator!=(const RowState &other) const
+    {
+      return item != other.item || selected != other.selected || firstChar != other.firstChar;
+    }
+  };
+
+  std::vector<RowState> drawnRows; // Rows on screen, top to bottom
+  Rect drawnMarker;                // Scroll marker on screen
+
 public:
   // Constructor: requires reference to a display
   MenuListView(DisplayInterface &disp)
@@ -59,11 +93,13 @@ public:
   bool canGoBack() const;      // Returns true if history is not empty
 
   void handleInput(ButtonEvent buttonEvent);
+  uint8_t gestures(uint8_t buttonId) const; // Gestures handleInput() uses, for ButtonManager::setGestures()
 
   // Getters and setters for layout and behavior
   void setOffsetX(int xx)
   {
     offsetX = xx;
+    invalidate();
   }
   int getOffsetX() const
   {
@@ -73,6 +109,7 @@ public:
   void setOffsetY(int yy)
   {
     offsetY = yy;
+    invalidate();
   }
   int getOffsetY() const
   {
@@ -82,6 +119,7 @@ public:
   void setMenuListViewHeight(int height)
   {
     menuListViewHeight = height;
+    invalidate();
   }
   int getMenuListViewHeight() const
   {
@@ -91,6 +129,8 @@ public:
   void setMenuListViewWidth(int width)
   {
     menuListViewWidth = width;
+    updateLabelLayouts();
+    invalidate();
   }
   int getMenuListViewWidth() const
   {
@@ -109,6 +149,7 @@ public:
   void setScrollStep(int step)
   {
     scrollStep = step;
+    invalidate();
   }
   int getScrollStep() const
   {
@@ -118,6 +159,9 @@ public:
   void setSelectedPrefix(const std::string &prefix)
   {
     selectedPrefix = prefix;
+    prefixGlyphs.assign(prefix.c_str());
+    updateLabelLayouts();
+    invalidateLayout();
   }
   std::string getSelectedPrefix() const
   {
@@ -125,12 +169,161 @@ public:
   }
 
   // Main draw method that updates the display
-  void draw();
+  void draw() { draw(display); }
+
+  // Same, calling the primitives on the concrete display type (see
+  // DisplayInterface.h); 'target' must be the display given to the constructor
+  template <typename Display>
+  void draw(Display &target);
+
+  // Next marquee step of the selected label, if it is too long to fit
+  unsigned long nextDeadline(unsigned long now) const override;
 
 private:
+  int getLabelAvailableWidth() const; // Width left for the selected label after prefix and scroll bar
+  void updateLabelLayouts();          // Measures the labels of currentMenu
+
   // Helper methods for rendering
-  void drawMenu();                  // Draws visible menu items
-  void drawScrollIndicator() const; // Draws scroll bar indicator
+  void updateMarquee(); // Advances the scrolling of the selected label
+
+  template <typename Display>
+  void drawRow(Display &target, int row); // Draws one visible menu item
+  template <typename Display>
+  void drawScrollIndicator(Display &target) const; // Draws scroll bar indicator
+
+  RowState getRowState(int row) const;
+  Rect getRowRect(int row) const;
+  Rect getViewBounds() const;
+  Rect getScrollMarker() const;
 };
 
+// Draws the menu and scroll indicator.
+// In retained mode only rows whose item, selection or visible label part
+// changed are repainted (moving the selection repaints the old and the new
+// row), plus the scroll marker when it moved.
+template <typename Display>
+void MenuListView::draw(Display &target)
+{
+  PROFILE_SCOPE("MenuListView::draw");
+  const int visibleElements = std::max(menuListViewHeight / lineHeight, 0);
+
+  updateMarquee();
+
+  const Rect bounds = getViewBounds();
+  const Rect marker = getScrollMarker();
+  const bool full = needsFullRepaint(bounds);
+  DamageList damage;
+
+  if (full)
+  {
+    damage.add(getDrawnBounds());
+    damage.add(bounds);
+  }
+  else
+  {
+    for (int i = 0; i < visibleElements; i++)
+    {
+      if (static_cast<size_t>(i) >= drawnRows.size() || getRowState(i) != drawnRows[i])
+        damage.add(getRowRect(i));
+    }
+    if (marker != drawnMarker)
+    {
+      damage.add(drawnMarker);
+      damage.add(marker);
+    }
+  }
+
+  if (isRetained())
+    damage.erase(target);
+
+  // Long labels and the marquee stay inside the view, whatever is drawn around it
+  ScopedClip clip(target, bounds);
+
+  target.setTextWrap(false);
+  target.setTextColor(1);
+
+  for (int i = 0; i < visibleElements; i++)
+  {
+    if (static_cast<size_t>(i + scrollOffset) >= currentMenu.size())
+      break;
+    const Rect row = getRowRect(i);
+    if ((full || damage.intersects(row)) && target.isVisible(row))
+      drawRow(target, i);
+  }
+
+  if (!damage.isEmpty())
+    drawScrollIndicator(target);
+
+  drawnRows.resize(visibleElements);
+  for (int i = 0; i < visibleElements; i++)
+    drawnRows[i] = getRowState(i);
+  drawnMarker = marker;
+  setDrawnBounds(bounds);
+}
+
+// Draws one visible menu row from the cached label layout
+template <typename Display>
+void MenuListView::drawRow(Display &target, int row)
+{
+  const int idx = row + scrollOffset;
+  const GlyphString &label = currentMenu[idx]->getGlyphs();
+  const LabelLayout &layout = labelLayouts[idx];
+  int textX = offsetX;
+  int textY = offsetY + row * lineHeight;
+
+  if (idx == selectedIndex)
+  {
+    // Draw selection prefix (e.g. "> ")
+    target.setCursor(textX, textY);
+    target.printGlyphs(prefixGlyphs);
+    textX += prefixGlyphs.length() * charWidth;
+
+    target.setCursor(textX, textY);
+    if (layout.marqueeRange > 0)
+    {
+      // Render the visible portion of the label
+      int startChar = labelScrollOffset / charWidth;
+      int count = std::min<int>(label.length() - startChar, marqueeChars);
+      if (count > 0)
+        target.printGlyphs(label.data() + startChar, count);
+    }
+    else
+    {
+      // Label fits fully
+      target.printGlyphs(label);
+    }
+  }
+  else
+  {
+    // Non-selected item
+    target.setCursor(textX, textY);
+    target.printGlyphs(label.data(), layout.clippedLength);
+    if (layout.ellipsized)
+      target.print("..");
+  }
+}
+
+// Renders the scroll indicator on the right side of the display
+template <typename Display>
+void MenuListView::drawScrollIndicator(Display &target) const
+{
+  int barX = menuListViewWidth - 2;
+  int barHeight = menuListViewHeight - offsetY + charWidth;
+
+  // One column of alternating pixels, 64 rows tall
+  static const uint8_t DOTTED_TRACK[8] = {0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55};
+  static const Bitmap track = {DOTTED_TRACK, 1, 64};
+
+  // Draw dotted vertical scrollbar
+  for (int y = 0; y < barHeight; y += track.height)
+  {
+    target.drawBitmap(barX, offsetY + y, track, 0, 0, 1, std::min<int>(track.height, barHeight - y), RasterOp::OR);
+  }
+
+  // Draw scroll position marker
+  Rect marker = getScrollMarker();
+  if (!marker.isEmpty())
+    target.fillRect(marker.x, marker.y, marker.w, marker.h, 1);
+}
+
 #endif // MENU_LIST_VIEW_H
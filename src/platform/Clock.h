@@ -0,0 +1,48 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+// Time source of the UI modules. They call Clock::now() instead of millis(),
+// so a host run can install a ManualClock and drive every timer, animation
+// and gesture from a trace instead of the wall clock. Without an installed
+// clock Clock::now() is the hardware millis().
+//
+// The GPIO interrupt handlers keep using millis(): they only run on the
+// device, where the installed clock is the hardware one.
+
+#include <Arduino.h>
+
+class Clock
+{
+public:
+  virtual ~Clock() = default;
+
+  // Milliseconds since an arbitrary start, wrapping like millis()
+  virtual unsigned long millis() const = 0;
+
+  // Time of the installed clock
+  static unsigned long now() { return current ? current->millis() : ::millis(); }
+
+  // Makes 'clock' the time source of every module; nullptr restores millis()
+  static void install(const Clock *clock) { current = clock; }
+  static const Clock *installed() { return current; }
+
+private:
+  static inline const Clock *current = nullptr;
+};
+
+// Clock that only moves when told to (deterministic host runs)
+class ManualClock : public Clock
+{
+public:
+  explicit ManualClock(unsigned long start = 0) : time(start) {}
+
+  unsigned long millis() const override { return time; }
+
+  void set(unsigned long ms) { time = ms; }
+  void advance(unsigned long ms) { time += ms; }
+
+private:
+  unsigned long time;
+};
+
+#endif // CLOCK_H
@@ -0,0 +1,30 @@
+#ifndef INPUT_SOURCE_H
+#define INPUT_SOURCE_H
+
+// Level source of the button pins. ButtonManager samples the pins through
+// InputSource::read() instead of digitalRead(), so a host run can install a
+// source that replays a trace (see InputTrace.h). Without an installed source
+// read() is the hardware digitalRead().
+
+#include <Arduino.h>
+
+class InputSource
+{
+public:
+  virtual ~InputSource() = default;
+
+  // Level of 'pin' (LOW = pressed for the active-low buttons)
+  virtual int readLevel(uint8_t pin) = 0;
+
+  // Level from the installed source
+  static int read(uint8_t pin) { return current ? current->readLevel(pin) : digitalRead(pin); }
+
+  // Makes 'source' the pin source of every module; nullptr restores digitalRead()
+  static void install(InputSource *source) { current = source; }
+  static InputSource *installed() { return current; }
+
+private:
+  static inline InputSource *current = nullptr;
+};
+
+#endif // INPUT_SOURCE_H
@@ -0,0 +1,82 @@
+#include "Profiler.h"
+
+#if defined(UI_PROFILING)
+
+#include <algorithm>
+#include <atomic>
+#include <string.h>
+
+namespace
+{
+  ProfileSlot slots[Profiler::MAX_SLOTS];
+  std::atomic<uint8_t> slotCount{0}; // Slots handed out, named or about to be
+  ProfileSlot otherSlot;
+
+  uint8_t usedSlots()
+  {
+    return std::min<uint8_t>(slotCount.load(), Profiler::MAX_SLOTS);
+  }
+
+  void printSlot(Print &out, const ProfileSlot &slot)
+  {
+    // Copy the window first so that the figures come from one consistent set
+    uint32_t window[ProfileSlot::WINDOW];
+    uint16_t n = std::min<uint32_t>(slot.count, ProfileSlot::WINDOW);
+    if (n == 0)
+      return;
+    memcpy(window, slot.samples, n * sizeof(uint32_t));
+    std::sort(window, window + n);
+
+    uint64_t total = 0;
+    for (uint16_t i = 0; i < n; i++)
+      total += window[i];
+    uint16_t p99 = (n * 99 + 99) / 100 - 1;
+
+    out.printf("%-34s %8lu %7lu %7lu %7lu %7lu\r\n", slot.name, (unsigned long)slot.count,
+               (unsigned long)window[0], (unsigned long)(total / n),
+               (unsigned long)window[p99], (unsigned long)window[n - 1]);
+  }
+}
+
+ProfileSlot &Profiler::slot(const char *name)
+{
+  uint8_t count = usedSlots();
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (slots[i].name && strcmp(slots[i].name, name) == 0)
+      return slots[i];
+  }
+
+  // Called once per call site, so running out of slots cannot wrap the counter
+  uint8_t index = slotCount.fetch_add(1);
+  if (index >= MAX_SLOTS)
+  {
+    otherSlot.name = "(other)";
+    return otherSlot;
+  }
+  slots[index].name = name;
+  return slots[index];
+}
+
+void Profiler::report(Print &out)
+{
+  out.printf("%-34s %8s %7s %7s %7s %7s\r\n", "scope", "samples", "min", "avg", "p99", "max");
+  uint8_t count = usedSlots();
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (slots[i].name)
+      printSlot(out, slots[i]);
+  }
+  if (otherSlot.name)
+    printSlot(out, otherSlot);
+}
+
+void Profiler::reset()
+{
+  uint8_t count = usedSlots();
+  for (uint8_t i = 0; i < count; i++)
+    slots[i].count = 0;
+  otherSlot.count = 0;
+}
+
+#endif // UI_PROFILING
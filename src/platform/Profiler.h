@@ -0,0 +1,81 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Frame timing instrumentation. Build with UI_PROFILING defined (add
+// -DUI_PROFILING to build_flags) and every PROFILE_SCOPE("name") measures the
+// time until the end of its block with micros(), adding it to the statistics
+// of 'name': the number of samples and the min, average, 99th percentile and
+// max of the last ProfileSlot::WINDOW of them. Profiler::report() prints them
+// over Serial, or to stdout on a host build.
+//
+// Without UI_PROFILING the macro expands to nothing and none of this is
+// compiled, so the scopes can stay in the draw and flush paths.
+
+#if defined(UI_PROFILING)
+
+#include <Arduino.h>
+#include <stdint.h>
+
+// Statistics of one named scope. Each slot should be fed from one task; a
+// report taken while another task adds samples may mix two frames.
+struct ProfileSlot
+{
+  static constexpr uint16_t WINDOW = 128; // Samples kept for the rolling figures
+
+  const char *name = nullptr;
+  uint32_t count = 0;            // Samples since the last reset
+  uint32_t samples[WINDOW] = {}; // Durations in microseconds, ring
+
+  void add(uint32_t us)
+  {
+    samples[count % WINDOW] = us;
+    count++;
+  }
+};
+
+class Profiler
+{
+public:
+  static constexpr uint8_t MAX_SLOTS = 32;
+
+  // Slot for 'name' (a string literal), created on first use. Scopes past
+  // MAX_SLOTS share one slot reported as "(other)".
+  static ProfileSlot &slot(const char *name);
+
+  // Prints one line per scope: samples, then min/avg/p99/max in microseconds
+  static void report(Print &out);
+
+  // Forgets all samples; the scopes stay registered
+  static void reset();
+};
+
+// Adds the lifetime of the object to a slot
+class ScopedTimer
+{
+public:
+  explicit ScopedTimer(ProfileSlot &slot) : slot(slot), start(micros()) {}
+  ~ScopedTimer() { slot.add(micros() - start); }
+
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+  ProfileSlot &slot;
+  unsigned long start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+// Times the rest of the enclosing block; the slot is looked up once per call site
+#define PROFILE_SCOPE(name)                                                         \
+  static ProfileSlot &PROFILE_CONCAT(profileSlot, __LINE__) = Profiler::slot(name); \
+  ScopedTimer PROFILE_CONCAT(profileTimer, __LINE__)(PROFILE_CONCAT(profileSlot, __LINE__))
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+
+#endif // UI_PROFILING
+
+#endif // PROFILER_H
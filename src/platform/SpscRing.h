@@ -0,0 +1,59 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+// Fixed-capacity single-producer / single-consumer queue without locks.
+// One context (a task or an interrupt handler) may push while another pops;
+// neither ever blocks. When the ring is full the new item is dropped and
+// counted, so the producer (possibly an ISR) never waits for the consumer.
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+template <typename T, size_t N>
+class SpscRing
+{
+  static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+  static constexpr size_t CAPACITY = N;
+
+  // Producer side. False (and counted as dropped) if the ring is full.
+  bool push(const T &item)
+  {
+    const uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == N)
+    {
+      dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    items[h % N] = item;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. False if the ring is empty.
+  bool pop(T &item)
+  {
+    const uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire))
+      return false;
+    item = items[t % N];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+  size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+
+  // Items refused because the ring was full, since construction
+  uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+  T items[N];
+  std::atomic<uint32_t> head{0}; // Written by the producer only
+  std::atomic<uint32_t> tail{0}; // Written by the consumer only
+  std::atomic<uint32_t> dropped{0};
+};
+
+#endif // SPSC_RING_H
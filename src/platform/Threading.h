@@ -0,0 +1,158 @@
+#ifndef THREADING_H
+#define THREADING_H
+
+// Portable threading primitives. On the ESP32 they map to FreeRTOS tasks and
+// semaphores (so work can be pinned to the core the Arduino loop is not using);
+// on a host build they map to std::thread and std::condition_variable.
+
+#include <stdint.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#else
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+// Binary semaphore: give() makes one pending or future take() return;
+// giveFromISR() does the same from an interrupt handler
+class Signal
+{
+public:
+#if defined(ARDUINO_ARCH_ESP32)
+  Signal() : handle(xSemaphoreCreateBinary()) {}
+  ~Signal() { vSemaphoreDelete(handle); }
+
+  void give() { xSemaphoreGive(handle); }
+  void giveFromISR()
+  {
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(handle, &woken);
+    if (woken)
+      portYIELD_FROM_ISR();
+  }
+  void take() { xSemaphoreTake(handle, portMAX_DELAY); }
+  bool take(unsigned long timeoutMs) { return xSemaphoreTake(handle, pdMS_TO_TICKS(timeoutMs)) == pdTRUE; }
+#else
+  Signal() = default;
+
+  void give()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    given = true;
+    condition.notify_one();
+  }
+
+  // Host "interrupts" are plain threads
+  void giveFromISR() { give(); }
+
+  void take()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this] { return given; });
+    given = false;
+  }
+
+  bool take(unsigned long timeoutMs)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!condition.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return given; }))
+      return false;
+    given = false;
+    return true;
+  }
+#endif
+
+  Signal(const Signal &) = delete;
+  Signal &operator=(const Signal &) = delete;
+
+private:
+#if defined(ARDUINO_ARCH_ESP32)
+  SemaphoreHandle_t handle;
+#else
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool given = false;
+#endif
+};
+
+// Runs a function on its own task/thread. 'core' pins the task on the ESP32
+// (-1 lets the scheduler choose) and is ignored on a host.
+// The function should return when asked to stop; join() waits for that.
+class Thread
+{
+public:
+  using Entry = void (*)(void *);
+
+  Thread() = default;
+  ~Thread() { join(); }
+
+  Thread(const Thread &) = delete;
+  Thread &operator=(const Thread &) = delete;
+
+  bool start(Entry entry, void *arg, const char *name, int core = -1, uint32_t stackSize = 4096, int priority = 1)
+  {
+    if (running)
+      return false;
+    this->entry = entry;
+    this->arg = arg;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    BaseType_t coreId = core < 0 ? tskNO_AFFINITY : core;
+    running = xTaskCreatePinnedToCore(trampoline, name, stackSize, this, priority, nullptr, coreId) == pdPASS;
+#else
+    (void)name;
+    (void)core;
+    (void)stackSize;
+    (void)priority;
+    thread = std::thread(trampoline, this);
+    running = true;
+#endif
+    return running;
+  }
+
+  // Waits until the function has returned
+  void join()
+  {
+    if (!running)
+      return;
+#if defined(ARDUINO_ARCH_ESP32)
+    finished.take();
+#else
+    thread.join();
+#endif
+    running = false;
+  }
+
+  bool isRunning() const { return running; }
+
+private:
+  Entry entry = nullptr;
+  void *arg = nullptr;
+  bool running = false;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  Signal finished;
+
+  static void trampoline(void *self)
+  {
+    Thread *thread = static_cast<Thread *>(self);
+    thread->entry(thread->arg);
+    thread->finished.give();
+    vTaskDelete(nullptr); // FreeRTOS tasks must not return
+  }
+#else
+  std::thread thread;
+
+  static void trampoline(Thread *self)
+  {
+    self->entry(self->arg);
+  }
+#endif
+};
+
+#endif // THREADING_H
@@ -0,0 +1,145 @@
+#include "FrameMirror.h"
+#include "MirrorProtocol.h"
+#include "RecordFormat.h"
+#include "../platform/Profiler.h"
+#include <string.h>
+
+FrameMirror::FrameMirror(Stream &port, int width, int height)
+    : port(port), width(width), pages(height / 8), frameSize(width * (height / 8))
+{
+  sent = new uint8_t[frameSize];
+  latest = new uint8_t[frameSize];
+  packet = new uint8_t[mirror::HEADER_SIZE + 3 + (pages + 7) / 8 + pages * record::maxPageSize(width) +
+                       mirror::CHECK_SIZE];
+}
+
+FrameMirror::~FrameMirror()
+{
+  delete[] sent;
+  delete[] latest;
+  delete[] packet;
+}
+
+void FrameMirror::setEnabled(bool enabled)
+{
+  if (enabled && !this->enabled)
+    keyframeDue = true;
+  if (!enabled)
+    latestPending = false; // A packet in flight is finished so the stream stays parseable
+  this->enabled = enabled;
+}
+
+bool FrameMirror::handleCommand(int c)
+{
+  if (c == mirror::COMMAND_START)
+  {
+    if (enabled)
+      requestKeyframe();
+    setEnabled(true);
+    return true;
+  }
+  if (c == mirror::COMMAND_STOP)
+  {
+    setEnabled(false);
+    return true;
+  }
+  return false;
+}
+
+void FrameMirror::submit(const uint8_t *frame)
+{
+  if (!enabled || pages <= 0 || pages > record::MAX_PAGES)
+    return;
+  if (latestPending)
+    framesDropped++; // Never reached the port; the new frame supersedes it
+  memcpy(latest, frame, frameSize);
+  latestPending = true;
+  poll();
+}
+
+void FrameMirror::poll()
+{
+  while (true)
+  {
+    if (packetSent < packetSize)
+    {
+      int room = port.availableForWrite();
+      if (room <= 0)
+        return;
+      size_t n = packetSize - packetSent;
+      if (n > static_cast<size_t>(room))
+        n = room;
+      packetSent += port.write(packet + packetSent, n);
+      if (packetSent < packetSize)
+        return;
+    }
+
+    // The port took the whole packet; queue the frame waiting behind it
+    if (!latestPending || !buildPacket())
+      return;
+  }
+}
+
+// Encodes 'latest' against 'sent' into 'packet'; false if nothing changed
+bool FrameMirror::buildPacket()
+{
+  PROFILE_SCOPE("FrameMirror::buildPacket");
+  latestPending = false;
+  if (packetsSinceKeyframe >= KEYFRAME_INTERVAL)
+    keyframeDue = true;
+
+  const size_t maskBytes = (pages + 7) / 8;
+  uint8_t *payload = packet + mirror::HEADER_SIZE;
+  size_t size = 0;
+  uint8_t type;
+
+  if (keyframeDue)
+  {
+    type = mirror::KEYFRAME;
+    payload[size++] = static_cast<uint8_t>(width);
+    payload[size++] = static_cast<uint8_t>(width >> 8);
+    payload[size++] = static_cast<uint8_t>(pages);
+    for (int page = 0; page < pages; page++)
+      size += record::encodePage(nullptr, latest + page * width, width, payload + size);
+    keyframeDue = false;
+    packetsSinceKeyframe = 0;
+  }
+  else
+  {
+    type = mirror::FRAME;
+    uint8_t *mask = payload;
+    memset(mask, 0, maskBytes);
+    size = maskBytes;
+    for (int page = 0; page < pages; page++)
+    {
+      const uint8_t *before = sent + page * width;
+      const uint8_t *after = latest + page * width;
+      if (memcmp(before, after, width) == 0)
+        continue;
+      mask[page / 8] |= 1 << (page % 8);
+      size += record::encodePage(before, after, width, payload + size);
+    }
+    if (size == maskBytes)
+      return false; // Same as what the host shows
+    packetsSinceKeyframe++;
+  }
+
+  packet[0] = mirror::SYNC0;
+  packet[1] = mirror::SYNC1;
+  packet[2] = type;
+  packet[3] = sequence++;
+  packet[4] = static_cast<uint8_t>(size);
+  packet[5] = static_cast<uint8_t>(size >> 8);
+
+  mirror::Checksum check;
+  check.add(packet + 2, mirror::HEADER_SIZE - 2 + size);
+  const uint16_t value = check.value();
+  payload[size] = static_cast<uint8_t>(value);
+  payload[size + 1] = static_cast<uint8_t>(value >> 8);
+
+  packetSize = mirror::HEADER_SIZE + size + mirror::CHECK_SIZE;
+  packetSent = 0;
+  memcpy(sent, latest, frameSize);
+  framesSent++;
+  return true;
+}
@@ -0,0 +1,71 @@
+#ifndef FRAME_MIRROR_H
+#define FRAME_MIRROR_H
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Streams the panel content over a serial port (the USB CDC Serial) as page
+// deltas, so a host viewer (src/host/viewer.cpp) can show the screen live.
+// Protocol in MirrorProtocol.h; the stream is off until the host sends 'm'.
+//
+// Sending never blocks rendering: poll() writes only what the port accepts
+// right away, and a frame submitted while the previous packet is still going
+// out replaces any other frame waiting behind it. Intermediate frames are
+// dropped, the last one is always sent, and each delta is taken against what
+// the host actually received.
+class FrameMirror
+{
+public:
+  static constexpr unsigned KEYFRAME_INTERVAL = 128; // Packets between keyframes
+
+  // 'width' x 'height' is the physical (unrotated) frame size
+  FrameMirror(Stream &port, int width = 128, int height = 64);
+  ~FrameMirror();
+
+  FrameMirror(const FrameMirror &) = delete;
+  FrameMirror &operator=(const FrameMirror &) = delete;
+
+  void setEnabled(bool enabled);
+  bool isEnabled() const { return enabled; }
+
+  // Sends the next frame whole, e.g. for a host that lost a packet
+  void requestKeyframe() { keyframeDue = true; }
+
+  // Handles a byte received from the host; false if it is not a mirror command
+  bool handleCommand(int c);
+
+  // Queues a page-major frame (e.g. the panel buffer after display()) and sends what fits
+  void submit(const uint8_t *frame);
+
+  // Continues sending the current packet; call from the main loop
+  void poll();
+
+  unsigned long getFramesSent() const { return framesSent; }
+  unsigned long getFramesDropped() const { return framesDropped; }
+
+private:
+  Stream &port;
+  int width;
+  int pages;
+  size_t frameSize;
+
+  uint8_t *sent;           // Frame the host has once the current packet is through
+  uint8_t *latest;         // Frame waiting for the port
+  bool latestPending = false;
+  bool keyframeDue = true;
+  unsigned packetsSinceKeyframe = 0;
+
+  uint8_t *packet;         // Packet being sent
+  size_t packetSize = 0;
+  size_t packetSent = 0;
+  uint8_t sequence = 0;
+
+  bool enabled = false;
+  unsigned long framesSent = 0;
+  unsigned long framesDropped = 0;
+
+  bool buildPacket();
+};
+
+#endif // FRAME_MIRROR_H
@@ -0,0 +1,153 @@
+#include "InputTrace.h"
+#include "RecordFormat.h"
+#include "../platform/Clock.h"
+#include <string.h>
+
+bool InputTraceRecorder::begin(const char *path, size_t maxBytes)
+{
+  end();
+  if (maxBytes < trace::HEADER_SIZE + trace::MAX_RECORD || !storage.create(path))
+    return false;
+
+  uint8_t header[trace::HEADER_SIZE] = {};
+  memcpy(header, trace::MAGIC, 4);
+  header[4] = trace::VERSION;
+  lastTime = Clock::now();
+  record::putU32(header + 8, lastTime);
+  if (!storage.write(header, sizeof(header)))
+  {
+    storage.close();
+    return false;
+  }
+  storage.flush();
+
+  this->maxBytes = maxBytes;
+  size = sizeof(header);
+  edgesRecorded = 0;
+  edgesDropped = 0;
+  buffered = 0;
+  bufferedEdges = 0;
+  full = false;
+  recording = true;
+  return true;
+}
+
+void InputTraceRecorder::end()
+{
+  flush();
+  storage.close();
+  recording = false;
+}
+
+void InputTraceRecorder::record(const ButtonEdge &edge)
+{
+  if (!recording || full)
+    return;
+  if (size + trace::MAX_RECORD > maxBytes)
+  {
+    full = true; // Keep the start of the session; closed by service()
+    return;
+  }
+  if (buffered + trace::MAX_RECORD > BUFFER_SIZE)
+  {
+    edgesDropped++; // service() has not run for a while
+    return;
+  }
+
+  // Edges come in time order; an edge stamped before the trace began counts at its start
+  uint32_t time = static_cast<uint32_t>(edge.time);
+  uint32_t dt = static_cast<int32_t>(time - lastTime) > 0 ? time - lastTime : 0;
+  lastTime += dt;
+
+  uint8_t *out = buffer + buffered;
+  size_t n = record::putVarint(out, dt);
+  out[n++] = edge.button;
+  out[n++] = edge.pin;
+  out[n++] = edge.level;
+  buffered += n;
+  bufferedEdges++;
+  size += n;
+}
+
+void InputTraceRecorder::service(bool idle)
+{
+  if (!recording)
+    return;
+  if (bufferedEdges >= FLUSH_EDGES || (idle && bufferedEdges > 0))
+    flush();
+  if (full)
+    end();
+}
+
+void InputTraceRecorder::flush()
+{
+  if (!recording || buffered == 0)
+    return;
+  bool written = storage.write(buffer, buffered);
+  if (written)
+  {
+    storage.flush();
+    edgesRecorded += bufferedEdges;
+  }
+  buffered = 0;
+  bufferedEdges = 0;
+  if (!written)
+  {
+    storage.close();
+    recording = false;
+  }
+}
+
+bool InputTracePlayer::load(const uint8_t *data, size_t size)
+{
+  pendingValid = false;
+  truncated = false;
+  edgesPlayed = 0;
+  memset(levels, HIGH, sizeof(levels)); // Released, as after ButtonManager::begin()
+  if (size < trace::HEADER_SIZE || memcmp(data, trace::MAGIC, 4) != 0 || data[4] != trace::VERSION)
+    return false;
+
+  startMs = record::getU32(data + 8);
+  pending.time = startMs;
+  in = data + trace::HEADER_SIZE;
+  end = data + size;
+  readNext();
+  return true;
+}
+
+size_t InputTracePlayer::feed(ButtonManager &buttons, unsigned long now)
+{
+  size_t count = 0;
+  while (pendingValid && static_cast<long>(now - pending.time) >= 0)
+  {
+    levels[pending.pin] = pending.level;
+    buttons.feedEdge(pending.button, pending.level, pending.time);
+    edgesPlayed++;
+    count++;
+    readNext();
+  }
+  return count;
+}
+
+// Decodes the record at 'in' into 'pending'
+void InputTracePlayer::readNext()
+{
+  pendingValid = false;
+  if (in == end)
+    return;
+
+  uint32_t dt;
+  size_t n = record::getVarint(in, end, dt);
+  if (n == 0 || end - in < static_cast<ptrdiff_t>(n + 3))
+  {
+    truncated = true;
+    in = end;
+    return;
+  }
+  pending.time = static_cast<uint32_t>(pending.time + dt);
+  pending.button = in[n];
+  pending.pin = in[n + 1];
+  pending.level = in[n + 2];
+  in += n + 3;
+  pendingValid = true;
+}
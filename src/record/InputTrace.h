@@ -0,0 +1,124 @@
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+#include "RecordStorage.h"
+#include "../button/ButtonManager.h"
+#include "../platform/InputSource.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Input traces: every button edge ButtonManager applied, with its time, so a
+// session recorded on the device (or scripted on a host) can be played back
+// through the same ButtonManager and views with a ManualClock, frame for
+// frame (see src/host/session.cpp). A trace file is
+//
+//   "ITRC" version:u8 reserved:u8[3] startMs:u32  (12 bytes, little endian)
+//
+// followed by one record per edge: the time since the previous edge (or
+// startMs) in milliseconds as a varint (RecordFormat.h), then the button id,
+// its pin and the new level, one byte each.
+namespace trace
+{
+  static const uint8_t MAGIC[4] = {'I', 'T', 'R', 'C'};
+  static constexpr uint8_t VERSION = 1;
+  static constexpr size_t HEADER_SIZE = 12;
+  static constexpr size_t MAX_RECORD = 5 + 3;
+}
+
+// Appends the edges of a ButtonManager to a trace file. The trace hook runs
+// inside ButtonManager::update(), so record() only encodes the edge into a RAM
+// buffer; service(), called from loop(), writes the buffer out in one batch
+// once FLUSH_EDGES edges are waiting or the buttons are idle. Edges that do not
+// fit the buffer before it is written are counted as dropped. Recording stops
+// once the file reaches maxBytes.
+//
+// Recording is opt-in on the device: build with -DINPUT_TRACE (see main.cpp).
+class InputTraceRecorder
+{
+public:
+  static constexpr size_t DEFAULT_MAX_BYTES = 32 * 1024;
+  static constexpr size_t BUFFER_SIZE = 256;
+  static constexpr unsigned FLUSH_EDGES = 16;
+
+  // Starts a new trace at 'path' (replacing it) whose time base is now
+  bool begin(const char *path = "/input.trc", size_t maxBytes = DEFAULT_MAX_BYTES);
+
+  // Writes the buffered edges and closes the file
+  void end();
+
+  // Buffers an edge; never touches the file
+  void record(const ButtonEdge &edge);
+
+  // Writes the buffered edges when FLUSH_EDGES are waiting, or any at all
+  // when 'idle' (e.g. no button in progress). Call from loop().
+  void service(bool idle);
+
+  // Writes the buffered edges now
+  void flush();
+
+  // For ButtonManager::setEdgeTrace(InputTraceRecorder::onEdge, &recorder)
+  static void onEdge(const ButtonEdge &edge, void *recorder)
+  {
+    static_cast<InputTraceRecorder *>(recorder)->record(edge);
+  }
+
+  bool isRecording() const { return recording; }
+  unsigned long getEdgesRecorded() const { return edgesRecorded; }
+  unsigned long getEdgesDropped() const { return edgesDropped; }
+
+private:
+  RecordStorage storage;
+  size_t maxBytes = 0;
+  size_t size = 0; // Bytes in the file, buffer included
+  uint32_t lastTime = 0;
+  bool recording = false;
+  bool full = false;
+  unsigned long edgesRecorded = 0;
+  unsigned long edgesDropped = 0;
+
+  uint8_t buffer[BUFFER_SIZE];
+  size_t buffered = 0;
+  unsigned bufferedEdges = 0;
+};
+
+// Plays a trace back: feeds its edges to a ButtonManager as the (manual)
+// clock reaches their recorded times, and serves the pin levels they imply
+// when installed as the InputSource. Recorded times are kept as they are, so
+// a run whose clock starts at getStartMs() sees the device's timing exactly.
+class InputTracePlayer : public InputSource
+{
+public:
+  static constexpr unsigned long NO_EDGE = ~0UL;
+
+  // 'data' must stay valid while playing; false if it is not a trace
+  bool load(const uint8_t *data, size_t size);
+
+  uint32_t getStartMs() const { return startMs; }
+
+  // Feeds 'buttons' every edge recorded up to 'now'; returns how many
+  size_t feed(ButtonManager &buttons, unsigned long now);
+
+  // Time of the next edge, or NO_EDGE at the end of the trace
+  unsigned long nextTime() const { return pendingValid ? pending.time : NO_EDGE; }
+  bool finished() const { return !pendingValid; }
+
+  // A record was cut off (e.g. the device reset while writing it)
+  bool isTruncated() const { return truncated; }
+  unsigned long getEdgesPlayed() const { return edgesPlayed; }
+
+  int readLevel(uint8_t pin) override { return levels[pin]; }
+
+private:
+  const uint8_t *in = nullptr;
+  const uint8_t *end = nullptr;
+  uint32_t startMs = 0;
+  ButtonEdge pending = {};
+  bool pendingValid = false;
+  bool truncated = false;
+  unsigned long edgesPlayed = 0;
+  uint8_t levels[256];
+
+  void readNext();
+};
+
+#endif // INPUT_TRACE_H
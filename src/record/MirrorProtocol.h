@@ -0,0 +1,56 @@
+#ifndef MIRROR_PROTOCOL_H
+#define MIRROR_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Framing of the live screen mirror (FrameMirror on the device, MirrorReceiver
+// on the host). Packets share the serial port with ordinary text output, so
+// each one is delimited and checked:
+//
+//   0xA5 0x5A type:u8 sequence:u8 length:u16 payload[length] check:u16  (little endian)
+//
+// 'check' is the Fletcher-16 sum of type, sequence, length and payload; a
+// receiver that sees a bad sum or a gap in the sequence waits for the next
+// keyframe. The payloads reuse the page encoding of RecordFormat.h:
+//
+//   'K' width:u16 pages:u8 pages...  keyframe, every page against a blank frame
+//   'F' mask pages...                changed pages against the previous packet
+//
+// The host controls the stream with single command bytes: 'm' starts it (or
+// asks for a keyframe when it is running) and 'M' stops it.
+
+namespace mirror
+{
+  static constexpr uint8_t SYNC0 = 0xA5;
+  static constexpr uint8_t SYNC1 = 0x5A;
+  static constexpr size_t HEADER_SIZE = 6; // Sync, type, sequence, length
+  static constexpr size_t CHECK_SIZE = 2;
+  static constexpr size_t MAX_PAYLOAD = 4096;
+
+  static constexpr uint8_t KEYFRAME = 'K';
+  static constexpr uint8_t FRAME = 'F';
+
+  static constexpr char COMMAND_START = 'm';
+  static constexpr char COMMAND_STOP = 'M';
+
+  // Running Fletcher-16 sum
+  struct Checksum
+  {
+    uint16_t a = 0;
+    uint16_t b = 0;
+
+    void add(const uint8_t *data, size_t size)
+    {
+      for (size_t i = 0; i < size; i++)
+      {
+        a = (a + data[i]) % 255;
+        b = (b + a) % 255;
+      }
+    }
+
+    uint16_t value() const { return static_cast<uint16_t>(b << 8 | a); }
+  };
+}
+
+#endif // MIRROR_PROTOCOL_H
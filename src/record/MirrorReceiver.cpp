@@ -0,0 +1,165 @@
+#include "MirrorReceiver.h"
+#include "RecordFormat.h"
+#include <string.h>
+
+void MirrorReceiver::feed(const uint8_t *data, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+    feed(data[i]);
+}
+
+void MirrorReceiver::feed(uint8_t c)
+{
+  switch (state)
+  {
+  case State::Text:
+    if (c == mirror::SYNC0)
+      state = State::Sync;
+    else
+      text(c);
+    break;
+
+  case State::Sync:
+    if (c == mirror::SYNC1)
+    {
+      header[0] = mirror::SYNC0;
+      header[1] = mirror::SYNC1;
+      headerSize = 2;
+      state = State::Header;
+    }
+    else
+    {
+      // A lone first sync byte was text after all
+      text(mirror::SYNC0);
+      state = State::Text;
+      feed(c);
+    }
+    break;
+
+  case State::Header:
+    header[headerSize++] = c;
+    if (headerSize < mirror::HEADER_SIZE)
+      break;
+    bodySize = header[4] | header[5] << 8;
+    if (bodySize > mirror::MAX_PAYLOAD)
+    {
+      lost();
+      state = State::Text;
+      break;
+    }
+    bodySize += mirror::CHECK_SIZE;
+    body.clear();
+    state = State::Payload;
+    break;
+
+  case State::Payload:
+    body.push_back(c);
+    if (body.size() == bodySize)
+    {
+      packetDone();
+      state = State::Text;
+    }
+    break;
+  }
+}
+
+void MirrorReceiver::text(uint8_t c)
+{
+  if (textHandler)
+    textHandler(static_cast<char>(c));
+}
+
+void MirrorReceiver::packetDone()
+{
+  const size_t payloadSize = bodySize - mirror::CHECK_SIZE;
+  mirror::Checksum check;
+  check.add(header + 2, mirror::HEADER_SIZE - 2);
+  check.add(body.data(), payloadSize);
+  if (check.value() != (body[payloadSize] | body[payloadSize + 1] << 8))
+  {
+    lost();
+    return;
+  }
+
+  const uint8_t type = header[2];
+  const uint8_t sequence = header[3];
+  bool ok;
+  if (type == mirror::KEYFRAME)
+  {
+    ok = applyKeyframe(body.data(), payloadSize);
+  }
+  else if (type == mirror::FRAME)
+  {
+    if (!synced)
+      return; // Nothing to apply it to until a keyframe arrives
+    if (sequence != expectedSequence)
+    {
+      lost();
+      return;
+    }
+    ok = applyFrame(body.data(), payloadSize);
+  }
+  else
+  {
+    return; // Newer packet type; skip it
+  }
+
+  if (!ok)
+  {
+    lost();
+    return;
+  }
+  synced = true;
+  expectedSequence = sequence + 1;
+  framesReceived++;
+  if (frameHandler)
+    frameHandler(frame.data(), width, pages);
+}
+
+bool MirrorReceiver::applyKeyframe(const uint8_t *payload, size_t size)
+{
+  if (size < 3)
+    return false;
+  width = payload[0] | payload[1] << 8;
+  pages = payload[2];
+  if (width <= 0 || pages <= 0 || pages > record::MAX_PAGES)
+    return false;
+
+  frame.assign(width * pages, 0);
+  const uint8_t *in = payload + 3;
+  const uint8_t *end = payload + size;
+  for (int page = 0; page < pages; page++)
+  {
+    size_t used = record::decodePage(in, end, frame.data() + page * width, width);
+    if (used == 0)
+      return false;
+    in += used;
+  }
+  return in == end;
+}
+
+bool MirrorReceiver::applyFrame(const uint8_t *payload, size_t size)
+{
+  const size_t maskBytes = (pages + 7) / 8;
+  if (size < maskBytes)
+    return false;
+
+  const uint8_t *in = payload + maskBytes;
+  const uint8_t *end = payload + size;
+  for (int page = 0; page < pages; page++)
+  {
+    if (!(payload[page / 8] & (1 << (page % 8))))
+      continue;
+    size_t used = record::decodePage(in, end, frame.data() + page * width, width);
+    if (used == 0)
+      return false;
+    in += used;
+  }
+  return in == end;
+}
+
+void MirrorReceiver::lost()
+{
+  packetsLost++;
+  synced = false;
+}
@@ -0,0 +1,60 @@
+#ifndef MIRROR_RECEIVER_H
+#define MIRROR_RECEIVER_H
+
+#include "MirrorProtocol.h"
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Rebuilds the frames streamed by FrameMirror from the raw bytes of the serial
+// port. Bytes outside packets (the device's ordinary text output) are passed
+// to the text handler.
+class MirrorReceiver
+{
+public:
+  // 'frame' is page-major, width x pages * 8
+  using FrameHandler = std::function<void(const uint8_t *frame, int width, int pages)>;
+  using TextHandler = std::function<void(char c)>;
+
+  void onFrame(FrameHandler handler) { frameHandler = handler; }
+  void onText(TextHandler handler) { textHandler = handler; }
+
+  void feed(const uint8_t *data, size_t size);
+
+  // True after a damaged or missing packet until the next keyframe; the host
+  // should send 'm' to ask for one
+  bool needsKeyframe() const { return !synced; }
+
+  unsigned long getFramesReceived() const { return framesReceived; }
+  unsigned long getPacketsLost() const { return packetsLost; }
+
+private:
+  enum class State { Text, Sync, Header, Payload };
+
+  FrameHandler frameHandler;
+  TextHandler textHandler;
+
+  State state = State::Text;
+  uint8_t header[mirror::HEADER_SIZE];
+  size_t headerSize = 0;
+  std::vector<uint8_t> body; // Payload and check
+  size_t bodySize = 0;
+
+  std::vector<uint8_t> frame;
+  int width = 0;
+  int pages = 0;
+  bool synced = false;
+  uint8_t expectedSequence = 0;
+  unsigned long framesReceived = 0;
+  unsigned long packetsLost = 0;
+
+  void feed(uint8_t c);
+  void text(uint8_t c);
+  void packetDone();
+  bool applyKeyframe(const uint8_t *payload, size_t size);
+  bool applyFrame(const uint8_t *payload, size_t size);
+  void lost();
+};
+
+#endif // MIRROR_RECEIVER_H
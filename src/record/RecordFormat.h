@@ -0,0 +1,214 @@
+#ifndef RECORD_FORMAT_H
+#define RECORD_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Screen recording format, shared by ScreenRecorder (device) and ScreenPlayer
+// (host). A recording is a set of segment files; each one starts with
+//
+//   "SREC" version:u8 pages:u8 width:u16 sequence:u32 startMs:u32  (16 bytes, little endian)
+//
+// followed by records. Every record starts with its type and the time since
+// the previous record (or startMs) in milliseconds as a varint:
+//
+//   'K' dt pages...      keyframe: every page, encoded against a blank frame
+//   'F' dt mask pages... frame: 'mask' (one bit per page, ceil(pages / 8)
+//                        bytes) lists the changed pages, each encoded
+//                        against the previous frame
+//   'E' dt id pin action length name   input event (ButtonEvent and its name)
+//
+// A page is the XOR of its old and new column bytes, run-length encoded in
+// tokens of one control byte: the top two bits give the kind, the low six
+// the count - 1 (1 to 64 bytes).
+//   00  skip: that many unchanged bytes
+//   01  literal: that many bytes follow
+//   10  repeat: one byte follows, repeated that many times
+// Unchanged columns XOR to zero, so a typical frame costs a few bytes.
+
+namespace record
+{
+  static const uint8_t MAGIC[4] = {'S', 'R', 'E', 'C'};
+  static constexpr uint8_t VERSION = 2;
+  static constexpr size_t HEADER_SIZE = 16;
+  static constexpr uint8_t MAX_PAGES = 16; // 128 pixel tall panels
+
+  static constexpr uint8_t KEYFRAME = 'K';
+  static constexpr uint8_t FRAME = 'F';
+  static constexpr uint8_t EVENT = 'E';
+
+  static constexpr uint8_t TOKEN_SKIP = 0x00;
+  static constexpr uint8_t TOKEN_LITERAL = 0x40;
+  static constexpr uint8_t TOKEN_REPEAT = 0x80;
+  static constexpr int TOKEN_MAX_COUNT = 64;
+
+  struct Header
+  {
+    uint8_t pages = 0;
+    uint16_t width = 0;
+    uint32_t sequence = 0; // Higher is newer
+    uint32_t startMs = 0;
+  };
+
+  inline void putU16(uint8_t *out, uint16_t value)
+  {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+  }
+
+  inline void putU32(uint8_t *out, uint32_t value)
+  {
+    for (int i = 0; i < 4; i++)
+      out[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+
+  inline uint16_t getU16(const uint8_t *in) { return static_cast<uint16_t>(in[0] | in[1] << 8); }
+
+  inline uint32_t getU32(const uint8_t *in)
+  {
+    return static_cast<uint32_t>(in[0]) | static_cast<uint32_t>(in[1]) << 8 |
+           static_cast<uint32_t>(in[2]) << 16 | static_cast<uint32_t>(in[3]) << 24;
+  }
+
+  inline void writeHeader(uint8_t *out, const Header &header)
+  {
+    memcpy(out, MAGIC, 4);
+    out[4] = VERSION;
+    out[5] = header.pages;
+    putU16(out + 6, header.width);
+    putU32(out + 8, header.sequence);
+    putU32(out + 12, header.startMs);
+  }
+
+  // False if 'in' is not a header this code can read
+  inline bool readHeader(const uint8_t *in, Header &header)
+  {
+    if (memcmp(in, MAGIC, 4) != 0 || in[4] != VERSION)
+      return false;
+    header.pages = in[5];
+    header.width = getU16(in + 6);
+    header.sequence = getU32(in + 8);
+    header.startMs = getU32(in + 12);
+    return header.pages > 0 && header.pages <= MAX_PAGES && header.width > 0;
+  }
+
+  // Writes 'value' as 7-bit groups, low first; returns the bytes written (at most 5)
+  inline size_t putVarint(uint8_t *out, uint32_t value)
+  {
+    size_t n = 0;
+    while (value >= 0x80)
+    {
+      out[n++] = static_cast<uint8_t>(value | 0x80);
+      value >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(value);
+    return n;
+  }
+
+  // Reads a varint from [in, end); returns the bytes used, 0 if it is cut off
+  inline size_t getVarint(const uint8_t *in, const uint8_t *end, uint32_t &value)
+  {
+    value = 0;
+    for (size_t n = 0; n < 5 && in + n < end; n++)
+    {
+      value |= static_cast<uint32_t>(in[n] & 0x7F) << (7 * n);
+      if (!(in[n] & 0x80))
+        return n + 1;
+    }
+    return 0;
+  }
+
+  // Encodes the change from 'previous' to 'current' (one page of 'width'
+  // bytes each) into 'out', which needs room for maxPageSize(width)
+  // bytes; a null 'previous' stands for a blank page. Returns the encoded size.
+  inline size_t encodePage(const uint8_t *previous, const uint8_t *current, int width, uint8_t *out)
+  {
+    auto change = [&](int x) -> uint8_t { return previous ? previous[x] ^ current[x] : current[x]; };
+
+    size_t n = 0;
+    int x = 0;
+    while (x < width)
+    {
+      const uint8_t value = change(x);
+      int run = 1;
+      while (x + run < width && run < TOKEN_MAX_COUNT && change(x + run) == value)
+        run++;
+
+      if (value == 0)
+      {
+        out[n++] = static_cast<uint8_t>(TOKEN_SKIP | (run - 1));
+        x += run;
+      }
+      else if (run >= 3)
+      {
+        out[n++] = static_cast<uint8_t>(TOKEN_REPEAT | (run - 1));
+        out[n++] = value;
+        x += run;
+      }
+      else
+      {
+        // Literal bytes up to the next unchanged byte or run of three
+        int count = 0;
+        uint8_t *control = out + n++;
+        while (x < width && count < TOKEN_MAX_COUNT)
+        {
+          const uint8_t v = change(x);
+          if (v == 0 || (x + 2 < width && change(x + 1) == v && change(x + 2) == v))
+            break;
+          out[n++] = v;
+          x++;
+          count++;
+        }
+        *control = static_cast<uint8_t>(TOKEN_LITERAL | (count - 1));
+      }
+    }
+    return n;
+  }
+
+  // Largest encoded page of 'width' bytes: a one byte literal costs two, but
+  // is always followed by a skip or repeat token, hence 3 bytes per 2 at worst
+  inline constexpr size_t maxPageSize(int width) { return width + width / 2 + 2; }
+
+  // Applies one encoded page from [in, end) to 'page' (width bytes).
+  // Returns the bytes used, 0 if the data is malformed.
+  inline size_t decodePage(const uint8_t *in, const uint8_t *end, uint8_t *page, int width)
+  {
+    const uint8_t *start = in;
+    int x = 0;
+    while (x < width)
+    {
+      if (in >= end)
+        return 0;
+      const uint8_t control = *in++;
+      const int count = (control & 0x3F) + 1;
+      if (x + count > width)
+        return 0;
+
+      switch (control & 0xC0)
+      {
+      case TOKEN_SKIP:
+        break;
+      case TOKEN_LITERAL:
+        if (end - in < count)
+          return 0;
+        for (int i = 0; i < count; i++)
+          page[x + i] ^= *in++;
+        break;
+      case TOKEN_REPEAT:
+        if (in >= end)
+          return 0;
+        for (int i = 0; i < count; i++)
+          page[x + i] ^= *in;
+        in++;
+        break;
+      default:
+        return 0;
+      }
+      x += count;
+    }
+    return in - start;
+  }
+}
+
+#endif // RECORD_FORMAT_H
@@ -0,0 +1,113 @@
+#ifndef RECORD_STORAGE_H
+#define RECORD_STORAGE_H
+
+// File access for the screen recorder. On the ESP32 the segments live on the
+// SPIFFS partition (SPIFFS.begin() must have succeeded); on a host build they
+// are plain files, so recordings can be produced and replayed off-device.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <SPIFFS.h>
+#else
+#include <stdio.h>
+#endif
+
+class RecordStorage
+{
+public:
+  RecordStorage() = default;
+  ~RecordStorage() { close(); }
+
+  RecordStorage(const RecordStorage &) = delete;
+  RecordStorage &operator=(const RecordStorage &) = delete;
+
+  // Reads the first 'size' bytes of 'path'; false if it is missing or shorter
+  static bool readStart(const char *path, uint8_t *out, size_t size)
+  {
+#if defined(ARDUINO_ARCH_ESP32)
+    if (!SPIFFS.exists(path))
+      return false;
+    fs::File in = SPIFFS.open(path, "r");
+    if (!in)
+      return false;
+    bool ok = in.read(out, size) == size;
+    in.close();
+    return ok;
+#else
+    FILE *in = fopen(path, "rb");
+    if (!in)
+      return false;
+    bool ok = fread(out, 1, size, in) == size;
+    fclose(in);
+    return ok;
+#endif
+  }
+
+  // Creates 'path', replacing any previous content
+  bool create(const char *path)
+  {
+    close();
+#if defined(ARDUINO_ARCH_ESP32)
+    file = SPIFFS.open(path, "w");
+    return static_cast<bool>(file);
+#else
+    file = fopen(path, "wb");
+    return file != nullptr;
+#endif
+  }
+
+  bool isOpen() const
+  {
+#if defined(ARDUINO_ARCH_ESP32)
+    return static_cast<bool>(file);
+#else
+    return file != nullptr;
+#endif
+  }
+
+  bool write(const uint8_t *data, size_t size)
+  {
+    if (!isOpen())
+      return false;
+#if defined(ARDUINO_ARCH_ESP32)
+    return file.write(data, size) == size;
+#else
+    return fwrite(data, 1, size, file) == size;
+#endif
+  }
+
+  // Commits what was written, so a reset loses nothing before this point
+  void flush()
+  {
+    if (!isOpen())
+      return;
+#if defined(ARDUINO_ARCH_ESP32)
+    file.flush();
+#else
+    fflush(file);
+#endif
+  }
+
+  void close()
+  {
+    if (!isOpen())
+      return;
+#if defined(ARDUINO_ARCH_ESP32)
+    file.close();
+#else
+    fclose(file);
+    file = nullptr;
+#endif
+  }
+
+private:
+#if defined(ARDUINO_ARCH_ESP32)
+  fs::File file;
+#else
+  FILE *file = nullptr;
+#endif
+};
+
+#endif // RECORD_STORAGE_H
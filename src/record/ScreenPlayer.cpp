@@ -0,0 +1,111 @@
+#include "ScreenPlayer.h"
+#include <string.h>
+
+bool ScreenPlayer::readHeader(const uint8_t *data, size_t size, record::Header &header)
+{
+  return size >= record::HEADER_SIZE && record::readHeader(data, header);
+}
+
+bool ScreenPlayer::play(const uint8_t *data, size_t size)
+{
+  truncated = false;
+  if (!readHeader(data, size, segmentHeader))
+    return false;
+
+  frame.assign(segmentHeader.width * segmentHeader.pages, 0);
+  haveKeyframe = false;
+  uint32_t time = segmentHeader.startMs;
+
+  const uint8_t *in = data + record::HEADER_SIZE;
+  const uint8_t *end = data + size;
+  while (in < end)
+  {
+    const uint8_t type = *in++;
+    uint32_t dt;
+    size_t used = record::getVarint(in, end, dt);
+    if (used == 0)
+    {
+      truncated = true;
+      break;
+    }
+    in += used;
+    time += dt;
+
+    if (type == record::KEYFRAME || type == record::FRAME)
+    {
+      const uint8_t *next = playFrame(in, end, type == record::KEYFRAME);
+      if (!next)
+      {
+        truncated = true;
+        break;
+      }
+      in = next;
+      if (haveKeyframe)
+      {
+        framesPlayed++;
+        if (frameHandler)
+          frameHandler(time, frame.data());
+      }
+    }
+    else if (type == record::EVENT)
+    {
+      if (end - in < 4 || end - in < 4 + in[3])
+      {
+        truncated = true;
+        break;
+      }
+      RecordedEvent event;
+      event.timeMs = time;
+      event.buttonId = in[0];
+      event.buttonPin = in[1];
+      event.action = static_cast<ButtonAction>(in[2]);
+      event.nameLength = in[3];
+      event.name = reinterpret_cast<const char *>(in + 4);
+      in += 4 + event.nameLength;
+      eventsPlayed++;
+      if (eventHandler)
+        eventHandler(event);
+    }
+    else
+    {
+      truncated = true; // Unknown record: nothing after it can be trusted
+      break;
+    }
+  }
+  return true;
+}
+
+// Applies one frame record to 'frame'; returns the end of the record, or
+// nullptr if it is incomplete
+const uint8_t *ScreenPlayer::playFrame(const uint8_t *in, const uint8_t *end, bool keyframe)
+{
+  const int width = segmentHeader.width;
+  const int pages = segmentHeader.pages;
+  const int maskBytes = (pages + 7) / 8;
+
+  uint8_t mask[(record::MAX_PAGES + 7) / 8];
+  if (keyframe)
+  {
+    memset(mask, 0xFF, sizeof(mask));
+    memset(frame.data(), 0, frame.size());
+    haveKeyframe = true;
+  }
+  else
+  {
+    if (end - in < maskBytes)
+      return nullptr;
+    memcpy(mask, in, maskBytes);
+    in += maskBytes;
+  }
+
+  for (int page = 0; page < pages; page++)
+  {
+    if (!(mask[page / 8] & (1 << (page % 8))))
+      continue;
+    size_t used = record::decodePage(in, end, frame.data() + page * width, width);
+    if (used == 0)
+      return nullptr;
+    in += used;
+  }
+  return in;
+}
@@ -0,0 +1,62 @@
+#ifndef SCREEN_PLAYER_H
+#define SCREEN_PLAYER_H
+
+#include "RecordFormat.h"
+#include "../button/ButtonManager.h"
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Input event as stored by ScreenRecorder::recordEvent()
+struct RecordedEvent
+{
+  uint32_t timeMs;     // millis() on the device
+  uint8_t buttonId;
+  uint8_t buttonPin;
+  ButtonAction action;
+  const char *name;    // Not terminated; valid during the callback
+  uint8_t nameLength;
+};
+
+// Decodes segments written by ScreenRecorder, rebuilding every recorded frame.
+// Segments are independent; play them in increasing sequence order to follow
+// a recording across the ring.
+class ScreenPlayer
+{
+public:
+  // 'frame' is the full page-major frame (header().width x header().pages * 8)
+  using FrameHandler = std::function<void(uint32_t timeMs, const uint8_t *frame)>;
+  using EventHandler = std::function<void(const RecordedEvent &event)>;
+
+  void onFrame(FrameHandler handler) { frameHandler = handler; }
+  void onEvent(EventHandler handler) { eventHandler = handler; }
+
+  // Reads the header of a segment image; false if it is not one
+  static bool readHeader(const uint8_t *data, size_t size, record::Header &header);
+
+  // Replays one whole segment image. Returns false if it is not a segment.
+  // Decoding stops at the first incomplete or malformed record, which
+  // isTruncated() then reports: the last record of a segment may have been
+  // cut off by a reset while it was being written.
+  bool play(const uint8_t *data, size_t size);
+
+  const record::Header &header() const { return segmentHeader; }
+  bool isTruncated() const { return truncated; }
+  unsigned long getFramesPlayed() const { return framesPlayed; }
+  unsigned long getEventsPlayed() const { return eventsPlayed; }
+
+private:
+  FrameHandler frameHandler;
+  EventHandler eventHandler;
+  record::Header segmentHeader;
+  std::vector<uint8_t> frame;
+  bool haveKeyframe = false;
+  bool truncated = false;
+  unsigned long framesPlayed = 0;
+  unsigned long eventsPlayed = 0;
+
+  const uint8_t *playFrame(const uint8_t *in, const uint8_t *end, bool keyframe);
+};
+
+#endif // SCREEN_PLAYER_H
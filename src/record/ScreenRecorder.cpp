@@ -0,0 +1,262 @@
+#include "ScreenRecorder.h"
+#include "RecordFormat.h"
+#include "../platform/Profiler.h"
+#include "../platform/Clock.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+  constexpr size_t MAX_EVENT_NAME = 32;
+}
+
+ScreenRecorder::ScreenRecorder(int width, int height)
+    : width(width), pages(height / 8), frameSize(width * (height / 8))
+{
+  maxRecord = 1 + 5 + (pages + 7) / 8 + pages * record::maxPageSize(width);
+  previous = new uint8_t[frameSize];
+  pendingCapacity = 2 * maxRecord; // Room for a rotation keyframe and the record after it
+  pending = new uint8_t[pendingCapacity];
+}
+
+ScreenRecorder::~ScreenRecorder()
+{
+  end();
+  delete[] previous;
+  delete[] pending;
+}
+
+void ScreenRecorder::segmentPath(const char *basePath, uint8_t index, char *out, size_t size)
+{
+  snprintf(out, size, "%s%u.rec", basePath, index);
+}
+
+bool ScreenRecorder::begin(const char *basePath, size_t maxBytes)
+{
+  end();
+  if (pages <= 0 || pages > record::MAX_PAGES || strlen(basePath) + 8 > sizeof(this->basePath))
+    return false;
+  segmentLimit = maxBytes / SEGMENTS;
+  if (segmentLimit < record::HEADER_SIZE + 4 * maxRecord)
+    return false;
+  strcpy(this->basePath, basePath);
+
+  // Continue the sequence and overwrite the oldest (or an unreadable) segment
+  bool valid[SEGMENTS];
+  uint32_t sequences[SEGMENTS];
+  for (uint8_t i = 0; i < SEGMENTS; i++)
+  {
+    char path[PATH_SIZE];
+    segmentPath(basePath, i, path, sizeof(path));
+    uint8_t start[record::HEADER_SIZE];
+    record::Header header;
+    valid[i] = RecordStorage::readStart(path, start, sizeof(start)) && record::readHeader(start, header);
+    sequences[i] = header.sequence;
+  }
+
+  uint8_t oldest = 0;
+  sequence = 0;
+  for (uint8_t i = 0; i < SEGMENTS; i++)
+  {
+    if (!valid[i])
+    {
+      if (valid[oldest])
+        oldest = i;
+      continue;
+    }
+    if (sequences[i] >= sequence)
+      sequence = sequences[i] + 1;
+    if (valid[oldest] && sequences[i] < sequences[oldest])
+      oldest = i;
+  }
+
+  havePrevious = false;
+  pendingSize = 0;
+  recordsSinceFlush = 0;
+  eventsPending = false;
+  recording = startSegment(oldest, Clock::now());
+  return recording;
+}
+
+void ScreenRecorder::end()
+{
+  if (recording)
+    flush();
+  storage.close();
+  recording = false;
+}
+
+// Closes the current segment and restarts 'index' with the current sequence.
+// A recording in progress continues with a keyframe of the last frame.
+bool ScreenRecorder::startSegment(uint8_t index, unsigned long now)
+{
+  if (!writePending())
+    return false;
+  storage.close();
+
+  char path[PATH_SIZE];
+  segmentPath(basePath, index, path, sizeof(path));
+  record::Header header;
+  header.pages = pages;
+  header.width = width;
+  header.sequence = sequence;
+  header.startMs = now;
+  uint8_t start[record::HEADER_SIZE];
+  record::writeHeader(start, header);
+  if (!storage.create(path) || !storage.write(start, sizeof(start)))
+  {
+    stop();
+    return false;
+  }
+  storage.flush();
+
+  segment = index;
+  segmentSize = sizeof(start);
+  lastTime = now;
+  if (havePrevious)
+  {
+    putRecordHeader(record::KEYFRAME, now);
+    putKeyframe(previous);
+  }
+  return true;
+}
+
+// Makes room for a record of up to 'size' bytes, moving on to the next
+// segment when the current one would overflow
+bool ScreenRecorder::reserve(size_t size, unsigned long now)
+{
+  if (segmentSize + pendingSize + size > segmentLimit)
+  {
+    sequence++;
+    if (!startSegment((segment + 1) % SEGMENTS, now))
+      return false;
+  }
+  if (pendingSize + size > pendingCapacity)
+    return writePending();
+  return true;
+}
+
+bool ScreenRecorder::writePending()
+{
+  if (pendingSize == 0)
+    return true;
+  if (!storage.write(pending, pendingSize))
+  {
+    stop(); // File system full or gone; keep the UI running without recording
+    return false;
+  }
+  segmentSize += pendingSize;
+  bytesRecorded += pendingSize;
+  pendingSize = 0;
+  return true;
+}
+
+void ScreenRecorder::putRecordHeader(uint8_t type, unsigned long now)
+{
+  pending[pendingSize++] = type;
+  pendingSize += record::putVarint(pending + pendingSize, static_cast<uint32_t>(now) - lastTime);
+  lastTime = now;
+}
+
+void ScreenRecorder::putKeyframe(const uint8_t *frame)
+{
+  for (int page = 0; page < pages; page++)
+    pendingSize += record::encodePage(nullptr, frame + page * width, width, pending + pendingSize);
+}
+
+void ScreenRecorder::stop()
+{
+  storage.close();
+  recording = false;
+  pendingSize = 0;
+}
+
+void ScreenRecorder::recordFrame(const uint8_t *frame, unsigned long now)
+{
+  if (!recording)
+    return;
+  PROFILE_SCOPE("ScreenRecorder::recordFrame");
+
+  uint8_t mask[(record::MAX_PAGES + 7) / 8] = {};
+  if (havePrevious)
+  {
+    bool changed = false;
+    for (int page = 0; page < pages; page++)
+    {
+      if (memcmp(previous + page * width, frame + page * width, width) != 0)
+      {
+        mask[page / 8] |= 1 << (page % 8);
+        changed = true;
+      }
+    }
+    if (!changed)
+      return; // Nothing new on screen
+  }
+
+  if (!reserve(maxRecord, now))
+    return;
+
+  if (!havePrevious)
+  {
+    putRecordHeader(record::KEYFRAME, now);
+    putKeyframe(frame);
+  }
+  else
+  {
+    putRecordHeader(record::FRAME, now);
+    memcpy(pending + pendingSize, mask, (pages + 7) / 8);
+    pendingSize += (pages + 7) / 8;
+    for (int page = 0; page < pages; page++)
+    {
+      if (mask[page / 8] & (1 << (page % 8)))
+        pendingSize += record::encodePage(previous + page * width, frame + page * width, width, pending + pendingSize);
+    }
+  }
+
+  memcpy(previous, frame, frameSize);
+  havePrevious = true;
+  framesRecorded++;
+  if (++recordsSinceFlush >= FLUSH_INTERVAL)
+    flush();
+}
+
+void ScreenRecorder::recordEvent(const ButtonEvent &event, const char *name, unsigned long now)
+{
+  if (!recording)
+    return;
+
+  size_t nameLength = name ? strlen(name) : 0;
+  if (nameLength > MAX_EVENT_NAME)
+    nameLength = MAX_EVENT_NAME;
+  if (!reserve(1 + 5 + 4 + nameLength, now))
+    return;
+
+  putRecordHeader(record::EVENT, now);
+  pending[pendingSize++] = event.buttonId;
+  pending[pendingSize++] = event.buttonPin;
+  pending[pendingSize++] = static_cast<uint8_t>(event.action);
+  pending[pendingSize++] = static_cast<uint8_t>(nameLength);
+  memcpy(pending + pendingSize, name, nameLength);
+  pendingSize += nameLength;
+
+  eventsPending = true; // Committed by service() once the input goes idle
+  if (++recordsSinceFlush >= FLUSH_INTERVAL)
+    flush();
+}
+
+void ScreenRecorder::service(bool idle)
+{
+  if (idle && eventsPending)
+    flush();
+}
+
+void ScreenRecorder::flush()
+{
+  if (!recording)
+    return;
+  if (writePending())
+    storage.flush();
+  recordsSinceFlush = 0;
+  eventsPending = false;
+}
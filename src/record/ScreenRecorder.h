@@ -0,0 +1,100 @@
+#ifndef SCREEN_RECORDER_H
+#define SCREEN_RECORDER_H
+
+#include "RecordStorage.h"
+#include "../button/ButtonManager.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Records what the panel shows, and the input that led to it, into a bounded
+// flight log for post-mortem analysis (format in RecordFormat.h; replay it on
+// a host with the env:replay tool).
+//
+// Frames are stored as the pages that changed since the previous frame, so an
+// idle screen costs nothing and a cursor move a few dozen bytes. The log is a
+// ring of two segment files of maxBytes / 2 each: when the current one is full
+// the older is overwritten, so the last maxBytes / 2 to maxBytes of history are
+// always kept. Every segment starts with a keyframe and can be replayed alone.
+//
+// Records are collected in RAM and written in blocks; flush() commits them
+// every FLUSH_INTERVAL records, and service() once the input that was recorded
+// has gone idle, so a burst of events costs one commit and a crash loses at
+// most the records since then.
+class ScreenRecorder
+{
+public:
+  static constexpr size_t DEFAULT_MAX_BYTES = 512 * 1024; // Of the 768 KB spiffs partition
+  static constexpr unsigned FLUSH_INTERVAL = 32;           // Records between flushes
+  static constexpr uint8_t SEGMENTS = 2;
+
+  // 'width' x 'height' is the physical (unrotated) frame size
+  ScreenRecorder(int width = 128, int height = 64);
+  ~ScreenRecorder();
+
+  ScreenRecorder(const ScreenRecorder &) = delete;
+  ScreenRecorder &operator=(const ScreenRecorder &) = delete;
+
+  // Starts a new segment "<basePath><n>.rec" in place of the older one.
+  // Returns false if it cannot be created or maxBytes is too small.
+  bool begin(const char *basePath = "/screen", size_t maxBytes = DEFAULT_MAX_BYTES);
+
+  // Flushes and closes the current segment
+  void end();
+
+  // Adds a page-major frame (e.g. the panel buffer after display()) at millis() time 'now'
+  void recordFrame(const uint8_t *frame, unsigned long now);
+
+  // Adds an input event; 'name' (e.g. ButtonManager::name()) is stored with it
+  void recordEvent(const ButtonEvent &event, const char *name, unsigned long now);
+
+  // Flushes recorded input events when 'idle' (e.g. no button in progress).
+  // Call from loop().
+  void service(bool idle);
+
+  // Writes the collected records out and commits them to the file system
+  void flush();
+
+  bool isRecording() const { return recording; }
+  unsigned long getFramesRecorded() const { return framesRecorded; }
+  unsigned long getBytesRecorded() const { return bytesRecorded; }
+
+  // Path of segment 'index' for 'basePath'
+  static void segmentPath(const char *basePath, uint8_t index, char *out, size_t size);
+
+private:
+  static constexpr size_t PATH_SIZE = 32; // SPIFFS name limit, terminator included
+
+  int width;
+  int pages;
+  size_t frameSize;
+  size_t maxRecord;        // Largest record: a frame with every page changed
+  uint8_t *previous;       // Last recorded frame
+  bool havePrevious = false;
+
+  uint8_t *pending;        // Records not written to the file yet
+  size_t pendingSize = 0;
+  size_t pendingCapacity;
+
+  RecordStorage storage;
+  char basePath[24] = {};
+  size_t segmentLimit = 0; // Bytes per segment file
+  size_t segmentSize = 0;  // Bytes written to the current one
+  uint8_t segment = 0;
+  uint32_t sequence = 0;
+  uint32_t lastTime = 0;   // Of the last record, for the deltas
+
+  bool recording = false;
+  unsigned recordsSinceFlush = 0;
+  bool eventsPending = false; // Input events not committed yet
+  unsigned long framesRecorded = 0;
+  unsigned long bytesRecorded = 0;
+
+  bool startSegment(uint8_t index, unsigned long now);
+  bool reserve(size_t size, unsigned long now);
+  bool writePending();
+  void putRecordHeader(uint8_t type, unsigned long now);
+  void putKeyframe(const uint8_t *frame);
+  void stop();
+};
+
+#endif // SCREEN_RECORDER_H
@@ -1,68 +1,46 @@
 #include "StatusBar.h"
 
-void StatusBar::draw() {
-  if (downPosition) {
-    int displayH = display.height();
-    
-    if (statusBarBgColor == 0) {
-      display.drawFastHLine(0 + offsetX, displayH - offsetY - statusBarHeight, statusBarWidth - offsetX, 1);  // Transparent status bar
-    } else {
-      display.fillRect(0 + offsetX, displayH - offsetY - statusBarHeight, statusBarWidth - offsetX, statusBarHeight, statusBarBgColor);  // Filled top bar
-    }
-  } else {
-    if (statusBarBgColor == 0) {
-      display.drawFastHLine(0 + offsetX, statusBarHeight + offsetY, statusBarWidth - offsetX, 1);  // Transparent status bar
-    } else {
-      display.fillRect(0 + offsetX, 0 + offsetY, statusBarWidth - offsetX, statusBarHeight, statusBarBgColor);  // Filled top bar
-    }
+// Area covered by the bar, including the separator line of a transparent bar
+Rect StatusBar::getBarBounds() const {
+  int top = downPosition ? display.height() - offsetY - statusBarHeight : 0 + offsetY;
+  int height = statusBarHeight;
+  if (statusBarBgColor == 0 && !downPosition) {
+    height++;  // The line sits just below the bar
   }
-  drawLeftElements();
-  drawRightElements();
+  return Rect(0 + offsetX, top, statusBarWidth - offsetX, height);
 }
 
-void StatusBar::drawLeftElements() const {
-
-  int displayH = display.height();
-  int x = 0;
+bool StatusBar::isInvalid() const {
+  if (Widget::isInvalid()) {
+    return true;
+  }
   for (const auto& item : leftElements) {
-    if (item) {
-      item->setPosition(StatusBarElementPosition::LEFT);
-      item->setColor(statusBarBgColor == 1 ? 0 : 1);
-      int itemYoffset = item->getOffsetY();
-      int itemXoffset = item->getOffsetX();
-      if (downPosition) {
-        int displayH = display.height();
-        int itemHeight = item->getHeight();
-        item->draw(display, x + offsetX + itemXoffset ,  displayH - offsetY - itemHeight - itemYoffset);
-      } else {
-        item->draw(display, x + offsetX + itemXoffset, 0 + offsetY + itemYoffset);
-      }
-      
-      x += item->getWidth() + elementSpacing;
-    }
+    if (item && item->isInvalid()) return true;
+  }
+  for (const auto& item : rightElements) {
+    if (item && item->isInvalid()) return true;
   }
+  return false;
 }
 
+void StatusBar::markDrawn() {
+  Widget::markDrawn();
+  for (const auto& item : leftElements) {
+    if (item) item->markDrawn();
+  }
+  for (const auto& item : rightElements) {
+    if (item) item->markDrawn();
+  }
+}
 
-void StatusBar::drawRightElements() const {
-  int x = statusBarWidth - offsetX;
-  for (auto it = rightElements.rbegin(); it != rightElements.rend(); ++it) {
-    if (*it) {
-      const auto& item = *it;
-      int itemWidth = item->getWidth();
-      x -= itemWidth;
-      item->setPosition(StatusBarElementPosition::RIGHT);
-      item->setColor(statusBarBgColor == 1 ? 0 : 1);  // Invert text color for contrast
-      int itemYoffset = item->getOffsetY();
-      int itemXoffset = item->getOffsetX();
-      if (downPosition) {
-        int displayH = display.height();
-        int itemHeight = item->getHeight();
-        item->draw(display,x + offsetX - itemXoffset, displayH - offsetY - itemHeight - itemYoffset);
-      } else {
-        item->draw(display,x + offsetX - itemXoffset, 0 + offsetY + itemYoffset);
-      }
-      x -= elementSpacing;
-    }
+// Earliest deadline of the elements (e.g. the blinking clock colon)
+unsigned long StatusBar::nextDeadline(unsigned long now) const {
+  unsigned long deadline = NO_DEADLINE;
+  for (const auto& item : leftElements) {
+    if (item) deadline = earliest(deadline, item->nextDeadline(now));
   }
-}
\ No newline at end of file
+  for (const auto& item : rightElements) {
+    if (item) deadline = earliest(deadline, item->nextDeadline(now));
+  }
+  return deadline;
+}
@@ -6,9 +6,13 @@
 #include <memory>              // For smart pointers
 #include <stack>               // For menu history stack
 #include "StatusBarElement.h"  // Status bar element interface
+#include "../ui/Widget.h"      // Invalidation and animation deadlines
+#include "../ui/DamageList.h"  // Retained-mode repaint areas
+#include "../platform/Profiler.h"  // Frame timing
+#include "../platform/Clock.h"     // UI time source
 #include <Arduino.h>
 
-class StatusBar {
+class StatusBar : public Widget {
 private:
   DisplayInterface& display;
   std::vector<std::shared_ptr<StatusBarElement>> leftElements;   // Left-aligned status bar elements
@@ -22,8 +26,11 @@ private:
   bool downPosition = false;
 
 
-  void drawLeftElements() const;   // Draw left status bar elements
-  void drawRightElements() const;  // Draw right status bar elements
+  template <typename Visit>
+  void forEachElement(Visit visit) const;  // Lays out left then right elements
+  Rect getBarBounds() const;               // Area covered by the bar
+  template <typename Display>
+  void drawBackground(Display& target) const;  // Fill or separator line
 
 public:
 
@@ -33,21 +40,25 @@ public:
   // Set spacing between status bar elements
   void setElementSpacing(int spacing) {
     elementSpacing = spacing;
+    invalidate();
   }
 
   // Add element to left side of status bar
   void addLeftElement(std::shared_ptr<StatusBarElement> element) {
     leftElements.push_back(element);
+    invalidate();
   }
 
   // Add element to right side of status bar
   void addRightElement(std::shared_ptr<StatusBarElement> element) {
     rightElements.push_back(element);
+    invalidate();
   }
 
   // Set status bar background color
   void setStatusBarBgColor(int color) {
     statusBarBgColor = color;
+    invalidate();
   }
 
   // Get current status bar color
@@ -58,14 +69,17 @@ public:
   // Set status bar height
   void setStatusBarHeight(int height) {
     statusBarHeight = height;
+    invalidate();
   }
 
   void setStatusBarWidth(int width) {
     statusBarWidth = width;
+    invalidate();
   }
 
   void setOffsetX(int xx) {
     offsetX = xx;
+    invalidate();
   }
 
   int getOffsetX() {
@@ -74,6 +88,7 @@ public:
 
   void setOffsetY(int yy) {
     offsetY = yy;
+    invalidate();
   }
 
   int getOffsetY() {
@@ -82,12 +97,130 @@ public:
 
   void setDownPosition(bool setDown){
     downPosition = setDown;
+    invalidate();
   }
 
   bool getDownPosition(){
     return downPosition;
   }
 
-  void draw();
+  void draw() { draw(display); }
+
+  // Same, calling the primitives on the concrete display type (see
+  // DisplayInterface.h); 'target' must be the display given to the constructor.
+  // Elements still draw through DisplayInterface.
+  template <typename Display>
+  void draw(Display& target);
+
+  // The bar is invalid when it or one of its elements changed
+  bool isInvalid() const override;
+  void markDrawn() override;
+  unsigned long nextDeadline(unsigned long now) const override;
 };
-#endif
\ No newline at end of file
+
+// Calls visit(item, rect) for every element with the area it is drawn in,
+// after giving it the alignment and color of its side of the bar
+template <typename Visit>
+void StatusBar::forEachElement(Visit visit) const {
+  const int displayH = display.height();
+  const int itemColor = statusBarBgColor == 1 ? 0 : 1;  // Invert text color for contrast
+
+  int x = 0;
+  for (const auto& item : leftElements) {
+    if (item) {
+      item->setPosition(StatusBarElementPosition::LEFT);
+      item->setColor(itemColor);
+      int itemYoffset = item->getOffsetY();
+      int itemXoffset = item->getOffsetX();
+      int itemHeight = item->getHeight();
+      int drawX = x + offsetX + itemXoffset;
+      int drawY = downPosition ? displayH - offsetY - itemHeight - itemYoffset : 0 + offsetY + itemYoffset;
+      visit(*item, Rect(drawX, drawY, item->getWidth(), itemHeight));
+
+      x += item->getWidth() + elementSpacing;
+    }
+  }
+
+  x = statusBarWidth - offsetX;
+  for (auto it = rightElements.rbegin(); it != rightElements.rend(); ++it) {
+    if (*it) {
+      const auto& item = *it;
+      int itemWidth = item->getWidth();
+      x -= itemWidth;
+      item->setPosition(StatusBarElementPosition::RIGHT);
+      item->setColor(itemColor);
+      int itemYoffset = item->getOffsetY();
+      int itemXoffset = item->getOffsetX();
+      int itemHeight = item->getHeight();
+      int drawX = x + offsetX - itemXoffset;
+      int drawY = downPosition ? displayH - offsetY - itemHeight - itemYoffset : 0 + offsetY + itemYoffset;
+      visit(*item, Rect(drawX, drawY, itemWidth, itemHeight));
+      x -= elementSpacing;
+    }
+  }
+}
+
+template <typename Display>
+void StatusBar::drawBackground(Display& target) const {
+  if (downPosition) {
+    int displayH = display.height();
+    
+    if (statusBarBgColor == 0) {
+      target.drawFastHLine(0 + offsetX, displayH - offsetY - statusBarHeight, statusBarWidth - offsetX, 1);  // Transparent status bar
+    } else {
+      target.fillRect(0 + offsetX, displayH - offsetY - statusBarHeight, statusBarWidth - offsetX, statusBarHeight, statusBarBgColor);  // Filled top bar
+    }
+  } else {
+    if (statusBarBgColor == 0) {
+      target.drawFastHLine(0 + offsetX, statusBarHeight + offsetY, statusBarWidth - offsetX, 1);  // Transparent status bar
+    } else {
+      target.fillRect(0 + offsetX, 0 + offsetY, statusBarWidth - offsetX, statusBarHeight, statusBarBgColor);  // Filled top bar
+    }
+  }
+}
+
+// In retained mode only elements that changed, moved or have an animation step
+// due are repainted, on the bar background and clipped to the bar
+template <typename Display>
+void StatusBar::draw(Display& target) {
+  PROFILE_SCOPE("StatusBar::draw");
+  const Rect bounds = getBarBounds();
+  const unsigned long now = Clock::now();
+  const bool full = needsFullRepaint(bounds);
+  DamageList damage;
+
+  if (full) {
+    if (isRetained()) {
+      damage.add(getDrawnBounds());
+      damage.add(bounds);
+      damage.erase(target);
+    }
+    drawBackground(target);
+  } else {
+    forEachElement([&](StatusBarElement& item, const Rect& rect) {
+      if (item.needsRepaint(rect, now)) {
+        damage.add(item.getDrawnBounds().intersected(bounds));
+        damage.add(rect.intersected(bounds));
+      }
+    });
+    damage.erase(target, statusBarBgColor == 0 ? 0 : 1);
+    if (statusBarBgColor == 0 && !damage.isEmpty()) {
+      drawBackground(target);  // Only a line, redrawing it is harmless
+    }
+  }
+
+  // Elements wider than their slot are cut at the bar edge
+  ScopedClip clip(target, bounds);
+
+  forEachElement([&](StatusBarElement& item, const Rect& rect) {
+    if ((full || damage.intersects(rect)) && target.isVisible(rect)) {
+      item.draw(target, rect.x, rect.y);
+      item.markDrawn();
+    }
+    item.setDrawnBounds(rect);
+  });
+
+  setDrawnBounds(bounds);
+}
+
+#endif // STATUS_BAR_H
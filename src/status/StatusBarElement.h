@@ -2,6 +2,8 @@
 #define STATUS_BAR_ELEMENT_H
 
 #include "../display/DisplayInterface.h"
+#include "../ui/Widget.h"
+#include "../platform/Profiler.h"
 
 // Enum to define possible positions of a status bar element
 enum class StatusBarElementPosition {
@@ -9,8 +11,9 @@ enum class StatusBarElementPosition {
     RIGHT   // Element will be aligned to the right side
 };
 
-// Base class for elements displayed in a status bar
-class StatusBarElement {
+// Base class for elements displayed in a status bar.
+// Subclasses call invalidate() when the value they show changes.
+class StatusBarElement : public Widget {
 protected:
     int x = 0;        // Horizontal offset for positioning
     int y = 0;
@@ -30,8 +33,8 @@ public:
     virtual int getWidth() { return 0; }
     virtual int getHeight() { return 0; }
 
-    virtual void setOffsetX(int dx) { offsetX = dx; }
-    virtual void setOffsetY(int dy) { offsetY = dy; }
+    virtual void setOffsetX(int dx) { offsetX = dx; invalidate(); }
+    virtual void setOffsetY(int dy) { offsetY = dy; invalidate(); }
     virtual int getOffsetX() const { return offsetX; }
     virtual int getOffsetY() const { return offsetY; }
 
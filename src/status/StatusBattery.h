@@ -2,19 +2,17 @@
 #define STATUS_BATTERY_H
 
 #include "StatusBarElement.h"
+#include "StatusIcons.h"
 #include "../display/DisplayInterface.h"
 #include <Arduino.h>
 
 // StatusBattery represents a visual battery indicator using pixel art.
 // Inherits from StatusBarElement to integrate into a status bar system.
+// The icons come from the STATUS_ICONS atlas (StatusIcons.h).
 class StatusBattery : public StatusBarElement {
 private:
-  // Static 2D arrays that define the pixel representation of various battery states
-  static const uint8_t BATTERY_FULL[9][14];     // Icon for 100% battery
-  static const uint8_t BATTERY_65[9][14];       // Icon for ~65% battery
-  static const uint8_t BATTERY_30[9][14];       // Icon for ~30% battery
-  static const uint8_t BATTERY_EMPTY[9][14];    // Icon for 0% battery
-  static const uint8_t BATTERY_CHARGING[9][14]; // Icon for charging state
+  // Percentage right-aligned in 3 digits ("  5%", " 45%", "100%")
+  static constexpr auto PERCENT_FORMAT = makeFormat<int>("%3d%%");
 
   // Battery status and display configuration
   int level = 100;            // Battery level percentage (0 to 100)
@@ -0,0 +1,96 @@
+#ifndef STATUS_ICONS_H
+#define STATUS_ICONS_H
+
+#include "../display/Sprite.h"
+
+// Icons used by status bar elements, generated at compile time from the
+// ASCII art below and stored in flash in the SH1106 page layout.
+
+// Full battery icon (100% charge)
+inline constexpr auto ICON_BATTERY_FULL = makeSprite<14, 9>(
+    "  ############"
+    "  #          #"
+    "### ## ## ## #"
+    "#   ## ## ## #"
+    "#   ## ## ## #"
+    "#   ## ## ## #"
+    "### ## ## ## #"
+    "  #          #"
+    "  ############");
+
+// 65% battery icon (similar structure but with fewer bars)
+inline constexpr auto ICON_BATTERY_65 = makeSprite<14, 9>(
+    "  ############"
+    "  #          #"
+    "### ## ##    #"
+    "#   ## ##    #"
+    "#   ## ##    #"
+    "#   ## ##    #"
+    "### ## ##    #"
+    "  #          #"
+    "  ############");
+
+// 30% battery icon (only one bar visible)
+inline constexpr auto ICON_BATTERY_30 = makeSprite<14, 9>(
+    "  ############"
+    "  #          #"
+    "### ##       #"
+    "#   ##       #"
+    "#   ##       #"
+    "#   ##       #"
+    "### ##       #"
+    "  #          #"
+    "  ############");
+
+// Empty battery icon (no bars visible)
+inline constexpr auto ICON_BATTERY_EMPTY = makeSprite<14, 9>(
+    "  ############"
+    "  #          #"
+    "###          #"
+    "#            #"
+    "#            #"
+    "#            #"
+    "###          #"
+    "  #          #"
+    "  ############");
+
+// Charging battery icon (with lightning Plug symbol)
+inline constexpr auto ICON_BATTERY_CHARGING = makeSprite<14, 9>(
+    "  ############"
+    "  #          #"
+    "###     ##   #"
+    "#      ##### #"
+    "#   ######   #"
+    "#      ##### #"
+    "###     ##   #"
+    "  #          #"
+    "  ############");
+
+// Index of each icon in STATUS_ICONS
+enum class StatusIcon : uint8_t {
+  BATTERY_FULL,
+  BATTERY_65,
+  BATTERY_30,
+  BATTERY_EMPTY,
+  BATTERY_CHARGING,
+  COUNT
+};
+
+// Atlas of all status icons, indexed by StatusIcon
+inline constexpr SpriteEntry STATUS_ICONS[] = {
+    {"battery_full", ICON_BATTERY_FULL.bitmap()},
+    {"battery_65", ICON_BATTERY_65.bitmap()},
+    {"battery_30", ICON_BATTERY_30.bitmap()},
+    {"battery_empty", ICON_BATTERY_EMPTY.bitmap()},
+    {"battery_charging", ICON_BATTERY_CHARGING.bitmap()},
+};
+
+static_assert(sizeof(STATUS_ICONS) / sizeof(STATUS_ICONS[0]) == static_cast<size_t>(StatusIcon::COUNT),
+              "STATUS_ICONS must have one entry per StatusIcon");
+
+inline const Bitmap &statusIcon(StatusIcon icon)
+{
+  return STATUS_ICONS[static_cast<uint8_t>(icon)].bitmap;
+}
+
+#endif // STATUS_ICONS_H
@@ -3,32 +3,36 @@
 
 #include "StatusBarElement.h"
 #include "../display/DisplayInterface.h"
+#include "../platform/Clock.h"
 #include <Arduino.h>
 
 class StatusTime : public StatusBarElement {
 private:
+  // The colon blinks, so the minutes keep their place when it is hidden
+  static constexpr auto TIME_FORMAT = makeFormat<int, int>("%02d:%02d");
+  static constexpr auto TIME_FORMAT_NO_COLON = makeFormat<int, int>("%02d %02d");
+
   int hours;
   int minutes;
   unsigned long lastUpdateMillis = 0;
+  unsigned long lastDrawMillis = 0;  // When the colon state on screen was chosen
 
 public:
   StatusTime()  = default;
 
   void draw(DisplayInterface& display, int xx = 0, int yy = 0) override {
+  PROFILE_SCOPE("StatusTime::draw");
   int drawX = x + xx;
   int drawY = y + yy;
 
   // Calculate if colon should be visible this frame (blinking every second)
-  bool showColon = (millis() / 500) % 2 == 0;
+  lastDrawMillis = Clock::now();
+  bool showColon = (lastDrawMillis / 500) % 2 == 0;
 
   display.setTextColor(color);
   display.setTextSize(1);
   display.setCursor(drawX, drawY);
-  if (showColon) {
-    display.printf("%02d:%02d", hours, minutes);
-  } else {
-    display.printf("%02d %02d", hours, minutes); // Space instead of colon
-  }
+  display.print(showColon ? TIME_FORMAT : TIME_FORMAT_NO_COLON, hours, minutes);
 }
 
   int getWidth() override {
@@ -42,11 +46,17 @@ public:
   void setTime(int h, int m) {
     hours = h % 24;
     minutes = m % 60;
+    invalidate();
+  }
+
+  // The colon blinks on Clock::now() / 500
+  unsigned long nextDeadline(unsigned long /*now*/) const override {
+    return nextMultiple(lastDrawMillis, 500);
   }
 
   /// Actualizează ora internă la fiecare minut
   void update() {
-    unsigned long now = millis();
+    unsigned long now = Clock::now();
     if (now - lastUpdateMillis >= 60000 || lastUpdateMillis == 0) {
       lastUpdateMillis = now;
       minutes++;
@@ -54,6 +64,7 @@ public:
         minutes = 0;
         hours = (hours + 1) % 24;
       }
+      invalidate();
     }
   }
 };
@@ -0,0 +1,83 @@
+#ifndef DAMAGE_LIST_H
+#define DAMAGE_LIST_H
+
+#include "Rect.h"
+#include "../display/DisplayInterface.h"
+#include <stdint.h>
+
+// Areas of a retained widget that have to be repainted in the current frame.
+// Overlapping rectangles are merged; when the list is full everything collapses
+// into one bounding box, which repaints more but never misses anything.
+//
+// Repainting is two steps: erase() clears the areas, then the widget redraws
+// every part that intersects() them. Parts are drawn whole, so parts outside
+// the damage must draw idempotently (drawing them again over themselves must
+// not change the frame), which holds for the OR-style drawing used by the views.
+class DamageList
+{
+public:
+  static constexpr uint8_t CAPACITY = 8;
+
+  void add(const Rect &rect)
+  {
+    if (rect.isEmpty())
+      return;
+
+    Rect merged = rect;
+    for (uint8_t i = 0; i < count;)
+    {
+      if (rects[i].intersects(merged))
+      {
+        merged = merged.united(rects[i]);
+        rects[i] = rects[--count]; // Recheck the merged rectangle against the rest
+        i = 0;
+      }
+      else
+      {
+        i++;
+      }
+    }
+
+    if (count == CAPACITY)
+    {
+      for (uint8_t i = 0; i < count; i++)
+        merged = merged.united(rects[i]);
+      count = 0;
+    }
+    rects[count++] = merged;
+  }
+
+  bool intersects(const Rect &rect) const
+  {
+    for (uint8_t i = 0; i < count; i++)
+    {
+      if (rects[i].intersects(rect))
+        return true;
+    }
+    return false;
+  }
+
+  // Fills every area with 'color' and reports it to the display, which is
+  // a DisplayInterface or a concrete display type
+  template <typename Display>
+  void erase(Display &display, int color = 0) const
+  {
+    for (uint8_t i = 0; i < count; i++)
+    {
+      const Rect &r = rects[i];
+      display.fillRect(r.x, r.y, r.w, r.h, color);
+      display.invalidateRect(r.x, r.y, r.w, r.h);
+    }
+  }
+
+  void clear() { count = 0; }
+  bool isEmpty() const { return count == 0; }
+  uint8_t size() const { return count; }
+  const Rect &operator[](uint8_t index) const { return rects[index]; }
+
+private:
+  Rect rects[CAPACITY];
+  uint8_t count = 0;
+};
+
+#endif // DAMAGE_LIST_H
@@ -0,0 +1,110 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include "Widget.h"
+#include "../platform/Threading.h"
+#include <vector>
+
+// Decides when the main loop has to render and lets it sleep in between.
+// A frame is due when a registered widget is invalid or one of its deadlines
+// has passed; otherwise the loop blocks in waitForWork() until the next
+// deadline, an explicit wake() or the input poll interval elapses.
+class FrameScheduler
+{
+public:
+  explicit FrameScheduler(unsigned long pollIntervalMs = 10)
+      : pollInterval(pollIntervalMs) {}
+
+  // Registers a top-level widget drawn by the loop
+  void addWidget(Widget &widget)
+  {
+    widgets.push_back(&widget);
+  }
+
+  // True if something has to be rendered at time 'now'
+  bool frameDue(unsigned long now) const
+  {
+    if (suspended)
+      return false;
+    for (const Widget *widget : widgets)
+    {
+      if (widget->isInvalid() || Widget::isDue(widget->nextDeadline(now), now))
+        return true;
+    }
+    return false;
+  }
+
+  // Must be called after every rendered frame
+  void frameDrawn()
+  {
+    for (Widget *widget : widgets)
+    {
+      widget->markDrawn();
+    }
+    framesRendered++;
+  }
+
+  // Earliest widget deadline after 'now', or Widget::NO_DEADLINE
+  unsigned long nextDeadline(unsigned long now) const
+  {
+    unsigned long deadline = Widget::NO_DEADLINE;
+    if (suspended)
+      return deadline;
+    for (const Widget *widget : widgets)
+      deadline = Widget::earliest(deadline, widget->nextDeadline(now));
+    return deadline;
+  }
+
+  // Sleeps until the next widget deadline, 'inputDeadline' (e.g. a pending
+  // click classification), a wake() call or the poll interval, whichever is first
+  void waitForWork(unsigned long now, unsigned long inputDeadline = Widget::NO_DEADLINE)
+  {
+    if (frameDue(now))
+      return;
+
+    unsigned long wait = suspended ? suspendedPollInterval : pollInterval;
+    unsigned long deadline = Widget::earliest(nextDeadline(now), inputDeadline);
+    if (deadline != Widget::NO_DEADLINE)
+    {
+      if (Widget::isDue(deadline, now))
+        return;
+      if (deadline - now < wait)
+        wait = deadline - now;
+    }
+
+    wakeSignal.take(wait);
+  }
+
+  // Ends a pending waitForWork() early
+  void wake()
+  {
+    wakeSignal.give();
+  }
+
+  // wake() for interrupt handlers (e.g. a button edge)
+  void wakeFromISR()
+  {
+    wakeSignal.giveFromISR();
+  }
+
+  // While suspended no frame is due (widgets keep their invalid state for
+  // the first frame after resuming) and waitForWork() polls the inputs at
+  // the slower suspended poll interval
+  void setSuspended(bool suspend) { suspended = suspend; }
+  bool isSuspended() const { return suspended; }
+  void setSuspendedPollInterval(unsigned long ms) { suspendedPollInterval = ms; }
+
+  void setPollInterval(unsigned long ms) { pollInterval = ms; }
+  unsigned long getPollInterval() const { return pollInterval; }
+  unsigned long getFramesRendered() const { return framesRendered; }
+
+private:
+  std::vector<Widget *> widgets;
+  unsigned long pollInterval; // Longest sleep while inputs are polled
+  unsigned long suspendedPollInterval = 50;
+  bool suspended = false;
+  unsigned long framesRendered = 0;
+  Signal wakeSignal;
+};
+
+#endif // FRAME_SCHEDULER_H
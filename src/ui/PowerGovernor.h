@@ -0,0 +1,155 @@
+#ifndef POWER_GOVERNOR_H
+#define POWER_GOVERNOR_H
+
+#include "FrameScheduler.h"
+#include "Widget.h"
+#include "../button/ButtonManager.h"
+#include "../display/DisplayInterface.h"
+
+// Idle power management driven by the button input. After dimAfter ms
+// without input the panel contrast drops; after sleepAfter ms the panel is
+// switched off and the frame scheduler suspended, so nothing is rendered or
+// flushed until a button is pressed again. A timeout of 0 skips that stage.
+//
+// The press that wakes a sleeping screen is consumed: the events of that
+// gesture never reach the views, since the user could not see what the
+// press would do. On a dimmed screen the press restores the contrast and is
+// handled normally.
+class PowerGovernor
+{
+public:
+  enum class State
+  {
+    Active,
+    Dimmed,
+    Asleep
+  };
+
+  PowerGovernor(DisplayInterface &display, FrameScheduler &scheduler,
+                unsigned long dimAfterMs = 30000, unsigned long sleepAfterMs = 120000)
+      : display(display), scheduler(scheduler), dimAfter(dimAfterMs), sleepAfter(sleepAfterMs) {}
+
+  void setTimeouts(unsigned long dimAfterMs, unsigned long sleepAfterMs)
+  {
+    dimAfter = dimAfterMs;
+    sleepAfter = sleepAfterMs;
+  }
+
+  // Panel contrast (0 to 255) while active and while dimmed
+  void setContrast(uint8_t normal, uint8_t dimmed)
+  {
+    normalContrast = normal;
+    dimmedContrast = dimmed;
+    display.setContrast(state == State::Dimmed ? dimmedContrast : normalContrast);
+  }
+
+  // Call once per loop after ButtonManager::update(), with its isActive().
+  // Wakes a sleeping panel on a press and applies the timeouts.
+  void update(bool inputActive, unsigned long now)
+  {
+    if (swallowing && gestureOver)
+      swallowing = false; // Its events were all drained after the last update
+    gestureOver = !inputActive;
+
+    if (inputActive)
+    {
+      lastActivity = now;
+      if (state == State::Asleep)
+      {
+        enter(State::Active);
+        swallowing = true;
+      }
+      else if (state == State::Dimmed)
+      {
+        enter(State::Active);
+      }
+    }
+    else
+    {
+      applyTimeouts(now);
+    }
+  }
+
+  // Call for every event drained after update(); false if the event belongs
+  // to the press that woke the panel and must not be handled
+  bool accept(const ButtonEvent &/*event*/, unsigned long now)
+  {
+    lastActivity = now;
+    if (state == State::Asleep)
+    {
+      enter(State::Active);
+      swallowing = true;
+    }
+    else if (state == State::Dimmed)
+    {
+      enter(State::Active);
+    }
+    return !swallowing;
+  }
+
+  // Wakes the screen without consuming any input (e.g. for an alarm)
+  void wake(unsigned long now)
+  {
+    lastActivity = now;
+    enter(State::Active);
+  }
+
+  // millis() time of the next stage change, or Widget::NO_DEADLINE; pass it
+  // to FrameScheduler::waitForWork() so the change is not late
+  unsigned long nextDeadline() const
+  {
+    if (state == State::Active && dimAfter)
+      return lastActivity + dimAfter;
+    if (state != State::Asleep && sleepAfter)
+      return lastActivity + sleepAfter;
+    return Widget::NO_DEADLINE;
+  }
+
+  State getState() const { return state; }
+  bool isAsleep() const { return state == State::Asleep; }
+
+private:
+  DisplayInterface &display;
+  FrameScheduler &scheduler;
+  unsigned long dimAfter;
+  unsigned long sleepAfter;
+  uint8_t normalContrast = 0x2F;
+  uint8_t dimmedContrast = 0x01;
+
+  State state = State::Active;
+  unsigned long lastActivity = 0;
+  bool swallowing = false;  // Consuming the events of the waking gesture
+  bool gestureOver = false; // No button was active at the last update()
+
+  void applyTimeouts(unsigned long now)
+  {
+    if (sleepAfter && state != State::Asleep && Widget::isDue(lastActivity + sleepAfter, now))
+      enter(State::Asleep);
+    else if (dimAfter && state == State::Active && Widget::isDue(lastActivity + dimAfter, now))
+      enter(State::Dimmed);
+  }
+
+  void enter(State next)
+  {
+    if (next == state)
+      return;
+
+    if (next == State::Asleep)
+    {
+      display.setPowerSave(true);
+      scheduler.setSuspended(true);
+    }
+    else
+    {
+      display.setContrast(next == State::Dimmed ? dimmedContrast : normalContrast);
+      if (state == State::Asleep)
+      {
+        scheduler.setSuspended(false); // Widgets changed while asleep are drawn now
+        display.setPowerSave(false);
+      }
+    }
+    state = next;
+  }
+};
+
+#endif // POWER_GOVERNOR_H
@@ -0,0 +1,64 @@
+#ifndef RECT_H
+#define RECT_H
+
+// Axis-aligned rectangle in display coordinates; empty when w or h <= 0
+struct Rect
+{
+  int x = 0;
+  int y = 0;
+  int w = 0;
+  int h = 0;
+
+  constexpr Rect() = default;
+  constexpr Rect(int x, int y, int w, int h) : x(x), y(y), w(w), h(h) {}
+
+  bool isEmpty() const { return w <= 0 || h <= 0; }
+  int right() const { return x + w; }  // Exclusive
+  int bottom() const { return y + h; } // Exclusive
+
+  bool contains(int px, int py) const
+  {
+    return px >= x && px < right() && py >= y && py < bottom();
+  }
+
+  bool intersects(const Rect &other) const
+  {
+    return !isEmpty() && !other.isEmpty() &&
+           x < other.right() && other.x < right() &&
+           y < other.bottom() && other.y < bottom();
+  }
+
+  // Overlap of both rectangles (empty if they do not intersect)
+  Rect intersected(const Rect &other) const
+  {
+    int left = x > other.x ? x : other.x;
+    int top = y > other.y ? y : other.y;
+    int r = right() < other.right() ? right() : other.right();
+    int b = bottom() < other.bottom() ? bottom() : other.bottom();
+    if (r <= left || b <= top)
+      return Rect();
+    return Rect(left, top, r - left, b - top);
+  }
+
+  // Smallest rectangle containing both; empty rectangles are ignored
+  Rect united(const Rect &other) const
+  {
+    if (other.isEmpty())
+      return *this;
+    if (isEmpty())
+      return other;
+    int left = x < other.x ? x : other.x;
+    int top = y < other.y ? y : other.y;
+    int r = right() > other.right() ? right() : other.right();
+    int b = bottom() > other.bottom() ? bottom() : other.bottom();
+    return Rect(left, top, r - left, b - top);
+  }
+
+  bool operator==(const Rect &other) const
+  {
+    return x == other.x && y == other.y && w == other.w && h == other.h;
+  }
+  bool operator!=(const Rect &other) const { return !(*this == other); }
+};
+
+#endif // RECT_H
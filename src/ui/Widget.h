@@ -0,0 +1,109 @@
+#ifndef WIDGET_H
+#define WIDGET_H
+
+#include "Rect.h"
+#include <stdint.h>
+
+// Base class for everything that is drawn on screen and can tell the frame
+// scheduler when it needs to be drawn again.
+// A widget is invalid when its state changed since it was last drawn, and it
+// reports a deadline when its appearance changes by itself at a known time
+// (marquee scrolling, blinking cursors, clocks).
+//
+// Every change bumps the content version. In retained mode a view keeps the
+// previous frame on screen and repaints only the children whose version,
+// bounds or animation changed since they were drawn (see DamageList.h).
+class Widget
+{
+public:
+  static constexpr unsigned long NO_DEADLINE = ~0UL;
+
+  virtual ~Widget() = default;
+
+  // Marks the widget as needing a redraw
+  void invalidate() { version++; }
+
+  // Marks the widget as needing a full repaint of its area (geometry or layout changed)
+  void invalidateLayout()
+  {
+    layoutChanged = true;
+    invalidate();
+  }
+
+  // True if the widget (or one of its children) changed since it was last drawn
+  virtual bool isInvalid() const { return version != drawnVersion; }
+
+  // Called once the current state of the widget (and its children) is on screen
+  virtual void markDrawn() { drawnVersion = version; }
+
+  // millis() time at which the widget changes without input, or NO_DEADLINE
+  virtual unsigned long nextDeadline(unsigned long /*now*/) const { return NO_DEADLINE; }
+
+  // True if 'deadline' has been reached at time 'now' (safe across millis() overflow)
+  static bool isDue(unsigned long deadline, unsigned long now)
+  {
+    return deadline != NO_DEADLINE && static_cast<long>(now - deadline) >= 0;
+  }
+
+  // The sooner of two deadlines (safe across millis() overflow); NO_DEADLINE
+  // only if both are
+  static unsigned long earliest(unsigned long a, unsigned long b)
+  {
+    if (a == NO_DEADLINE)
+      return b;
+    if (b == NO_DEADLINE)
+      return a;
+    return static_cast<long>(a - b) < 0 ? a : b;
+  }
+
+  uint32_t getVersion() const { return version; }
+
+  // --- Retained mode ---
+  // When enabled, draw() relies on the screen still holding the previous frame
+  // (no clearDisplay() in between) and repaints only what changed.
+  void setRetained(bool enable)
+  {
+    retained = enable;
+    invalidateLayout();
+  }
+  bool isRetained() const { return retained; }
+
+  // Where the widget was drawn last (empty if it is not on screen)
+  const Rect &getDrawnBounds() const { return drawnBounds; }
+  void setDrawnBounds(const Rect &bounds)
+  {
+    drawnBounds = bounds;
+    layoutChanged = false;
+  }
+
+  // True if the widget must be repainted at 'bounds': its content changed,
+  // it moved, or one of its animations is due at 'now'
+  bool needsRepaint(const Rect &bounds, unsigned long now) const
+  {
+    return layoutChanged || isInvalid() || bounds != drawnBounds || isDue(nextDeadline(now), now);
+  }
+
+protected:
+  // True if a retained draw has to clear and repaint the whole area 'bounds'
+  bool needsFullRepaint(const Rect &bounds) const
+  {
+    return !retained || layoutChanged || bounds != drawnBounds;
+  }
+
+  // First multiple of 'period' after 'drawnAt', for effects driven by millis() % period.
+  // Pass the time of the last draw, not the current time, so the deadline
+  // stays due until the widget has been drawn again.
+  static unsigned long nextMultiple(unsigned long drawnAt, unsigned long period)
+  {
+    return (drawnAt / period + 1) * period;
+  }
+
+private:
+  uint32_t version = 1;      // Bumped on every change
+  uint32_t drawnVersion = 0; // Version on screen; nothing is drawn before the first frame
+  Rect drawnBounds;          // Area covered by the last draw
+  bool layoutChanged = true; // Whole area must be repainted
+  bool retained = false;
+};
+
+#endif // WIDGET_H
@@ -0,0 +1,202 @@
+// AsyncFlusher on the host (std::thread behind Threading.h): frames reach the
+// sink complete and in order, submit() waits while a frame is in flight, and
+// stop() sends the last frame before joining the worker.
+
+#include "display/AsyncFlusher.h"
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string.h>
+#include <thread>
+
+namespace
+{
+  constexpr int WIDTH = 128;
+  constexpr int HEIGHT = 64;
+  constexpr int FRAME_SIZE = WIDTH * HEIGHT / 8;
+
+  // Keeps a copy of the panel; can hold the worker inside writeSpan()
+  class RecordingSink : public PageSink
+  {
+  public:
+    uint8_t panel[FRAME_SIZE] = {};
+    std::atomic<int> spans{0};
+    std::atomic<bool> inSpan{false};
+
+    void writeSpan(uint8_t page, uint8_t x0, uint8_t x1, const uint8_t *frame) override
+    {
+      inSpan = true;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return !blocked; });
+      }
+      memcpy(panel + page * WIDTH + x0, frame + page * WIDTH + x0, x1 - x0 + 1);
+      spans++;
+      inSpan = false;
+    }
+
+    void block()
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      blocked = true;
+    }
+
+    void release()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        blocked = false;
+      }
+      condition.notify_all();
+    }
+
+  private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool blocked = false;
+  };
+
+  void fill(uint8_t *frame, uint8_t seed)
+  {
+    for (int i = 0; i < FRAME_SIZE; i++)
+      frame[i] = static_cast<uint8_t>(seed + i * 7);
+  }
+
+  bool waitFor(const std::atomic<bool> &flag, int timeoutMs)
+  {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!flag && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return flag;
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_submit_reaches_sink()
+{
+  RecordingSink sink;
+  AsyncFlusher flusher(sink, WIDTH, HEIGHT);
+  TEST_ASSERT_TRUE(flusher.start());
+  TEST_ASSERT_TRUE(flusher.isRunning());
+
+  uint8_t frame[FRAME_SIZE];
+  DirtyRegion damage(WIDTH, HEIGHT);
+  fill(frame, 1);
+  damage.markAll();
+  flusher.submit(frame, damage, true);
+  flusher.waitIdle();
+  TEST_ASSERT_EQUAL_MEMORY(frame, sink.panel, FRAME_SIZE);
+  TEST_ASSERT_EQUAL(FRAME_SIZE, flusher.getBytesSent());
+
+  // The UI may reuse its buffer as soon as submit() returns
+  frame[3 * WIDTH + 10] ^= 0xFF;
+  damage.clear();
+  damage.markRect(0, 24, WIDTH, 8);
+  flusher.submit(frame, damage, false);
+  fill(frame, 99);
+  flusher.waitIdle();
+  TEST_ASSERT_EQUAL(FRAME_SIZE + 1, flusher.getBytesSent()); // Only the changed byte
+  TEST_ASSERT_EQUAL(2, flusher.getFramesFlushed());
+  TEST_ASSERT_EQUAL_HEX8(static_cast<uint8_t>(1 + (3 * WIDTH + 10) * 7) ^ 0xFF, sink.panel[3 * WIDTH + 10]);
+
+  flusher.stop();
+}
+
+void test_submit_waits_for_frame_in_flight()
+{
+  RecordingSink sink;
+  AsyncFlusher flusher(sink, WIDTH, HEIGHT);
+  TEST_ASSERT_TRUE(flusher.start());
+
+  uint8_t first[FRAME_SIZE], second[FRAME_SIZE];
+  fill(first, 1);
+  fill(second, 2);
+  DirtyRegion damage(WIDTH, HEIGHT);
+  damage.markAll();
+
+  sink.block();
+  flusher.submit(first, damage, true);
+  TEST_ASSERT_TRUE(waitFor(sink.inSpan, 1000)); // Worker is inside the first frame
+
+  std::atomic<bool> submitted{false};
+  std::thread ui([&] {
+    flusher.submit(second, damage, true);
+    submitted = true;
+  });
+  TEST_ASSERT_FALSE(waitFor(submitted, 50)); // Back-pressure: blocked, not queued or dropped
+  TEST_ASSERT_EQUAL(0, flusher.getFramesFlushed());
+
+  sink.release();
+  ui.join();
+  flusher.waitIdle();
+  TEST_ASSERT_EQUAL(2, flusher.getFramesFlushed());
+  TEST_ASSERT_EQUAL_MEMORY(second, sink.panel, FRAME_SIZE);
+  flusher.stop();
+}
+
+void test_stop_sends_last_frame_and_joins()
+{
+  RecordingSink sink;
+  uint8_t frame[FRAME_SIZE];
+  DirtyRegion damage(WIDTH, HEIGHT);
+  damage.markAll();
+  {
+    AsyncFlusher flusher(sink, WIDTH, HEIGHT);
+    TEST_ASSERT_TRUE(flusher.start());
+    fill(frame, 5);
+    flusher.submit(frame, damage, true);
+    flusher.stop();
+    TEST_ASSERT_FALSE(flusher.isRunning());
+    TEST_ASSERT_EQUAL(1, flusher.getFramesFlushed());
+    TEST_ASSERT_EQUAL_MEMORY(frame, sink.panel, FRAME_SIZE);
+
+    // Without a worker a frame is flushed on the caller
+    fill(frame, 6);
+    flusher.submit(frame, damage, true);
+    TEST_ASSERT_EQUAL(2, flusher.getFramesFlushed());
+    TEST_ASSERT_EQUAL_MEMORY(frame, sink.panel, FRAME_SIZE);
+
+    // Restartable; the destructor stops a running worker
+    TEST_ASSERT_TRUE(flusher.start());
+    fill(frame, 7);
+    flusher.submit(frame, damage, true);
+  }
+  TEST_ASSERT_EQUAL_MEMORY(frame, sink.panel, FRAME_SIZE);
+}
+
+void test_tall_panel_flushes_every_page()
+{
+  // 128 x 128 (SH1107): damage below row 64 must not be dropped
+  constexpr int TALL = 128;
+  constexpr int TALL_SIZE = WIDTH * TALL / 8;
+  class CountingSink : public PageSink
+  {
+  public:
+    int lastPage = -1;
+    void writeSpan(uint8_t page, uint8_t, uint8_t, const uint8_t *) override { lastPage = page; }
+  } sink;
+  AsyncFlusher flusher(sink, WIDTH, TALL);
+
+  uint8_t frame[TALL_SIZE] = {};
+  frame[15 * WIDTH + 3] = 0x80;
+  DirtyRegion damage(WIDTH, TALL);
+  TEST_ASSERT_EQUAL(16, damage.getPageCount());
+  damage.markRect(3, 127, 1, 1);
+  flusher.submit(frame, damage, false); // No worker: flushed on this thread
+  TEST_ASSERT_EQUAL(15, sink.lastPage);
+  TEST_ASSERT_EQUAL(1, flusher.getBytesSent());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_submit_reaches_sink);
+  RUN_TEST(test_submit_waits_for_frame_in_flight);
+  RUN_TEST(test_stop_sends_last_frame_and_joins);
+  RUN_TEST(test_tall_panel_flushes_every_page);
+  return UNITY_END();
+}
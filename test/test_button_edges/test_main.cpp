@@ -0,0 +1,247 @@
+// ButtonManager classifies presses from the timestamps of their edges, not
+// from when update() runs: late updates give the same events, bounce inside
+// the debounce lockout is ignored, and an overflowing edge ring is counted
+// and resynchronised from the pins.
+
+#include "button/ButtonManager.h"
+#include "platform/Clock.h"
+#include "platform/InputSource.h"
+#include <unity.h>
+#include <vector>
+
+namespace
+{
+  ManualClock testClock(1000);
+
+  const ButtonConfig BUTTONS[] = {{BUTTON_UP, 4, "UP"}, {BUTTON_DOWN, 5, "DOWN"}};
+
+  // Pin levels set by the test
+  class TestPins : public InputSource
+  {
+  public:
+    int levels[256];
+    TestPins()
+    {
+      for (int &level : levels)
+        level = HIGH;
+    }
+    int readLevel(uint8_t pin) override { return levels[pin]; }
+  };
+
+  std::vector<ButtonEvent> takeEvents(ButtonManager &buttons)
+  {
+    std::vector<ButtonEvent> events;
+    buttons.drainEvents([&](const ButtonEvent &event) { events.push_back(event); });
+    return events;
+  }
+
+  void press(ButtonManager &buttons, uint8_t id, unsigned long at, unsigned long hold)
+  {
+    buttons.feedEdge(id, LOW, at);
+    buttons.feedEdge(id, HIGH, at + hold);
+  }
+}
+
+void setUp()
+{
+  testClock.set(1000);
+  Clock::install(&testClock);
+}
+
+void tearDown()
+{
+  Clock::install(nullptr);
+  InputSource::install(nullptr);
+}
+
+void test_short_tap_is_a_click_however_late_update_runs()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.begin(true);
+  press(buttons, BUTTON_UP, 1100, 50);
+  testClock.set(3000); // Far past LONG_PRESS_MS from the press
+  buttons.update();
+
+  std::vector<ButtonEvent> events = takeEvents(buttons);
+  TEST_ASSERT_EQUAL(1, events.size());
+  TEST_ASSERT_EQUAL(SHORT_CLICK, events[0].action);
+  TEST_ASSERT_EQUAL(BUTTON_UP, events[0].buttonId);
+  TEST_ASSERT_EQUAL(4, events[0].buttonPin);
+}
+
+void test_long_hold_is_a_long_press_from_timestamps()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.begin(true);
+  press(buttons, BUTTON_UP, 1100, 1000);
+  testClock.set(2500);
+  buttons.update();
+
+  std::vector<ButtonEvent> events = takeEvents(buttons);
+  TEST_ASSERT_EQUAL(1, events.size());
+  TEST_ASSERT_EQUAL(LONG_PRESS, events[0].action);
+}
+
+void test_double_click_from_timestamps()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.begin(true);
+  press(buttons, BUTTON_DOWN, 1100, 60);
+  press(buttons, BUTTON_DOWN, 1250, 60);
+  testClock.set(2500);
+  buttons.update();
+
+  std::vector<ButtonEvent> events = takeEvents(buttons);
+  TEST_ASSERT_EQUAL(1, events.size());
+  TEST_ASSERT_EQUAL(DOUBLE_CLICK, events[0].action);
+  TEST_ASSERT_EQUAL(BUTTON_DOWN, events[0].buttonId);
+}
+
+void test_second_click_too_late_gives_two_clicks()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.begin(true);
+  press(buttons, BUTTON_UP, 1100, 60);
+  press(buttons, BUTTON_UP, 1100 + 60 + ButtonManager::DOUBLE_CLICK_MS + 50, 60);
+  testClock.set(3000);
+  buttons.update();
+
+  std::vector<ButtonEvent> events = takeEvents(buttons);
+  TEST_ASSERT_EQUAL(2, events.size());
+  TEST_ASSERT_EQUAL(SHORT_CLICK, events[0].action);
+  TEST_ASSERT_EQUAL(SHORT_CLICK, events[1].action);
+}
+
+void test_bounce_inside_lockout_is_ignored()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.begin(true);
+  // Contact bounce on press and on release, each edge 2-3 ms apart
+  const unsigned long edges[] = {1100, 1102, 1104, 1107, 1108, 1200, 1202, 1205};
+  const int levels[] = {LOW, HIGH, LOW, HIGH, LOW, HIGH, LOW, HIGH};
+  for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++)
+    buttons.feedEdge(BUTTON_UP, levels[i], edges[i]);
+  testClock.set(2500);
+  buttons.update();
+
+  std::vector<ButtonEvent> events = takeEvents(buttons);
+  TEST_ASSERT_EQUAL(1, events.size());
+  TEST_ASSERT_EQUAL(SHORT_CLICK, events[0].action);
+  TEST_ASSERT_FALSE(buttons.isActive());
+}
+
+void test_level_settles_after_lockout()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.begin(true);
+  buttons.feedEdge(BUTTON_UP, LOW, 1100);
+  buttons.feedEdge(BUTTON_UP, HIGH, 1103); // Inside the lockout after the press
+  testClock.set(1105);
+  buttons.update();
+  TEST_ASSERT_TRUE(buttons.isActive());
+  TEST_ASSERT_EQUAL(1100 + ButtonManager::DEBOUNCE_MS, buttons.nextDeadline());
+
+  // Once the lockout is over the last level counts: a 10 ms click
+  testClock.set(1100 + ButtonManager::DEBOUNCE_MS);
+  buttons.update();
+  ButtonEvent event;
+  TEST_ASSERT_FALSE(buttons.pollEvent(event)); // Waiting for a double click
+  testClock.advance(ButtonManager::DOUBLE_CLICK_MS + 1);
+  buttons.update();
+  TEST_ASSERT_TRUE(buttons.pollEvent(event));
+  TEST_ASSERT_EQUAL(SHORT_CLICK, event.action);
+}
+
+void test_deadline_across_millis_wrap()
+{
+  const unsigned long wrap = ~0UL - 50;
+  testClock.set(wrap - 2000);
+  ButtonManager buttons(BUTTONS);
+  buttons.begin(true);
+
+  // UP becomes a long press before the wrap, the click of DOWN is due after it
+  buttons.feedEdge(BUTTON_UP, LOW, wrap - 1000);
+  press(buttons, BUTTON_DOWN, wrap - 350, 50);
+  testClock.set(wrap - 250);
+  buttons.update();
+  const unsigned long longPressDue = wrap - 1000 + ButtonManager::LONG_PRESS_MS + 1;
+  TEST_ASSERT_EQUAL(longPressDue, buttons.nextDeadline());
+
+  testClock.set(longPressDue);
+  buttons.update();
+  TEST_ASSERT_EQUAL(LONG_PRESS, buttons.getAction().action);
+  TEST_ASSERT_EQUAL(wrap - 300 + ButtonManager::DOUBLE_CLICK_MS + 1, buttons.nextDeadline());
+  testClock.set(buttons.nextDeadline());
+  buttons.update();
+  ButtonEvent event = buttons.getAction();
+  TEST_ASSERT_EQUAL(SHORT_CLICK, event.action);
+  TEST_ASSERT_EQUAL(BUTTON_DOWN, event.buttonId);
+}
+
+void test_edge_ring_overflow_is_counted_and_resynced()
+{
+  TestPins pins;
+  InputSource::install(&pins);
+  ButtonManager buttons(BUTTONS);
+  std::vector<ButtonEdge> traced;
+  buttons.setEdgeTrace([](const ButtonEdge &edge, void *arg) { static_cast<std::vector<ButtonEdge> *>(arg)->push_back(edge); },
+                       &traced);
+  buttons.begin(true);
+
+  // More edges than the ring holds before update() runs; the button ends up held
+  const size_t fed = ButtonManager::EDGE_CAPACITY + 9;
+  for (size_t i = 0; i < fed; i++)
+    buttons.feedEdge(BUTTON_UP, i % 2 ? HIGH : LOW, 1100 + i * 20);
+  TEST_ASSERT_EQUAL(fed - ButtonManager::EDGE_CAPACITY, buttons.getEdgesDropped());
+
+  pins.levels[4] = LOW;
+  testClock.set(1100 + fed * 20);
+  buttons.update();
+  takeEvents(buttons);
+  TEST_ASSERT_EQUAL(ButtonManager::EDGE_CAPACITY + 1, traced.size()); // The ring, then the pin as it is
+  TEST_ASSERT_EQUAL(LOW, traced.back().level);
+  TEST_ASSERT_TRUE(buttons.isActive());
+
+  // Held from the resync: a long press follows
+  testClock.advance(ButtonManager::LONG_PRESS_MS + 1);
+  buttons.update();
+  ButtonEvent event;
+  TEST_ASSERT_TRUE(buttons.pollEvent(event));
+  TEST_ASSERT_EQUAL(LONG_PRESS, event.action);
+}
+
+void test_polling_samples_the_input_source()
+{
+  TestPins pins;
+  InputSource::install(&pins);
+  ButtonManager buttons(BUTTONS);
+  buttons.setGestures(BUTTON_DOWN, GESTURE_CLICK);
+  buttons.begin();
+
+  pins.levels[5] = LOW;
+  testClock.set(1100);
+  buttons.update();
+  pins.levels[5] = HIGH;
+  testClock.set(1150);
+  buttons.update();
+
+  ButtonEvent event;
+  TEST_ASSERT_TRUE(buttons.pollEvent(event));
+  TEST_ASSERT_EQUAL(SHORT_CLICK, event.action);
+  TEST_ASSERT_EQUAL(BUTTON_DOWN, event.buttonId);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_short_tap_is_a_click_however_late_update_runs);
+  RUN_TEST(test_long_hold_is_a_long_press_from_timestamps);
+  RUN_TEST(test_double_click_from_timestamps);
+  RUN_TEST(test_second_click_too_late_gives_two_clicks);
+  RUN_TEST(test_bounce_inside_lockout_is_ignored);
+  RUN_TEST(test_level_settles_after_lockout);
+  RUN_TEST(test_deadline_across_millis_wrap);
+  RUN_TEST(test_edge_ring_overflow_is_counted_and_resynced);
+  RUN_TEST(test_polling_samples_the_input_source);
+  return UNITY_END();
+}
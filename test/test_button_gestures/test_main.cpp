@@ -0,0 +1,146 @@
+// The gesture mask of a button decides what is waited for: without double
+// clicks a click is reported on release, without repeat a hold is a long
+// press, and without long presses any hold is a click.
+
+#include "button/ButtonManager.h"
+#include "platform/Clock.h"
+#include <unity.h>
+
+namespace
+{
+  ManualClock testClock(1000);
+
+  const ButtonConfig BUTTONS[] = {{BUTTON_UP, 4, "UP"}, {BUTTON_DOWN, 5, "DOWN"}};
+
+  // What a view reports for ButtonManager::setGestures(view)
+  struct TestView
+  {
+    uint8_t gestures(uint8_t id) const { return id == BUTTON_UP ? GESTURE_CLICK : GESTURE_CLICK | GESTURE_LONG_PRESS; }
+  };
+
+  void hold(ButtonManager &buttons, unsigned long from, unsigned long to)
+  {
+    buttons.feedEdge(BUTTON_UP, LOW, from);
+    buttons.feedEdge(BUTTON_UP, HIGH, to);
+  }
+
+  void updateAt(ButtonManager &buttons, unsigned long time)
+  {
+    testClock.set(time);
+    buttons.update();
+  }
+}
+
+void setUp()
+{
+  testClock.set(1000);
+  Clock::install(&testClock);
+}
+
+void tearDown()
+{
+  Clock::install(nullptr);
+}
+
+void test_click_waits_for_double_click_by_default()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.begin(true);
+  hold(buttons, 1100, 1150);
+  updateAt(buttons, 1160);
+  TEST_ASSERT_EQUAL(NO_ACTION, buttons.getAction().action);
+  TEST_ASSERT_EQUAL(1150 + ButtonManager::DOUBLE_CLICK_MS + 1, buttons.nextDeadline());
+
+  updateAt(buttons, buttons.nextDeadline() - 1);
+  TEST_ASSERT_EQUAL(NO_ACTION, buttons.getAction().action);
+  updateAt(buttons, buttons.nextDeadline());
+  TEST_ASSERT_EQUAL(SHORT_CLICK, buttons.getAction().action);
+  TEST_ASSERT_EQUAL(ButtonManager::NO_DEADLINE, buttons.nextDeadline());
+}
+
+void test_click_is_immediate_without_double_click()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.setGestures(BUTTON_UP, GESTURE_ALL & ~GESTURE_DOUBLE_CLICK);
+  buttons.begin(true);
+  hold(buttons, 1100, 1150);
+  updateAt(buttons, 1160);
+  TEST_ASSERT_EQUAL(SHORT_CLICK, buttons.getAction().action);
+  TEST_ASSERT_EQUAL(ButtonManager::NO_DEADLINE, buttons.nextDeadline());
+  TEST_ASSERT_FALSE(buttons.isActive());
+
+  // Two quick taps are two clicks
+  hold(buttons, 1200, 1250);
+  hold(buttons, 1300, 1350);
+  updateAt(buttons, 1360);
+  TEST_ASSERT_EQUAL(SHORT_CLICK, buttons.getAction().action);
+  TEST_ASSERT_EQUAL(SHORT_CLICK, buttons.getAction().action);
+  TEST_ASSERT_EQUAL(NO_ACTION, buttons.getAction().action);
+}
+
+void test_pending_click_reported_after_gesture_change()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.begin(true);
+  hold(buttons, 1100, 1150);
+  updateAt(buttons, 1160);
+  TEST_ASSERT_EQUAL(NO_ACTION, buttons.getAction().action);
+
+  // The new view has no double clicks: the waiting click is due now
+  buttons.setGestures(BUTTON_UP, GESTURE_CLICK);
+  TEST_ASSERT_TRUE(buttons.nextDeadline() <= 1170);
+  updateAt(buttons, 1170);
+  TEST_ASSERT_EQUAL(SHORT_CLICK, buttons.getAction().action);
+  TEST_ASSERT_EQUAL(ButtonManager::NO_DEADLINE, buttons.nextDeadline());
+}
+
+void test_masked_repeat_gives_long_press()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.setRepeat(BUTTON_UP);
+  buttons.setGestures(BUTTON_UP, GESTURE_ALL & ~GESTURE_REPEAT);
+  buttons.begin(true);
+  buttons.feedEdge(BUTTON_UP, LOW, 1100);
+  updateAt(buttons, 1100);
+  TEST_ASSERT_EQUAL(1100 + ButtonManager::LONG_PRESS_MS + 1, buttons.nextDeadline());
+  updateAt(buttons, 2500);
+  TEST_ASSERT_EQUAL(LONG_PRESS, buttons.getAction().action);
+  TEST_ASSERT_EQUAL(NO_ACTION, buttons.getAction().action);
+}
+
+void test_masked_long_press_makes_any_hold_a_click()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.setGestures(BUTTON_UP, GESTURE_CLICK);
+  buttons.begin(true);
+  buttons.feedEdge(BUTTON_UP, LOW, 1100);
+  updateAt(buttons, 1100);
+  TEST_ASSERT_EQUAL(ButtonManager::NO_DEADLINE, buttons.nextDeadline());
+
+  updateAt(buttons, 3000);
+  TEST_ASSERT_EQUAL(NO_ACTION, buttons.getAction().action);
+  buttons.feedEdge(BUTTON_UP, HIGH, 3000);
+  updateAt(buttons, 3010);
+  TEST_ASSERT_EQUAL(SHORT_CLICK, buttons.getAction().action);
+}
+
+void test_gestures_from_view()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.setGestures(TestView());
+  TEST_ASSERT_EQUAL(GESTURE_CLICK, buttons.getGestures(BUTTON_UP));
+  TEST_ASSERT_EQUAL(GESTURE_CLICK | GESTURE_LONG_PRESS, buttons.getGestures(BUTTON_DOWN));
+  TEST_ASSERT_EQUAL(GESTURE_ALL, buttons.getGestures(BUTTON_LEFT)); // Not registered, not asked
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_click_waits_for_double_click_by_default);
+  RUN_TEST(test_click_is_immediate_without_double_click);
+  RUN_TEST(test_pending_click_reported_after_gesture_change);
+  RUN_TEST(test_masked_repeat_gives_long_press);
+  RUN_TEST(test_masked_long_press_makes_any_hold_a_click);
+  RUN_TEST(test_gestures_from_view);
+  return UNITY_END();
+}
@@ -0,0 +1,100 @@
+// Buttons are indexed by their id: ids do not have to be contiguous, an id
+// out of range or registered twice is ignored, and every event carries the
+// pin of the button it came from.
+
+#include "button/ButtonManager.h"
+#include "platform/Clock.h"
+#include <unity.h>
+#include <type_traits>
+
+static_assert(sizeof(ButtonEvent) == 4, "ButtonEvent is copied through the queue by value");
+static_assert(std::is_trivially_copyable<ButtonEvent>::value, "ButtonEvent is copied through the queue by value");
+
+namespace
+{
+  ManualClock testClock(1000);
+
+  // Sparse ids, one out of range, one repeated
+  const ButtonConfig BUTTONS[] = {
+      {BUTTON_CENTER, 15, "CENTER"},
+      {ButtonManager::MAX_BUTTONS - 1, 21, "LAST"},
+      {ButtonManager::MAX_BUTTONS, 22, "OUT"},
+      {200, 23, "FAR"},
+      {BUTTON_CENTER, 16, "AGAIN"},
+  };
+
+  ButtonEvent click(ButtonManager &buttons, uint8_t id, unsigned long time)
+  {
+    buttons.feedEdge(id, LOW, time);
+    buttons.feedEdge(id, HIGH, time + 50);
+    testClock.set(time + 100);
+    buttons.update();
+    return buttons.getAction();
+  }
+}
+
+void setUp()
+{
+  testClock.set(1000);
+  Clock::install(&testClock);
+}
+
+void tearDown()
+{
+  Clock::install(nullptr);
+}
+
+void test_names_of_registered_ids_only()
+{
+  ButtonManager buttons(BUTTONS);
+  TEST_ASSERT_EQUAL_STRING("CENTER", buttons.name(BUTTON_CENTER));
+  TEST_ASSERT_EQUAL_STRING("LAST", buttons.name(ButtonManager::MAX_BUTTONS - 1));
+  TEST_ASSERT_EQUAL_STRING("?", buttons.name(ButtonManager::MAX_BUTTONS));
+  TEST_ASSERT_EQUAL_STRING("?", buttons.name(200));
+  TEST_ASSERT_EQUAL_STRING("?", buttons.name(BUTTON_UP));
+}
+
+void test_events_carry_id_and_pin()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.setGestures(BUTTON_CENTER, GESTURE_CLICK);
+  buttons.setGestures(ButtonManager::MAX_BUTTONS - 1, GESTURE_CLICK);
+  buttons.begin(true);
+
+  ButtonEvent event = click(buttons, BUTTON_CENTER, 1100);
+  TEST_ASSERT_EQUAL(SHORT_CLICK, event.action);
+  TEST_ASSERT_EQUAL(BUTTON_CENTER, event.buttonId);
+  TEST_ASSERT_EQUAL(15, event.buttonPin); // The first registration wins
+
+  event = click(buttons, ButtonManager::MAX_BUTTONS - 1, 1300);
+  TEST_ASSERT_EQUAL(SHORT_CLICK, event.action);
+  TEST_ASSERT_EQUAL(ButtonManager::MAX_BUTTONS - 1, event.buttonId);
+  TEST_ASSERT_EQUAL(21, event.buttonPin);
+}
+
+void test_unknown_ids_are_ignored()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.begin(true);
+
+  // Setters and edges for ids that are not registered change nothing
+  buttons.setGestures(200, GESTURE_CLICK);
+  buttons.setRepeat(200, ButtonRepeat{500, 150, 30, 2000});
+  TEST_ASSERT_EQUAL(0, buttons.getGestures(200));
+
+  TEST_ASSERT_EQUAL(NO_ACTION, click(buttons, BUTTON_UP, 1100).action);
+  TEST_ASSERT_EQUAL(NO_ACTION, click(buttons, ButtonManager::MAX_BUTTONS, 1300).action);
+  TEST_ASSERT_EQUAL(NO_ACTION, click(buttons, 200, 1500).action);
+  TEST_ASSERT_FALSE(buttons.isActive());
+  TEST_ASSERT_EQUAL(ButtonManager::NO_DEADLINE, buttons.nextDeadline());
+  TEST_ASSERT_EQUAL(0, buttons.getEventsDropped());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_names_of_registered_ids_only);
+  RUN_TEST(test_events_carry_id_and_pin);
+  RUN_TEST(test_unknown_ids_are_ignored);
+  return UNITY_END();
+}
@@ -0,0 +1,188 @@
+// The event queue of ButtonManager and the SpscRing under it: events of
+// different buttons come out in the order they happened, a full queue drops
+// and counts, and one producer and one consumer thread never lose or reorder
+// what was accepted.
+
+#include "button/ButtonManager.h"
+#include "platform/Clock.h"
+#include "platform/SpscRing.h"
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  ManualClock testClock(1000);
+
+  const ButtonConfig BUTTONS[] = {{BUTTON_UP, 4, "UP"}, {BUTTON_DOWN, 5, "DOWN"}, {BUTTON_CENTER, 15, "CENTER"}};
+}
+
+void setUp()
+{
+  testClock.set(1000);
+  Clock::install(&testClock);
+}
+
+void tearDown()
+{
+  Clock::install(nullptr);
+}
+
+void test_events_of_several_buttons_in_time_order()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.setGestures(BUTTON_DOWN, GESTURE_CLICK);
+  buttons.setGestures(BUTTON_CENTER, GESTURE_CLICK);
+  buttons.begin(true);
+
+  // UP becomes a long press at 1901, while DOWN is tapped around it and
+  // CENTER after it; all handled by one late update()
+  buttons.feedEdge(BUTTON_UP, LOW, 1100);
+  buttons.feedEdge(BUTTON_DOWN, LOW, 1850);
+  buttons.feedEdge(BUTTON_DOWN, HIGH, 1880);
+  buttons.feedEdge(BUTTON_CENTER, LOW, 1950);
+  buttons.feedEdge(BUTTON_CENTER, HIGH, 2000);
+  buttons.feedEdge(BUTTON_UP, HIGH, 2100);
+  testClock.set(3000);
+  buttons.update();
+
+  TEST_ASSERT_EQUAL(3, buttons.pendingEvents());
+  std::vector<ButtonEvent> events;
+  TEST_ASSERT_EQUAL(3, buttons.drainEvents([&](const ButtonEvent &event) { events.push_back(event); }));
+  TEST_ASSERT_EQUAL(BUTTON_DOWN, events[0].buttonId);
+  TEST_ASSERT_EQUAL(SHORT_CLICK, events[0].action);
+  TEST_ASSERT_EQUAL(BUTTON_UP, events[1].buttonId);
+  TEST_ASSERT_EQUAL(LONG_PRESS, events[1].action);
+  TEST_ASSERT_EQUAL(BUTTON_CENTER, events[2].buttonId);
+  TEST_ASSERT_EQUAL(SHORT_CLICK, events[2].action);
+  TEST_ASSERT_EQUAL(0, buttons.pendingEvents());
+}
+
+void test_get_action_and_poll_event()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.setGestures(BUTTON_UP, GESTURE_CLICK);
+  buttons.begin(true);
+  TEST_ASSERT_EQUAL(NO_ACTION, buttons.getAction().action);
+
+  buttons.feedEdge(BUTTON_UP, LOW, 1100);
+  buttons.feedEdge(BUTTON_UP, HIGH, 1150);
+  buttons.feedEdge(BUTTON_UP, LOW, 1500);
+  buttons.feedEdge(BUTTON_UP, HIGH, 1550);
+  testClock.set(1600);
+  buttons.update();
+
+  TEST_ASSERT_EQUAL(SHORT_CLICK, buttons.getAction().action);
+  ButtonEvent event;
+  TEST_ASSERT_TRUE(buttons.pollEvent(event));
+  TEST_ASSERT_EQUAL(SHORT_CLICK, event.action);
+  TEST_ASSERT_FALSE(buttons.pollEvent(event));
+  TEST_ASSERT_EQUAL(NO_ACTION, buttons.getAction().action);
+}
+
+void test_full_queue_drops_and_counts()
+{
+  ButtonManager buttons(BUTTONS);
+  buttons.setGestures(BUTTON_UP, GESTURE_CLICK);
+  buttons.begin(true);
+
+  // Twice as many clicks as the queue holds, in a few updates
+  const unsigned clicks = ButtonManager::EVENT_CAPACITY * 2;
+  unsigned long t = 1100;
+  for (unsigned i = 0; i < clicks; i++)
+  {
+    buttons.feedEdge(BUTTON_UP, LOW, t);
+    buttons.feedEdge(BUTTON_UP, HIGH, t + 40);
+    t += 100;
+    if (i % 8 == 7)
+    {
+      testClock.set(t);
+      buttons.update();
+    }
+  }
+
+  TEST_ASSERT_EQUAL(ButtonManager::EVENT_CAPACITY, buttons.pendingEvents());
+  TEST_ASSERT_EQUAL(clicks - ButtonManager::EVENT_CAPACITY, buttons.getEventsDropped());
+  TEST_ASSERT_EQUAL(0, buttons.getEdgesDropped());
+
+  // The oldest are kept; room again once drained
+  TEST_ASSERT_EQUAL(ButtonManager::EVENT_CAPACITY, buttons.drainEvents([](const ButtonEvent &) {}));
+  buttons.feedEdge(BUTTON_UP, LOW, t);
+  buttons.feedEdge(BUTTON_UP, HIGH, t + 40);
+  testClock.set(t + 50);
+  buttons.update();
+  TEST_ASSERT_EQUAL(1, buttons.pendingEvents());
+}
+
+void test_ring_wraps_and_counts_drops()
+{
+  SpscRing<int, 4> ring;
+  int value;
+  for (int round = 0; round < 10; round++)
+  {
+    TEST_ASSERT_TRUE(ring.push(round * 10));
+    TEST_ASSERT_TRUE(ring.push(round * 10 + 1));
+    TEST_ASSERT_TRUE(ring.pop(value));
+    TEST_ASSERT_EQUAL(round * 10, value);
+    TEST_ASSERT_TRUE(ring.pop(value));
+    TEST_ASSERT_EQUAL(round * 10 + 1, value);
+  }
+  TEST_ASSERT_TRUE(ring.empty());
+
+  for (int i = 0; i < 6; i++)
+    ring.push(i);
+  TEST_ASSERT_EQUAL(4, ring.size());
+  TEST_ASSERT_EQUAL(2, ring.getDropped());
+  for (int i = 0; i < 4; i++)
+  {
+    TEST_ASSERT_TRUE(ring.pop(value));
+    TEST_ASSERT_EQUAL(i, value); // The newest were dropped
+  }
+  TEST_ASSERT_FALSE(ring.pop(value));
+}
+
+void test_ring_between_two_threads()
+{
+  SpscRing<uint32_t, 16> ring;
+  constexpr uint32_t ITEMS = 200000;
+  std::atomic<bool> producing{true};
+  uint32_t accepted = 0;
+
+  std::thread producer([&] {
+    for (uint32_t i = 0; i < ITEMS; i++)
+      if (ring.push(i))
+        accepted++;
+    producing = false;
+  });
+
+  uint32_t received = 0;
+  uint32_t last = 0;
+  bool ordered = true;
+  uint32_t value;
+  while (producing || !ring.empty())
+  {
+    if (!ring.pop(value))
+      continue;
+    if (received > 0 && value <= last)
+      ordered = false;
+    last = value;
+    received++;
+  }
+  producer.join();
+
+  TEST_ASSERT_TRUE(ordered);
+  TEST_ASSERT_EQUAL(accepted, received);
+  TEST_ASSERT_EQUAL(ITEMS, received + ring.getDropped());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_events_of_several_buttons_in_time_order);
+  RUN_TEST(test_get_action_and_poll_event);
+  RUN_TEST(test_full_queue_drops_and_counts);
+  RUN_TEST(test_ring_wraps_and_counts_drops);
+  RUN_TEST(test_ring_between_two_threads);
+  return UNITY_END();
+}
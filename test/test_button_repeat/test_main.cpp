@@ -0,0 +1,163 @@
+// Held repeat buttons: the first REPEAT comes after delayMs, the intervals
+// shrink towards minIntervalMs over rampMs, and a late update() gives a
+// single REPEAT whose count still follows the hold time.
+
+#include "button/ButtonManager.h"
+#include "platform/Clock.h"
+#include <unity.h>
+#include <vector>
+
+namespace
+{
+  ManualClock testClock(1000);
+
+  const ButtonConfig BUTTONS[] = {{BUTTON_UP, 4, "UP"}};
+  const ButtonRepeat REPEAT_CONFIG{500, 150, 30, 2000};
+
+  struct Repeat
+  {
+    unsigned long time;
+    uint8_t count;
+  };
+
+  // Runs update() at every deadline up to 'until', noting each REPEAT
+  std::vector<Repeat> followDeadlines(ButtonManager &buttons, unsigned long until)
+  {
+    std::vector<Repeat> repeats;
+    for (unsigned long due = buttons.nextDeadline(); due <= until; due = buttons.nextDeadline())
+    {
+      testClock.set(due);
+      buttons.update();
+      ButtonEvent event;
+      while (buttons.pollEvent(event))
+      {
+        TEST_ASSERT_EQUAL(REPEAT, event.action);
+        repeats.push_back({due, event.repeatCount});
+      }
+    }
+    return repeats;
+  }
+
+  void makeRepeating(ButtonManager &buttons)
+  {
+    buttons.setRepeat(BUTTON_UP, REPEAT_CONFIG);
+    buttons.begin(true);
+  }
+}
+
+void setUp()
+{
+  testClock.set(1000);
+  Clock::install(&testClock);
+}
+
+void tearDown()
+{
+  Clock::install(nullptr);
+}
+
+void test_intervals_ramp_down_to_the_floor()
+{
+  ButtonManager buttons(BUTTONS);
+  makeRepeating(buttons);
+  buttons.feedEdge(BUTTON_UP, LOW, 1100);
+  testClock.set(1100);
+  buttons.update();
+
+  std::vector<Repeat> repeats = followDeadlines(buttons, 1100 + 500 + 3000);
+  TEST_ASSERT_TRUE(repeats.size() > 20);
+  TEST_ASSERT_EQUAL(1100 + REPEAT_CONFIG.delayMs, repeats[0].time);
+  TEST_ASSERT_EQUAL(1, repeats[0].count);
+
+  unsigned long previous = REPEAT_CONFIG.intervalMs;
+  for (size_t i = 1; i < repeats.size(); i++)
+  {
+    unsigned long interval = repeats[i].time - repeats[i - 1].time;
+    TEST_ASSERT_TRUE(interval <= previous);
+    TEST_ASSERT_TRUE(interval >= REPEAT_CONFIG.minIntervalMs);
+    TEST_ASSERT_EQUAL(i + 1, repeats[i].count);
+    previous = interval;
+  }
+  TEST_ASSERT_EQUAL(REPEAT_CONFIG.intervalMs, repeats[1].time - repeats[0].time);
+  TEST_ASSERT_EQUAL(REPEAT_CONFIG.minIntervalMs, previous);
+}
+
+void test_late_update_gives_one_repeat()
+{
+  // The same hold followed deadline by deadline and with one late update
+  ButtonManager stepped(BUTTONS);
+  makeRepeating(stepped);
+  stepped.feedEdge(BUTTON_UP, LOW, 1100);
+  testClock.set(1100);
+  stepped.update();
+  std::vector<Repeat> repeats = followDeadlines(stepped, 3700);
+
+  ButtonManager late(BUTTONS);
+  makeRepeating(late);
+  late.feedEdge(BUTTON_UP, LOW, 1100);
+  testClock.set(3700);
+  late.update();
+
+  TEST_ASSERT_EQUAL(1, late.pendingEvents());
+  ButtonEvent event = late.getAction();
+  TEST_ASSERT_EQUAL(REPEAT, event.action);
+  TEST_ASSERT_EQUAL(repeats.back().count, event.repeatCount);
+
+  // Both continue from the same next deadline
+  TEST_ASSERT_EQUAL(stepped.nextDeadline(), late.nextDeadline());
+  testClock.set(late.nextDeadline());
+  late.update();
+  event = late.getAction();
+  TEST_ASSERT_EQUAL(REPEAT, event.action);
+  TEST_ASSERT_EQUAL(repeats.back().count + 1, event.repeatCount);
+}
+
+void test_tap_is_a_click_and_hold_is_not()
+{
+  ButtonManager buttons(BUTTONS);
+  makeRepeating(buttons);
+  buttons.setGestures(BUTTON_UP, GESTURE_CLICK | GESTURE_REPEAT);
+
+  // Released before the first REPEAT
+  buttons.feedEdge(BUTTON_UP, LOW, 1100);
+  buttons.feedEdge(BUTTON_UP, HIGH, 1400);
+  testClock.set(1450);
+  buttons.update();
+  TEST_ASSERT_EQUAL(SHORT_CLICK, buttons.getAction().action);
+
+  // Released after repeating
+  buttons.feedEdge(BUTTON_UP, LOW, 2000);
+  buttons.feedEdge(BUTTON_UP, HIGH, 2600);
+  testClock.set(3000);
+  buttons.update();
+  ButtonEvent event = buttons.getAction();
+  TEST_ASSERT_EQUAL(REPEAT, event.action);
+  TEST_ASSERT_EQUAL(NO_ACTION, buttons.getAction().action);
+  TEST_ASSERT_EQUAL(ButtonManager::NO_DEADLINE, buttons.nextDeadline());
+}
+
+void test_clear_repeat_restores_long_press()
+{
+  ButtonManager buttons(BUTTONS);
+  makeRepeating(buttons);
+  buttons.clearRepeat(BUTTON_UP);
+
+  buttons.feedEdge(BUTTON_UP, LOW, 1100);
+  testClock.set(1100);
+  buttons.update();
+  TEST_ASSERT_EQUAL(1100 + ButtonManager::LONG_PRESS_MS + 1, buttons.nextDeadline());
+  testClock.set(3000);
+  buttons.update();
+  TEST_ASSERT_EQUAL(LONG_PRESS, buttons.getAction().action);
+  TEST_ASSERT_EQUAL(NO_ACTION, buttons.getAction().action);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_intervals_ramp_down_to_the_floor);
+  RUN_TEST(test_late_update_gives_one_repeat);
+  RUN_TEST(test_tap_is_a_click_and_hold_is_not);
+  RUN_TEST(test_clear_repeat_restores_long_press);
+  return UNITY_END();
+}
@@ -0,0 +1,258 @@
+// FrameMirror through a serial port that takes only so many bytes at a time,
+// into MirrorReceiver: packets are framed and checked, the receiver rebuilds
+// the frames exactly, a frame superseded under back-pressure is dropped and
+// counted, and a damaged packet is recovered from at the next keyframe.
+
+#include "record/FrameMirror.h"
+#include "record/MirrorReceiver.h"
+#include <unity.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+  constexpr int WIDTH = 128;
+  constexpr int HEIGHT = 64;
+  constexpr int FRAME_SIZE = WIDTH * HEIGHT / 8;
+
+  using Frame = std::vector<uint8_t>;
+
+  // Serial port with 'room' bytes of transmit buffer until drained
+  class TestPort : public Stream
+  {
+  public:
+    std::vector<uint8_t> bytes;
+    size_t room = 1 << 20;
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *data, size_t length) override
+    {
+      TEST_ASSERT_TRUE(length <= room); // FrameMirror must not write more than it was offered
+      bytes.insert(bytes.end(), data, data + length);
+      room -= length;
+      return length;
+    }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int availableForWrite() override { return static_cast<int>(room); }
+  };
+
+  // Frames and text the receiver passed on
+  struct Received
+  {
+    std::vector<Frame> frames;
+    std::string text;
+
+    explicit Received(MirrorReceiver &receiver)
+    {
+      receiver.onFrame([this](const uint8_t *frame, int width, int pages) {
+        TEST_ASSERT_EQUAL(WIDTH, width);
+        TEST_ASSERT_EQUAL(HEIGHT / 8, pages);
+        frames.emplace_back(frame, frame + width * pages);
+      });
+      receiver.onText([this](char c) { text += c; });
+    }
+  };
+
+  // A frame with a few distinct pages, different for each 'seed'
+  Frame makeFrame(int seed)
+  {
+    Frame frame(FRAME_SIZE, 0);
+    for (int x = 0; x < WIDTH; x++)
+    {
+      frame[x] = static_cast<uint8_t>(x * 3 + seed);
+      frame[2 * WIDTH + x] = (x + seed) % 7 == 0 ? 0xFF : 0x00;
+      frame[5 * WIDTH + x] = static_cast<uint8_t>(seed);
+    }
+    return frame;
+  }
+
+  void assertFrame(const Frame &expected, const Frame &actual)
+  {
+    TEST_ASSERT_EQUAL(expected.size(), actual.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected.data(), actual.data(), expected.size());
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_packet_framing_and_checksum()
+{
+  TestPort port;
+  FrameMirror mirror(port, WIDTH, HEIGHT);
+  mirror.submit(makeFrame(1).data());
+  TEST_ASSERT_EQUAL(0, port.bytes.size()); // Off until the host asks
+
+  TEST_ASSERT_TRUE(mirror.handleCommand(mirror::COMMAND_START));
+  TEST_ASSERT_FALSE(mirror.handleCommand('x'));
+  mirror.submit(makeFrame(1).data());
+  const size_t first = port.bytes.size();
+  Frame second = makeFrame(1);
+  second[5 * WIDTH + 10] ^= 0xFF; // One page changes
+  mirror.submit(second.data());
+  mirror.submit(second.data()); // Unchanged: nothing to send
+
+  const std::vector<uint8_t> &bytes = port.bytes;
+  size_t at = 0;
+  const uint8_t types[] = {mirror::KEYFRAME, mirror::FRAME};
+  for (uint8_t sequence = 0; sequence < 2; sequence++)
+  {
+    TEST_ASSERT_EQUAL_HEX8(mirror::SYNC0, bytes[at]);
+    TEST_ASSERT_EQUAL_HEX8(mirror::SYNC1, bytes[at + 1]);
+    TEST_ASSERT_EQUAL(types[sequence], bytes[at + 2]);
+    TEST_ASSERT_EQUAL(sequence, bytes[at + 3]);
+    const size_t length = bytes[at + 4] | bytes[at + 5] << 8;
+    const size_t end = at + mirror::HEADER_SIZE + length;
+    TEST_ASSERT_TRUE(end + mirror::CHECK_SIZE <= bytes.size());
+
+    mirror::Checksum check;
+    check.add(bytes.data() + at + 2, end - at - 2);
+    TEST_ASSERT_EQUAL_HEX16(check.value(), bytes[end] | bytes[end + 1] << 8);
+    at = end + mirror::CHECK_SIZE;
+    if (sequence == 0)
+      TEST_ASSERT_EQUAL(first, at);
+  }
+  TEST_ASSERT_EQUAL(bytes.size(), at);
+  TEST_ASSERT_TRUE(at - first < first); // The delta is smaller than the keyframe
+  TEST_ASSERT_EQUAL(2, mirror.getFramesSent());
+  TEST_ASSERT_EQUAL(0, mirror.getFramesDropped());
+}
+
+void test_receiver_rebuilds_frames_among_text()
+{
+  TestPort port;
+  FrameMirror mirror(port, WIDTH, HEIGHT);
+  mirror.setEnabled(true);
+
+  std::vector<Frame> frames;
+  for (int i = 0; i < 5; i++)
+  {
+    frames.push_back(makeFrame(i * 5));
+    mirror.submit(frames.back().data());
+    port.print("log\n"); // Ordinary text between the packets
+  }
+  port.write(mirror::SYNC0); // Also a lone sync byte
+  port.print("!");
+
+  MirrorReceiver receiver;
+  Received received(receiver);
+  receiver.feed(port.bytes.data(), port.bytes.size());
+
+  TEST_ASSERT_EQUAL(frames.size(), received.frames.size());
+  for (size_t i = 0; i < frames.size(); i++)
+    assertFrame(frames[i], received.frames[i]);
+  TEST_ASSERT_EQUAL_STRING("log\nlog\nlog\nlog\nlog\n\xA5!", received.text.c_str());
+  TEST_ASSERT_FALSE(receiver.needsKeyframe());
+  TEST_ASSERT_EQUAL(0, receiver.getPacketsLost());
+}
+
+void test_back_pressure_drops_superseded_frames()
+{
+  TestPort port;
+  port.room = 0;
+  FrameMirror mirror(port, WIDTH, HEIGHT);
+  mirror.setEnabled(true);
+
+  // The first packet waits for the port, the next two frames queue behind it
+  Frame frames[] = {makeFrame(1), makeFrame(2), makeFrame(3)};
+  for (const Frame &frame : frames)
+    mirror.submit(frame.data());
+  TEST_ASSERT_EQUAL(0, port.bytes.size());
+  TEST_ASSERT_EQUAL(1, mirror.getFramesDropped());
+
+  // A few bytes per poll, like a slow USB host
+  MirrorReceiver receiver;
+  Received received(receiver);
+  int polls = 0;
+  size_t fed = 0;
+  while (polls < 10000)
+  {
+    port.room = 7;
+    mirror.poll();
+    receiver.feed(port.bytes.data() + fed, port.bytes.size() - fed);
+    fed = port.bytes.size();
+    polls++;
+    if (port.room == 7)
+      break; // Nothing left to send
+  }
+  TEST_ASSERT_TRUE(polls > 10);
+  TEST_ASSERT_TRUE(polls < 10000);
+
+  // The first and the last frame made it, the last as a delta on the first
+  TEST_ASSERT_EQUAL(2, mirror.getFramesSent());
+  TEST_ASSERT_EQUAL(2, received.frames.size());
+  assertFrame(frames[0], received.frames[0]);
+  assertFrame(frames[2], received.frames[1]);
+  TEST_ASSERT_EQUAL(0, receiver.getPacketsLost());
+}
+
+void test_recovers_from_corrupt_packet_at_keyframe()
+{
+  TestPort port;
+  FrameMirror mirror(port, WIDTH, HEIGHT);
+  mirror.setEnabled(true);
+  Frame frames[] = {makeFrame(1), makeFrame(2), makeFrame(3), makeFrame(4)};
+
+  mirror.submit(frames[0].data());
+  const size_t keyframeEnd = port.bytes.size();
+  mirror.submit(frames[1].data());
+  port.bytes[keyframeEnd + mirror::HEADER_SIZE + 2] ^= 0x10; // Damage the delta
+  mirror.submit(frames[2].data());
+
+  MirrorReceiver receiver;
+  Received received(receiver);
+  receiver.feed(port.bytes.data(), port.bytes.size());
+  TEST_ASSERT_EQUAL(1, received.frames.size());
+  TEST_ASSERT_EQUAL(1, receiver.getPacketsLost());
+  TEST_ASSERT_TRUE(receiver.needsKeyframe()); // The next delta is not applied
+
+  // The host asks again with 'm'
+  port.bytes.clear();
+  mirror.handleCommand(mirror::COMMAND_START);
+  mirror.submit(frames[3].data());
+  receiver.feed(port.bytes.data(), port.bytes.size());
+  TEST_ASSERT_FALSE(receiver.needsKeyframe());
+  TEST_ASSERT_EQUAL(2, received.frames.size());
+  assertFrame(frames[3], received.frames[1]);
+}
+
+void test_recovers_from_truncated_packet()
+{
+  TestPort port;
+  FrameMirror mirror(port, WIDTH, HEIGHT);
+  mirror.setEnabled(true);
+  mirror.submit(makeFrame(1).data());
+  std::vector<uint8_t> truncated(port.bytes.begin(), port.bytes.begin() + port.bytes.size() / 2);
+
+  // The receiver sees half of a packet (e.g. the port was opened late),
+  // then keyframes until one is taken
+  MirrorReceiver receiver;
+  Received received(receiver);
+  receiver.feed(truncated.data(), truncated.size());
+  Frame last;
+  for (int i = 2; i < 6; i++)
+  {
+    port.bytes.clear();
+    last = makeFrame(i);
+    mirror.requestKeyframe();
+    mirror.submit(last.data());
+    receiver.feed(port.bytes.data(), port.bytes.size());
+  }
+
+  TEST_ASSERT_TRUE(receiver.getPacketsLost() >= 1);
+  TEST_ASSERT_FALSE(receiver.needsKeyframe());
+  TEST_ASSERT_TRUE(received.frames.size() >= 2);
+  assertFrame(last, received.frames.back());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_packet_framing_and_checksum);
+  RUN_TEST(test_receiver_rebuilds_frames_among_text);
+  RUN_TEST(test_back_pressure_drops_superseded_frames);
+  RUN_TEST(test_recovers_from_corrupt_packet_at_keyframe);
+  RUN_TEST(test_recovers_from_truncated_packet);
+  return UNITY_END();
+}
@@ -0,0 +1,84 @@
+// Deadlines are millis() values and wrap after ~49 days: the earliest of
+// several is picked by their distance, not their magnitude, and NO_DEADLINE
+// only wins when nothing else is pending.
+
+#include "ui/FrameScheduler.h"
+#include <unity.h>
+#include <chrono>
+
+namespace
+{
+  // Widget with a fixed deadline
+  class TimedWidget : public Widget
+  {
+  public:
+    unsigned long deadline = NO_DEADLINE;
+    unsigned long nextDeadline(unsigned long /*now*/) const override { return deadline; }
+  };
+
+  constexpr unsigned long NEAR_WRAP = ~0UL - 100;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_earliest_is_wrap_safe()
+{
+  TEST_ASSERT_EQUAL(10, Widget::earliest(10, 20));
+  TEST_ASSERT_EQUAL(10, Widget::earliest(20, 10));
+  TEST_ASSERT_EQUAL(NEAR_WRAP, Widget::earliest(NEAR_WRAP, 50)); // 50 comes after the wrap
+  TEST_ASSERT_EQUAL(NEAR_WRAP, Widget::earliest(50, NEAR_WRAP));
+  TEST_ASSERT_EQUAL(NEAR_WRAP, Widget::earliest(NEAR_WRAP, Widget::NO_DEADLINE));
+  TEST_ASSERT_EQUAL(50, Widget::earliest(Widget::NO_DEADLINE, 50));
+  TEST_ASSERT_EQUAL(Widget::NO_DEADLINE, Widget::earliest(Widget::NO_DEADLINE, Widget::NO_DEADLINE));
+}
+
+void test_scheduler_deadline_across_wrap()
+{
+  FrameScheduler scheduler;
+  TimedWidget before, after, idle;
+  before.markDrawn();
+  after.markDrawn();
+  idle.markDrawn();
+  scheduler.addWidget(after);
+  scheduler.addWidget(idle);
+  scheduler.addWidget(before);
+
+  const unsigned long now = NEAR_WRAP - 50;
+  before.deadline = NEAR_WRAP;
+  after.deadline = 30;
+  TEST_ASSERT_EQUAL(NEAR_WRAP, scheduler.nextDeadline(now));
+  TEST_ASSERT_FALSE(scheduler.frameDue(now));
+  TEST_ASSERT_TRUE(scheduler.frameDue(NEAR_WRAP));
+
+  before.deadline = Widget::NO_DEADLINE;
+  TEST_ASSERT_EQUAL(30, scheduler.nextDeadline(now));
+  TEST_ASSERT_FALSE(scheduler.frameDue(NEAR_WRAP));
+  TEST_ASSERT_TRUE(scheduler.frameDue(30));
+
+  after.deadline = Widget::NO_DEADLINE;
+  TEST_ASSERT_EQUAL(Widget::NO_DEADLINE, scheduler.nextDeadline(now));
+}
+
+void test_wait_returns_at_once_when_input_is_due()
+{
+  FrameScheduler scheduler(60000);
+  TimedWidget widget;
+  widget.markDrawn();
+  widget.deadline = 5000; // After the wrap
+  scheduler.addWidget(widget);
+
+  // The input deadline before the wrap is already due: no sleep until the widget's
+  auto start = std::chrono::steady_clock::now();
+  scheduler.waitForWork(NEAR_WRAP, NEAR_WRAP - 10);
+  TEST_ASSERT_TRUE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_earliest_is_wrap_safe);
+  RUN_TEST(test_scheduler_deadline_across_wrap);
+  RUN_TEST(test_wait_returns_at_once_when_input_is_due);
+  return UNITY_END();
+}
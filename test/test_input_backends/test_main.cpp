@@ -0,0 +1,315 @@
+// Input backends against their simulated buses: key numbering and bit order,
+// matrix ghost blocking, expander bus errors, and what ButtonManager does
+// with a backend scan when nothing changes.
+
+#include "button/ButtonManager.h"
+#include "button/I2cExpanderInput.h"
+#include "button/MatrixKeypad.h"
+#include "button/ShiftRegisterInput.h"
+#include "platform/Clock.h"
+#include "platform/InputSource.h"
+#include <unity.h>
+#include <vector>
+
+namespace
+{
+  using KeyMask = InputBackend::KeyMask;
+
+  KeyMask key(unsigned k) { return KeyMask(1) << k; }
+
+  // Edges ButtonManager applied, in order
+  std::vector<ButtonEdge> traced;
+  void traceEdge(const ButtonEdge &edge, void *) { traced.push_back(edge); }
+
+  // Counts pin reads: a backend must not cause any
+  class CountingInput : public InputSource
+  {
+  public:
+    unsigned long reads = 0;
+    int readLevel(uint8_t) override
+    {
+      reads++;
+      return HIGH;
+    }
+  };
+
+  // Chain whose bytes are set directly, as they come off the SPI bus
+  class FixedShiftRegisterBus : public ShiftRegisterBus
+  {
+  public:
+    uint8_t bytes[ShiftRegisterInput::MAX_REGISTERS];
+    bool fail = false;
+
+    bool read(uint8_t *out, size_t count) override
+    {
+      if (fail)
+        return false;
+      memcpy(out, bytes, count);
+      return true;
+    }
+  };
+
+  // One button per key of a backend, ids 0..keys-1
+  std::vector<ButtonConfig> keyButtons(uint8_t keys)
+  {
+    std::vector<ButtonConfig> buttons;
+    for (uint8_t k = 0; k < keys; k++)
+      buttons.push_back({k, k, "KEY"});
+    return buttons;
+  }
+
+  ManualClock clock(1000);
+}
+
+void setUp()
+{
+  traced.clear();
+  clock.set(1000);
+  Clock::install(&clock);
+}
+
+void tearDown()
+{
+  Clock::install(nullptr);
+  InputSource::install(nullptr);
+}
+
+void test_matrix_scan_numbers_keys_by_row()
+{
+  SimulatedMatrixBus bus(4, 4);
+  MatrixKeypad keypad(bus, 4, 4);
+  keypad.begin();
+  TEST_ASSERT_EQUAL(16, keypad.getKeyCount());
+  TEST_ASSERT_EQUAL_HEX64(0, keypad.scan());
+  TEST_ASSERT_EQUAL(8, bus.getTransactions()); // One select and one read per row
+
+  bus.setKey(1, 2, true);
+  TEST_ASSERT_EQUAL_HEX64(key(6), keypad.scan());
+  bus.setKey(3, 3, true);
+  bus.setKey(0, 0, true);
+  TEST_ASSERT_EQUAL_HEX64(key(0) | key(6) | key(15), keypad.scan());
+  bus.setKey(1, 2, false);
+  TEST_ASSERT_EQUAL_HEX64(key(0) | key(15), keypad.scan());
+}
+
+void test_matrix_blocks_third_key_of_rectangle()
+{
+  SimulatedMatrixBus bus(4, 4);
+  MatrixKeypad keypad(bus, 4, 4);
+  bus.setKey(0, 0, true);
+  bus.setKey(0, 1, true);
+  TEST_ASSERT_EQUAL_HEX64(key(0) | key(1), keypad.scan());
+
+  // (1, 0) closes the rectangle: the matrix also shows (1, 1). Both stay up.
+  bus.setKey(1, 0, true);
+  TEST_ASSERT_EQUAL_HEX64(key(0) | key(1), keypad.scan());
+
+  // Once (0, 1) is released nothing is ambiguous and (1, 0) comes through
+  bus.setKey(0, 1, false);
+  TEST_ASSERT_EQUAL_HEX64(key(0) | key(4), keypad.scan());
+
+  // Keys outside the rectangle are not held back
+  bus.setKey(0, 1, true);
+  bus.setKey(2, 3, true);
+  TEST_ASSERT_EQUAL_HEX64(key(0) | key(4) | key(11), keypad.scan());
+}
+
+void test_matrix_without_blocking_shows_ghost()
+{
+  SimulatedMatrixBus bus(4, 4);
+  MatrixKeypad keypad(bus, 4, 4);
+  keypad.setGhostBlocking(false);
+  bus.setKey(0, 0, true);
+  bus.setKey(0, 1, true);
+  bus.setKey(1, 0, true);
+  TEST_ASSERT_EQUAL_HEX64(key(0) | key(1) | key(4) | key(5), keypad.scan());
+}
+
+void test_matrix_diff_feeds_only_changed_keys()
+{
+  SimulatedMatrixBus bus(4, 4);
+  MatrixKeypad keypad(bus, 4, 4);
+  auto buttons = keyButtons(16);
+  ButtonManager manager(buttons.data(), buttons.size());
+  manager.setBackend(&keypad);
+  manager.setEdgeTrace(traceEdge, nullptr);
+  manager.begin();
+
+  bus.setKey(2, 1, true);
+  manager.update();
+  TEST_ASSERT_EQUAL(1, traced.size());
+  TEST_ASSERT_EQUAL(9, traced[0].button);
+  TEST_ASSERT_EQUAL(LOW, traced[0].level);
+
+  clock.advance(10);
+  manager.update();
+  TEST_ASSERT_EQUAL(1, traced.size()); // Still held: nothing new
+
+  // Third key of a rectangle plus its ghost: no edge for either
+  bus.setKey(2, 3, true);
+  clock.advance(10);
+  manager.update();
+  TEST_ASSERT_EQUAL(2, traced.size());
+  bus.setKey(1, 1, true);
+  clock.advance(10);
+  manager.update();
+  TEST_ASSERT_EQUAL(2, traced.size());
+
+  bus.setKey(1, 1, false);
+  bus.setKey(2, 1, false);
+  clock.advance(10);
+  manager.update();
+  TEST_ASSERT_EQUAL(3, traced.size());
+  TEST_ASSERT_EQUAL(9, traced[2].button);
+  TEST_ASSERT_EQUAL(HIGH, traced[2].level);
+}
+
+void test_shift_register_bit_order()
+{
+  // First byte off the chain is the register next to the MCU; bit n is input n
+  FixedShiftRegisterBus bus;
+  ShiftRegisterInput input(bus, 3);
+  TEST_ASSERT_EQUAL(24, input.getKeyCount());
+  bus.bytes[0] = 0xFE; // A of register 0
+  bus.bytes[1] = 0x7F; // H of register 1
+  bus.bytes[2] = 0xFF;
+  TEST_ASSERT_EQUAL_HEX64(key(0) | key(15), input.scan());
+  bus.bytes[0] = 0xFF;
+  bus.bytes[1] = 0xFF;
+  bus.bytes[2] = 0xEF; // E of register 2
+  TEST_ASSERT_EQUAL_HEX64(key(20), input.scan());
+
+  // A failed read repeats the last keys
+  bus.fail = true;
+  TEST_ASSERT_EQUAL_HEX64(key(20), input.scan());
+}
+
+void test_shift_register_simulated_chain()
+{
+  SimulatedShiftRegisterBus bus(8);
+  ShiftRegisterInput input(bus, 8);
+  TEST_ASSERT_EQUAL(64, input.getKeyCount());
+  bus.setKey(0, true);
+  bus.setKey(9, true);
+  bus.setKey(63, true);
+  TEST_ASSERT_EQUAL_HEX64(key(0) | key(9) | key(63), input.scan());
+  TEST_ASSERT_EQUAL(1, bus.getTransactions()); // The whole chain in one read
+}
+
+void test_i2c_expander_keys_and_setup()
+{
+  const uint8_t addresses[] = {0x20, 0x21};
+  SimulatedI2cBus bus;
+  bus.addExpander(0x20);
+  bus.addExpander(0x21);
+  I2cExpanderInput input(bus, addresses, 2);
+  input.begin();
+  TEST_ASSERT_EQUAL(32, input.getKeyCount());
+
+  bus.setKey(0x20, 0, true);
+  bus.setKey(0x20, 15, true);
+  bus.setKey(0x21, 3, true);
+  const unsigned long before = bus.getTransactions();
+  TEST_ASSERT_EQUAL_HEX64(key(0) | key(15) | key(19), input.scan());
+  TEST_ASSERT_EQUAL(2, bus.getTransactions() - before); // One burst read per expander
+  TEST_ASSERT_EQUAL(0, input.getReadErrors());
+}
+
+void test_i2c_nack_keeps_last_state_without_phantom_edges()
+{
+  const uint8_t addresses[] = {0x20, 0x21};
+  SimulatedI2cBus bus;
+  bus.addExpander(0x20);
+  bus.addExpander(0x21);
+  I2cExpanderInput input(bus, addresses, 2);
+  auto buttons = keyButtons(32);
+  ButtonManager manager(buttons.data(), buttons.size());
+  manager.setBackend(&input);
+  manager.setEdgeTrace(traceEdge, nullptr);
+  manager.begin();
+
+  bus.setKey(0x21, 4, true); // Key 20, held across the errors
+  manager.update();
+  TEST_ASSERT_EQUAL(1, traced.size());
+
+  // The second expander stops answering; its held key must not look released
+  bus.setResponding(0x21, false);
+  for (int i = 0; i < 5; i++)
+  {
+    clock.advance(10);
+    manager.update();
+  }
+  TEST_ASSERT_EQUAL(1, traced.size());
+  TEST_ASSERT_EQUAL(5, input.getReadErrors());
+
+  // The first one keeps working meanwhile
+  bus.setKey(0x20, 1, true);
+  clock.advance(10);
+  manager.update();
+  TEST_ASSERT_EQUAL(2, traced.size());
+  TEST_ASSERT_EQUAL(1, traced[1].button);
+
+  // Back on the bus: the release made during the outage is a single edge
+  bus.setKey(0x21, 4, false);
+  bus.setResponding(0x21, true);
+  clock.advance(10);
+  manager.update();
+  TEST_ASSERT_EQUAL(3, traced.size());
+  TEST_ASSERT_EQUAL(20, traced[2].button);
+  TEST_ASSERT_EQUAL(HIGH, traced[2].level);
+
+  // An expander that never answers reads as nothing pressed
+  const uint8_t missing[] = {0x27};
+  I2cExpanderInput absent(bus, missing, 1);
+  TEST_ASSERT_EQUAL_HEX64(0, absent.scan());
+  TEST_ASSERT_EQUAL(1, absent.getReadErrors());
+}
+
+void test_idle_scan_of_64_keys_does_no_per_key_work()
+{
+  SimulatedShiftRegisterBus bus(8);
+  ShiftRegisterInput input(bus, 8);
+  auto buttons = keyButtons(64);
+  ButtonManager manager(buttons.data(), buttons.size());
+  manager.setBackend(&input);
+  manager.setEdgeTrace(traceEdge, nullptr);
+  CountingInput pins;
+  InputSource::install(&pins);
+  manager.begin();
+
+  const unsigned long scansBefore = bus.getTransactions();
+  for (int i = 0; i < 100; i++)
+  {
+    clock.advance(10);
+    manager.update();
+  }
+  TEST_ASSERT_EQUAL(100, bus.getTransactions() - scansBefore); // One bus read per update
+  TEST_ASSERT_EQUAL(0, pins.reads);                            // No pin sampled per key
+  TEST_ASSERT_EQUAL(0, traced.size());
+  TEST_ASSERT_FALSE(manager.isActive());
+  TEST_ASSERT_EQUAL(ButtonManager::NO_DEADLINE, manager.nextDeadline());
+  ButtonEvent event;
+  TEST_ASSERT_FALSE(manager.pollEvent(event));
+
+  // The same loop without a backend samples every pin, which the counter sees
+  ButtonManager polled(buttons.data(), buttons.size());
+  polled.begin();
+  pins.reads = 0;
+  polled.update();
+  TEST_ASSERT_EQUAL(64, pins.reads);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_matrix_scan_numbers_keys_by_row);
+  RUN_TEST(test_matrix_blocks_third_key_of_rectangle);
+  RUN_TEST(test_matrix_without_blocking_shows_ghost);
+  RUN_TEST(test_matrix_diff_feeds_only_changed_keys);
+  RUN_TEST(test_shift_register_bit_order);
+  RUN_TEST(test_shift_register_simulated_chain);
+  RUN_TEST(test_i2c_expander_keys_and_setup);
+  RUN_TEST(test_i2c_nack_keeps_last_state_without_phantom_edges);
+  RUN_TEST(test_idle_scan_of_64_keys_does_no_per_key_work);
+  return UNITY_END();
+}
@@ -0,0 +1,160 @@
+// A button session recorded by InputTraceRecorder and played back through
+// InputTracePlayer on a ManualClock gives a ButtonManager the same events, in
+// the same order and at the same times, as the session that was recorded.
+
+#include "record/InputTrace.h"
+#include "platform/Clock.h"
+#include <unity.h>
+#include <algorithm>
+#include <functional>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+  ManualClock testClock(5000);
+
+  const ButtonConfig BUTTONS[] = {{BUTTON_UP, 4, "UP"}, {BUTTON_DOWN, 5, "DOWN"}, {BUTTON_CENTER, 15, "CENTER"}};
+
+  struct Edge
+  {
+    unsigned long time;
+    uint8_t button;
+    uint8_t level;
+  };
+
+  // Clicks, a double click, a bouncing press, a long press, a held repeat
+  // button and two buttons at once
+  const Edge SCRIPT[] = {
+      {5100, BUTTON_DOWN, LOW}, {5150, BUTTON_DOWN, HIGH},
+      {5300, BUTTON_DOWN, LOW}, {5340, BUTTON_DOWN, HIGH},
+      {5400, BUTTON_DOWN, LOW}, {5460, BUTTON_DOWN, HIGH},
+      {6000, BUTTON_CENTER, LOW}, {6002, BUTTON_CENTER, HIGH}, {6004, BUTTON_CENTER, LOW}, {6090, BUTTON_CENTER, HIGH},
+      {7000, BUTTON_CENTER, LOW}, {8200, BUTTON_CENTER, HIGH},
+      {9000, BUTTON_UP, LOW}, {9700, BUTTON_DOWN, LOW}, {9740, BUTTON_DOWN, HIGH}, {12600, BUTTON_UP, HIGH},
+      {13000, BUTTON_UP, LOW}, {13080, BUTTON_UP, HIGH},
+  };
+
+  struct Seen
+  {
+    unsigned long time;
+    ButtonEvent event;
+  };
+
+  // Runs 'buttons' from deadline to deadline, as src/host/session.cpp does;
+  // 'feed' gives it the edges up to a time and tells when the next one is
+  std::vector<Seen> run(ButtonManager &buttons, const std::function<unsigned long(unsigned long)> &feed)
+  {
+    std::vector<Seen> seen;
+    const unsigned long stopAt = 15000;
+    unsigned long now = testClock.millis();
+    while (true)
+    {
+      const unsigned long nextEdge = feed(now);
+      buttons.update();
+      buttons.drainEvents([&](const ButtonEvent &event) { seen.push_back({now, event}); });
+
+      const unsigned long next = std::min({nextEdge, buttons.nextDeadline(), stopAt});
+      if (now >= stopAt)
+        break;
+      now = next > now ? next : now + 1;
+      testClock.set(now);
+    }
+    return seen;
+  }
+
+  std::vector<uint8_t> readFile(const char *path)
+  {
+    std::vector<uint8_t> data;
+    FILE *in = fopen(path, "rb");
+    if (!in)
+      return data;
+    int c;
+    while ((c = fgetc(in)) != EOF)
+      data.push_back(static_cast<uint8_t>(c));
+    fclose(in);
+    return data;
+  }
+}
+
+void setUp()
+{
+  testClock.set(5000);
+  Clock::install(&testClock);
+}
+
+void tearDown()
+{
+  Clock::install(nullptr);
+  InputSource::install(nullptr);
+}
+
+void test_replay_gives_recorded_events()
+{
+  char directory[] = "/tmp/itXXXXXX";
+  TEST_ASSERT_NOT_NULL(mkdtemp(directory));
+  const std::string path = std::string(directory) + "/input.trc";
+
+  // The device side: edges from the pin interrupt, traced as they are applied
+  InputTraceRecorder recorder;
+  TEST_ASSERT_TRUE(recorder.begin(path.c_str()));
+  ButtonManager device(BUTTONS);
+  device.setRepeat(BUTTON_UP);
+  device.setEdgeTrace(InputTraceRecorder::onEdge, &recorder);
+  device.begin(true);
+  size_t next = 0;
+  const size_t edges = sizeof(SCRIPT) / sizeof(SCRIPT[0]);
+  std::vector<Seen> recorded = run(device, [&](unsigned long now) {
+    for (; next < edges && SCRIPT[next].time <= now; next++)
+      device.feedEdge(SCRIPT[next].button, SCRIPT[next].level, SCRIPT[next].time);
+    recorder.service(!device.isActive());
+    return next < edges ? SCRIPT[next].time : InputTracePlayer::NO_EDGE;
+  });
+  recorder.end();
+  TEST_ASSERT_EQUAL(0, recorder.getEdgesDropped());
+
+  // The host side: the same manager fed from the trace
+  std::vector<uint8_t> data = readFile(path.c_str());
+  remove(path.c_str());
+  rmdir(directory);
+  InputTracePlayer player;
+  TEST_ASSERT_TRUE(player.load(data.data(), data.size()));
+  TEST_ASSERT_EQUAL(5000, player.getStartMs());
+  testClock.set(player.getStartMs());
+  InputSource::install(&player);
+  ButtonManager host(BUTTONS);
+  host.setRepeat(BUTTON_UP);
+  host.begin(true);
+  std::vector<Seen> replayed = run(host, [&](unsigned long now) {
+    player.feed(host, now);
+    return player.nextTime();
+  });
+
+  TEST_ASSERT_TRUE(player.finished());
+  TEST_ASSERT_FALSE(player.isTruncated());
+  TEST_ASSERT_EQUAL(recorder.getEdgesRecorded(), player.getEdgesPlayed());
+
+  // Every kind of event happened, and all of them again on the host
+  const ButtonAction kinds[] = {SHORT_CLICK, DOUBLE_CLICK, LONG_PRESS, REPEAT};
+  for (ButtonAction kind : kinds)
+    TEST_ASSERT_TRUE(std::any_of(recorded.begin(), recorded.end(), [&](const Seen &s) { return s.event.action == kind; }));
+  TEST_ASSERT_EQUAL(recorded.size(), replayed.size());
+  for (size_t i = 0; i < recorded.size(); i++)
+  {
+    TEST_ASSERT_EQUAL(recorded[i].time, replayed[i].time);
+    TEST_ASSERT_EQUAL(recorded[i].event.buttonId, replayed[i].event.buttonId);
+    TEST_ASSERT_EQUAL(recorded[i].event.buttonPin, replayed[i].event.buttonPin);
+    TEST_ASSERT_EQUAL(recorded[i].event.action, replayed[i].event.action);
+    TEST_ASSERT_EQUAL(recorded[i].event.repeatCount, replayed[i].event.repeatCount);
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_replay_gives_recorded_events);
+  return UNITY_END();
+}
@@ -0,0 +1,164 @@
+// PowerGovernor stages on explicit millis() values: the panel dims, then
+// sleeps with the scheduler suspended, and wakes on input. The gesture that
+// wakes a sleeping panel is swallowed up to the first update() after it is
+// over; a press on a dimmed panel is handled normally.
+
+#include "display/FrameBufferDisplay.h"
+#include "ui/FrameScheduler.h"
+#include "ui/PowerGovernor.h"
+#include <unity.h>
+
+namespace
+{
+  constexpr uint8_t NORMAL = 0x40;
+  constexpr uint8_t DIMMED = 0x02;
+
+  const ButtonEvent CLICK = {BUTTON_CENTER, 15, SHORT_CLICK, 0};
+
+  struct Fixture
+  {
+    FrameBufferDisplay display{128, 64};
+    FrameScheduler scheduler;
+    PowerGovernor governor{display, scheduler, 1000, 3000};
+
+    Fixture() { governor.setContrast(NORMAL, DIMMED); }
+
+    void assertActive()
+    {
+      TEST_ASSERT_TRUE(governor.getState() == PowerGovernor::State::Active);
+      TEST_ASSERT_EQUAL(NORMAL, display.getContrast());
+      TEST_ASSERT_FALSE(display.isPowerSaving());
+      TEST_ASSERT_FALSE(scheduler.isSuspended());
+    }
+
+    void sleepAt(unsigned long now)
+    {
+      governor.update(false, now);
+      TEST_ASSERT_TRUE(governor.isAsleep());
+    }
+  };
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_dims_then_sleeps()
+{
+  Fixture f;
+  f.governor.update(false, 0);
+  f.assertActive();
+  TEST_ASSERT_EQUAL(1000, f.governor.nextDeadline());
+
+  f.governor.update(false, 999);
+  f.assertActive();
+  f.governor.update(false, 1000);
+  TEST_ASSERT_TRUE(f.governor.getState() == PowerGovernor::State::Dimmed);
+  TEST_ASSERT_EQUAL(DIMMED, f.display.getContrast());
+  TEST_ASSERT_FALSE(f.scheduler.isSuspended());
+  TEST_ASSERT_EQUAL(3000, f.governor.nextDeadline());
+
+  f.governor.update(false, 2999);
+  TEST_ASSERT_FALSE(f.governor.isAsleep());
+  f.governor.update(false, 3000);
+  TEST_ASSERT_TRUE(f.governor.isAsleep());
+  TEST_ASSERT_TRUE(f.display.isPowerSaving());
+  TEST_ASSERT_TRUE(f.scheduler.isSuspended());
+  TEST_ASSERT_FALSE(f.scheduler.frameDue(3000));
+  TEST_ASSERT_EQUAL(Widget::NO_DEADLINE, f.governor.nextDeadline());
+}
+
+void test_waking_gesture_is_swallowed()
+{
+  Fixture f;
+  f.sleepAt(5000);
+
+  // Pressed while asleep: the panel comes back at once
+  f.governor.update(true, 6000);
+  f.assertActive();
+  TEST_ASSERT_EQUAL(7000, f.governor.nextDeadline());
+  f.governor.update(true, 6900); // Still held
+  TEST_ASSERT_EQUAL(7900, f.governor.nextDeadline());
+
+  // Its events, also those drained right after the release, are consumed
+  f.governor.update(false, 7000);
+  TEST_ASSERT_FALSE(f.governor.accept(CLICK, 7000));
+  TEST_ASSERT_EQUAL(8000, f.governor.nextDeadline());
+
+  // The next gesture is handled
+  f.governor.update(false, 7100);
+  TEST_ASSERT_TRUE(f.governor.accept(CLICK, 7100));
+  f.assertActive();
+  TEST_ASSERT_EQUAL(8100, f.governor.nextDeadline());
+}
+
+void test_event_without_active_input_wakes_and_is_swallowed()
+{
+  Fixture f;
+  f.sleepAt(5000);
+
+  // A tap that came and went between two updates
+  f.governor.update(false, 6000);
+  TEST_ASSERT_FALSE(f.governor.accept(CLICK, 6000));
+  f.assertActive();
+
+  f.governor.update(false, 6050);
+  TEST_ASSERT_TRUE(f.governor.accept(CLICK, 6050));
+}
+
+void test_press_on_dimmed_panel_is_handled()
+{
+  Fixture f;
+  f.governor.update(false, 0);
+  f.governor.update(false, 1500);
+  TEST_ASSERT_EQUAL(DIMMED, f.display.getContrast());
+
+  f.governor.update(true, 1600);
+  f.assertActive();
+  f.governor.update(false, 1700);
+  TEST_ASSERT_TRUE(f.governor.accept(CLICK, 1700));
+  TEST_ASSERT_EQUAL(2700, f.governor.nextDeadline());
+}
+
+void test_zero_timeout_skips_the_stage()
+{
+  Fixture f;
+  f.governor.setTimeouts(0, 2000);
+  f.governor.update(false, 0);
+  TEST_ASSERT_EQUAL(2000, f.governor.nextDeadline());
+  f.governor.update(false, 1500);
+  f.assertActive();
+  f.governor.update(false, 2000);
+  TEST_ASSERT_TRUE(f.governor.isAsleep());
+
+  f.governor.wake(2500); // Not through input: nothing to swallow
+  f.assertActive();
+  f.governor.setTimeouts(0, 0);
+  TEST_ASSERT_EQUAL(Widget::NO_DEADLINE, f.governor.nextDeadline());
+  f.governor.update(false, 100000);
+  f.assertActive();
+}
+
+void test_timeouts_across_millis_wrap()
+{
+  Fixture f;
+  const unsigned long start = ~0UL - 500;
+  f.governor.update(true, start);
+  f.governor.update(false, start + 999);
+  f.assertActive();
+  f.governor.update(false, start + 1000); // Past the wrap
+  TEST_ASSERT_TRUE(f.governor.getState() == PowerGovernor::State::Dimmed);
+  f.governor.update(false, start + 3000);
+  TEST_ASSERT_TRUE(f.governor.isAsleep());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_dims_then_sleeps);
+  RUN_TEST(test_waking_gesture_is_swallowed);
+  RUN_TEST(test_event_without_active_input_wakes_and_is_swallowed);
+  RUN_TEST(test_press_on_dimmed_panel_is_handled);
+  RUN_TEST(test_zero_timeout_skips_the_stage);
+  RUN_TEST(test_timeouts_across_millis_wrap);
+  return UNITY_END();
+}
@@ -0,0 +1,187 @@
+// Retained repaint against a full repaint: a view that only repaints what
+// changed onto the previous frame must leave its area pixel for pixel as a
+// copy of the view that clears the display and draws everything, frame
+// after frame, through scrolling, selection, marquees and blinking.
+
+#include "display/FrameBufferDisplay.h"
+#include "display/TextDisplay.h"
+#include "form/ButtonElement.h"
+#include "form/CheckBoxElement.h"
+#include "form/FormView.h"
+#include "form/ListElement.h"
+#include "form/TextInputElement.h"
+#include "menu/MenuBuilder.h"
+#include "menu/MenuListView.h"
+#include "platform/Clock.h"
+#include "status/StatusBar.h"
+#include "status/StatusBattery.h"
+#include "status/StatusTime.h"
+#include <unity.h>
+#include <functional>
+#include <memory>
+
+namespace
+{
+  ManualClock manualClock(10000);
+
+  ButtonEvent press(uint8_t id, ButtonAction action = SHORT_CLICK)
+  {
+    return ButtonEvent{id, 0, action, 0};
+  }
+
+  // Pixels inside 'area' where the two displays differ
+  long differences(const FrameBufferDisplay &a, const FrameBufferDisplay &b, const Rect &area)
+  {
+    long count = 0;
+    for (int y = area.y; y < area.bottom(); y++)
+      for (int x = area.x; x < area.right(); x++)
+        if (a.getPixel(x, y) != b.getPixel(x, y))
+          count++;
+    return count;
+  }
+
+  // Runs the same steps on a retained and a fully repainted view and returns
+  // the number of frames whose area differs. 'step' gets the frame number.
+  template <typename View>
+  int compareFrames(const std::function<void(View &)> &setup, const std::function<void(View &, int)> &step, int frames)
+  {
+    FrameBufferDisplay retainedDisplay, fullDisplay;
+    View retained(retainedDisplay), full(fullDisplay);
+    setup(retained);
+    setup(full);
+    retained.setRetained(true);
+    retainedDisplay.fillRect(0, 0, retainedDisplay.width(), retainedDisplay.height(), 1); // The first frame must clear it
+
+    int bad = 0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+      retained.draw();
+      retained.markDrawn();
+      fullDisplay.clearDisplay();
+      full.draw();
+      full.markDrawn();
+      if (differences(retainedDisplay, fullDisplay, retained.getDrawnBounds()) != 0)
+        bad++;
+
+      step(retained, frame);
+      step(full, frame);
+      manualClock.advance(37);
+    }
+    return bad;
+  }
+
+  void noAction() {}
+}
+
+void setUp()
+{
+  manualClock.set(10000);
+  Clock::install(&manualClock);
+}
+
+void tearDown()
+{
+  Clock::install(nullptr);
+}
+
+void test_text_display()
+{
+  const uint8_t steps[] = {BUTTON_DOWN, BUTTON_DOWN, BUTTON_RIGHT, BUTTON_RIGHT, BUTTON_LEFT,
+                           BUTTON_UP, BUTTON_DOWN, BUTTON_DOWN, BUTTON_DOWN, BUTTON_DOWN, BUTTON_UP};
+  int bad = compareFrames<TextDisplay>(
+      [](TextDisplay &view) {
+        for (int i = 0; i < 12; i++)
+          view.addLine(String("Line ") + String(i) + " with text wider than the panel");
+      },
+      [&](TextDisplay &view, int frame) {
+        view.handleInput(press(steps[frame % sizeof(steps)]));
+        if (frame == 20)
+          view.addLine("Added while shown");
+        if (frame == 30)
+          view.clear();
+        if (frame == 31)
+          view.addLine("Again");
+      },
+      60);
+  TEST_ASSERT_EQUAL(0, bad);
+}
+
+void test_menu_list_view()
+{
+  const uint8_t steps[] = {BUTTON_DOWN, BUTTON_DOWN, BUTTON_DOWN, BUTTON_DOWN, BUTTON_DOWN, BUTTON_DOWN,
+                           BUTTON_DOWN, BUTTON_UP, BUTTON_UP, BUTTON_RIGHT, BUTTON_LEFT, BUTTON_UP};
+  int bad = compareFrames<MenuListView>(
+      [](MenuListView &view) {
+        view.setMenu({MenuBuilder::createItem("Start", noAction),
+                      MenuBuilder::createMenu("Settings", {MenuBuilder::createItem("Brightness", noAction)}),
+                      MenuBuilder::createItem("A very long menu label that has to scroll", noAction),
+                      MenuBuilder::createItem("About", noAction),
+                      MenuBuilder::createItem("Exit", noAction),
+                      MenuBuilder::createItem("Six", noAction),
+                      MenuBuilder::createItem("Seven, with a label long enough to scroll", noAction),
+                      MenuBuilder::createItem("Eight", noAction)});
+      },
+      [&](MenuListView &view, int frame) {
+        if (frame % 3 == 0) // Frames in between let the marquee run
+          view.handleInput(press(steps[frame / 3 % sizeof(steps)]));
+      },
+      90);
+  TEST_ASSERT_EQUAL(0, bad);
+}
+
+void test_form_view()
+{
+  const ButtonEvent steps[] = {press(BUTTON_CENTER), press(BUTTON_UP), press(BUTTON_RIGHT),
+                               press(BUTTON_CENTER, DOUBLE_CLICK), press(BUTTON_DOWN), press(BUTTON_CENTER),
+                               press(BUTTON_CENTER), press(BUTTON_DOWN), press(BUTTON_CENTER),
+                               press(BUTTON_RIGHT), press(BUTTON_CENTER, DOUBLE_CLICK), press(BUTTON_DOWN),
+                               press(BUTTON_UP), press(BUTTON_UP)};
+  int bad = compareFrames<FormView>(
+      [](FormView &view) {
+        view.addElement(std::make_shared<TextInputElement>("Username"));
+        view.addElement(std::make_shared<CheckBoxElement>("A checkbox with a long label"));
+        view.addElement(std::make_shared<ListElement>("Color", std::vector<String>{"Red", "Green", "Yellow Green Blue"}));
+        view.addElement(std::make_shared<ButtonElement>("Save", [](String) {}));
+      },
+      [&](FormView &view, int frame) {
+        if (frame % 2 == 0) // Cursor blinks and marquees between the inputs
+          view.handleInput(steps[frame / 2 % (sizeof(steps) / sizeof(steps[0]))]);
+      },
+      80);
+  TEST_ASSERT_EQUAL(0, bad);
+}
+
+void test_status_bar()
+{
+  std::vector<std::shared_ptr<StatusBattery>> batteries;
+  int bad = compareFrames<StatusBar>(
+      [&](StatusBar &view) {
+        auto time = std::make_shared<StatusTime>();
+        time->setTime(12, 34);
+        auto battery = std::make_shared<StatusBattery>();
+        batteries.push_back(battery);
+        view.addLeftElement(time);
+        view.addRightElement(battery);
+      },
+      [&](StatusBar &view, int frame) {
+        if (frame % 4 == 0)
+          for (auto &battery : batteries)
+            battery->setLevel(100 - frame);
+        if (frame == 15)
+          view.setStatusBarBgColor(0);
+        if (frame == 25)
+          view.setDownPosition(true);
+      },
+      60); // Long enough for the colon to blink
+  TEST_ASSERT_EQUAL(0, bad);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_text_display);
+  RUN_TEST(test_menu_list_view);
+  RUN_TEST(test_form_view);
+  RUN_TEST(test_status_bar);
+  return UNITY_END();
+}
@@ -0,0 +1,135 @@
+// Portrait rotations drawn on an unrotated canvas and transposed on flush
+// against the per-pixel rotated path: random scenes must give identical
+// frames, including content drawn before switching rotation and after
+// switching back to landscape.
+
+#include "display/FrameBufferDisplay.h"
+#include "display/PageRotation.h"
+#include "status/StatusIcons.h"
+#include <unity.h>
+#include <random>
+#include <stdlib.h>
+
+namespace
+{
+  // A mix of every primitive, partly off screen, in the current rotation
+  void drawScene(FrameBufferDisplay &display, unsigned seed)
+  {
+    std::mt19937 random(seed);
+    for (int k = 0; k < 40; k++)
+    {
+      const int x = static_cast<int>(random() % 80) - 8, y = static_cast<int>(random() % 140) - 8;
+      const int w = static_cast<int>(random() % 40) - 2, h = static_cast<int>(random() % 40) - 2;
+      const int color = random() % 3;
+      switch (random() % 12)
+      {
+      case 0: display.drawPixel(x, y, color); break;
+      case 1: display.drawFastHLine(x, y, w, color); break;
+      case 2: display.drawFastVLine(x, y, h, color); break;
+      case 3: display.drawLine(x, y, x + w, y + h, color); break;
+      case 4: display.fillRect(x, y, w, h, color); break;
+      case 5: display.drawRect(x, y, w, h, color); break;
+      case 6: display.drawCircle(x, y, abs(w) / 3, color); break;
+      case 7: display.fillRoundRect(x, y, w, h, 3, color % 2); break;
+      case 8: display.drawBitmap(x, y, ICON_BATTERY_CHARGING.bitmap(), static_cast<RasterOp>(random() % 6)); break;
+      case 9:
+        display.setCursor(x, y);
+        display.setTextSize(random() % 4 == 0 ? 2 : 1);
+        display.setTextColor(color, random() % 2 ? color : 1 - color % 2);
+        display.setTextWrap(random() % 2);
+        display.print("Scurtă listă ăâîșț 123 wrap text");
+        break;
+      case 10: display.fillSpan(x, y, w, color); break;
+      case 11: display.fillTriangle(x, y, x + w, y, x, y + h, color); break;
+      }
+    }
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_transpose8x8()
+{
+  std::mt19937 random(5);
+  for (int run = 0; run < 1000; run++)
+  {
+    uint8_t in[8], out[8];
+    for (uint8_t &b : in)
+      b = static_cast<uint8_t>(random());
+    transpose8x8(in, out);
+    for (int i = 0; i < 8; i++)
+      for (int j = 0; j < 8; j++)
+        TEST_ASSERT_EQUAL((in[i] >> j) & 1, (out[j] >> i) & 1);
+  }
+}
+
+void test_portrait_frames_match_per_pixel_path()
+{
+  int differing = 0;
+  for (int rotation : {1, 3})
+  {
+    for (unsigned seed = 0; seed < 200; seed++)
+    {
+      FrameBufferDisplay transposed(128, 64), perPixel(128, 64);
+      perPixel.setTransposeOnFlush(false);
+
+      // Landscape content from before the switch has to survive it
+      drawScene(transposed, seed + 1000);
+      drawScene(perPixel, seed + 1000);
+      transposed.setRotation(rotation);
+      perPixel.setRotation(rotation);
+      TEST_ASSERT_EQUAL(0, transposed.compare(perPixel));
+
+      drawScene(transposed, seed);
+      drawScene(perPixel, seed);
+      transposed.display();
+      perPixel.display();
+      if (transposed.compare(perPixel) != 0)
+        differing++;
+
+      // And the portrait frame has to survive switching back
+      transposed.setRotation(0);
+      perPixel.setRotation(0);
+      drawScene(transposed, seed + 2000);
+      drawScene(perPixel, seed + 2000);
+      if (transposed.compare(perPixel) != 0)
+        differing++;
+    }
+  }
+  TEST_ASSERT_EQUAL(0, differing);
+}
+
+void test_rotation_switch_between_portraits()
+{
+  FrameBufferDisplay transposed(128, 64), perPixel(128, 64);
+  perPixel.setTransposeOnFlush(false);
+  for (unsigned seed = 0; seed < 50; seed++)
+  {
+    const int rotation = seed % 4;
+    transposed.setRotation(rotation);
+    perPixel.setRotation(rotation);
+    drawScene(transposed, seed);
+    drawScene(perPixel, seed);
+    if (seed % 3)
+    {
+      transposed.display();
+      perPixel.display();
+    }
+  }
+  transposed.display();
+  perPixel.display();
+  TEST_ASSERT_EQUAL(0, transposed.compare(perPixel));
+  for (int y = 0; y < transposed.height(); y++)
+    for (int x = 0; x < transposed.width(); x++)
+      TEST_ASSERT_EQUAL(perPixel.getPixel(x, y), transposed.getPixel(x, y));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_transpose8x8);
+  RUN_TEST(test_portrait_frames_match_per_pixel_path);
+  RUN_TEST(test_rotation_switch_between_portraits);
+  return UNITY_END();
+}
@@ -0,0 +1,219 @@
+// ScreenRecorder into host files and back through ScreenPlayer: the segments
+// replay to the frames and input events that were recorded, across the wrap
+// of the two-segment ring, and input events are committed in one flush once
+// the input goes idle instead of one flush each.
+
+#include "record/ScreenRecorder.h"
+#include "record/ScreenPlayer.h"
+#include "platform/Clock.h"
+#include <unity.h>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+  constexpr int WIDTH = 128;
+  constexpr int HEIGHT = 64;
+  constexpr int FRAME_SIZE = WIDTH * HEIGHT / 8;
+
+  using Frame = std::vector<uint8_t>;
+
+  ManualClock testClock(1000);
+  char directory[] = "/tmp/srXXXXXX";
+  std::string basePath;
+
+  struct Event
+  {
+    uint32_t time;
+    uint8_t buttonId;
+    ButtonAction action;
+    std::string name;
+
+    bool operator==(const Event &other) const
+    {
+      return time == other.time && buttonId == other.buttonId && action == other.action && name == other.name;
+    }
+  };
+
+  std::vector<uint8_t> readFile(const std::string &path)
+  {
+    std::vector<uint8_t> data;
+    FILE *in = fopen(path.c_str(), "rb");
+    if (!in)
+      return data;
+    int c;
+    while ((c = fgetc(in)) != EOF)
+      data.push_back(static_cast<uint8_t>(c));
+    fclose(in);
+    return data;
+  }
+
+  long fileSize(const std::string &path)
+  {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? static_cast<long>(info.st_size) : -1;
+  }
+
+  std::string segmentPath(uint8_t index)
+  {
+    char path[64];
+    ScreenRecorder::segmentPath(basePath.c_str(), index, path, sizeof(path));
+    return path;
+  }
+
+  // Changes a few pages of 'frame' with pseudo-random content
+  void scribble(Frame &frame, unsigned &seed)
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      seed = seed * 1103515245u + 12345u;
+      const int page = (seed >> 16) % (HEIGHT / 8);
+      for (int x = 0; x < WIDTH; x++)
+      {
+        seed = seed * 1103515245u + 12345u;
+        frame[page * WIDTH + x] = static_cast<uint8_t>(seed >> 20);
+      }
+    }
+  }
+}
+
+void setUp()
+{
+  testClock.set(1000);
+  Clock::install(&testClock);
+  if (basePath.empty())
+  {
+    TEST_ASSERT_NOT_NULL(mkdtemp(directory));
+    basePath = std::string(directory) + "/s";
+  }
+  for (uint8_t i = 0; i < ScreenRecorder::SEGMENTS; i++)
+    remove(segmentPath(i).c_str());
+}
+
+void tearDown()
+{
+  Clock::install(nullptr);
+}
+
+void test_round_trip_across_segment_wrap()
+{
+  const char *names[] = {"UP", "DOWN", "CENTER"};
+  std::vector<Frame> frames;
+  std::vector<Event> events;
+  {
+    ScreenRecorder recorder(WIDTH, HEIGHT);
+    TEST_ASSERT_TRUE(recorder.begin(basePath.c_str(), 16000));
+    Frame frame(FRAME_SIZE, 0);
+    unsigned seed = 7;
+    for (int i = 0; i < 120; i++)
+    {
+      const uint32_t now = 1000 + i * 20;
+      if (i % 3 == 0)
+      {
+        ButtonEvent event{static_cast<uint8_t>(i / 3 % 3), 4, SHORT_CLICK, 0};
+        recorder.recordEvent(event, names[event.buttonId], now);
+        events.push_back({now, event.buttonId, SHORT_CLICK, names[event.buttonId]});
+      }
+      scribble(frame, seed);
+      recorder.recordFrame(frame.data(), now);
+      frames.push_back(frame);
+      recorder.recordFrame(frame.data(), now + 5); // Unchanged: not stored
+    }
+    TEST_ASSERT_EQUAL(120, recorder.getFramesRecorded());
+    recorder.end();
+  }
+
+  // Both segments, oldest first
+  std::vector<std::vector<uint8_t>> segments;
+  for (uint8_t i = 0; i < ScreenRecorder::SEGMENTS; i++)
+    segments.push_back(readFile(segmentPath(i)));
+  record::Header headers[ScreenRecorder::SEGMENTS];
+  for (uint8_t i = 0; i < ScreenRecorder::SEGMENTS; i++)
+    TEST_ASSERT_TRUE(ScreenPlayer::readHeader(segments[i].data(), segments[i].size(), headers[i]));
+  if (headers[0].sequence > headers[1].sequence)
+    std::swap(segments[0], segments[1]);
+  TEST_ASSERT_TRUE(std::max(headers[0].sequence, headers[1].sequence) >= 2); // The ring wrapped
+
+  std::vector<Frame> played;
+  std::vector<Event> playedEvents;
+  ScreenPlayer player;
+  player.onFrame([&](uint32_t, const uint8_t *frame) {
+    Frame copy(frame, frame + FRAME_SIZE);
+    if (played.empty() || played.back() != copy) // A segment opens with the frame before it
+      played.push_back(copy);
+  });
+  player.onEvent([&](const RecordedEvent &event) {
+    playedEvents.push_back({event.timeMs, event.buttonId, event.action, std::string(event.name, event.nameLength)});
+  });
+  for (const std::vector<uint8_t> &segment : segments)
+  {
+    TEST_ASSERT_TRUE(player.play(segment.data(), segment.size()));
+    TEST_ASSERT_FALSE(player.isTruncated());
+  }
+
+  // What is left is the tail of the recording, whole
+  TEST_ASSERT_TRUE(played.size() > 10);
+  TEST_ASSERT_TRUE(played.size() < frames.size());
+  const size_t skipped = frames.size() - played.size();
+  for (size_t i = 0; i < played.size(); i++)
+    TEST_ASSERT_TRUE(played[i] == frames[skipped + i]);
+
+  TEST_ASSERT_TRUE(!playedEvents.empty());
+  TEST_ASSERT_TRUE(playedEvents.size() < events.size());
+  const size_t skippedEvents = events.size() - playedEvents.size();
+  for (size_t i = 0; i < playedEvents.size(); i++)
+    TEST_ASSERT_TRUE(playedEvents[i] == events[skippedEvents + i]);
+}
+
+void test_events_flushed_once_input_is_idle()
+{
+  ScreenRecorder recorder(WIDTH, HEIGHT);
+  TEST_ASSERT_TRUE(recorder.begin(basePath.c_str(), 16000));
+  const std::string path = segmentPath(0);
+  const long started = fileSize(path);
+  TEST_ASSERT_TRUE(started > 0);
+
+  // A held button repeating: nothing is written while it is in progress
+  for (uint8_t i = 0; i < 5; i++)
+  {
+    recorder.recordEvent(ButtonEvent{BUTTON_DOWN, 5, REPEAT, static_cast<uint8_t>(i + 1)}, "DOWN", 1500 + i * 100);
+    recorder.service(false);
+  }
+  TEST_ASSERT_EQUAL(started, fileSize(path));
+
+  recorder.service(true);
+  const long flushed = fileSize(path);
+  TEST_ASSERT_TRUE(flushed > started);
+  recorder.service(true); // Nothing new
+  TEST_ASSERT_EQUAL(flushed, fileSize(path));
+
+  // Frames alone wait for FLUSH_INTERVAL, idle or not
+  Frame frame(FRAME_SIZE, 0);
+  unsigned seed = 3;
+  scribble(frame, seed);
+  recorder.recordFrame(frame.data(), 2500);
+  recorder.service(true);
+  TEST_ASSERT_EQUAL(flushed, fileSize(path));
+
+  std::vector<uint8_t> data = readFile(path);
+  ScreenPlayer player;
+  TEST_ASSERT_TRUE(player.play(data.data(), data.size()));
+  TEST_ASSERT_EQUAL(5, player.getEventsPlayed());
+  TEST_ASSERT_EQUAL(0, player.getFramesPlayed());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip_across_segment_wrap);
+  RUN_TEST(test_events_flushed_once_input_is_idle);
+  for (uint8_t i = 0; i < ScreenRecorder::SEGMENTS; i++)
+    remove(segmentPath(i).c_str());
+  rmdir(directory);
+  return UNITY_END();
+}
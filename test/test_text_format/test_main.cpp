@@ -0,0 +1,119 @@
+// Allocation-free formatting into glyphs: integer padding, fixed-point
+// numbers, TextBuffer truncation, and makeFormat() parsed at compile time
+// with the widths it promises checked by static_assert.
+
+#include "display/TextFormat.h"
+#include <unity.h>
+#include <climits>
+#include <string>
+
+namespace
+{
+  constexpr auto TIME_FORMAT = makeFormat<int, int>("%02d:%02d");
+  constexpr auto LABEL_FORMAT = makeFormat<const char *, long>("%6s|%4d%%");
+  constexpr auto PLAIN_FORMAT = makeFormat<>("Gata");
+
+  // Glyphs back to text; extended glyphs show as '#'
+  template <size_t N>
+  std::string text(const TextBuffer<N> &buffer)
+  {
+    std::string out;
+    for (size_t i = 0; i < buffer.length(); i++)
+      out += buffer.data()[i] < FONT_6X8_EXTENDED_FIRST ? static_cast<char>(buffer.data()[i]) : '#';
+    return out;
+  }
+
+  template <typename T>
+  std::string format(const T &value)
+  {
+    TextBuffer<TEXT_FIELD_CAPACITY + 8> buffer;
+    buffer.append(value);
+    return text(buffer);
+  }
+}
+
+static_assert(TIME_FORMAT.segmentCount == 3, "field, literal, field");
+static_assert(TIME_FORMAT.width == 5 && TIME_FORMAT.pixelWidth() == 5 * FONT_6X8_WIDTH, "hh:mm");
+static_assert(TIME_FORMAT.maxLength == 41, "two longs and a colon");
+static_assert(LABEL_FORMAT.width == 12, "6 + 1 + 4 + 1");
+static_assert(LABEL_FORMAT.segments[0].kind == 's' && LABEL_FORMAT.segments[2].kind == 'd', "string, then integer");
+static_assert(LABEL_FORMAT.segments[3].kind == 'l' && LABEL_FORMAT.segments[3].length == 1, "%% is a literal");
+static_assert(PLAIN_FORMAT.segmentCount == 1 && PLAIN_FORMAT.width == 4 && PLAIN_FORMAT.maxLength == 4, "literal only");
+static_assert(padded(7, 3).fill == ' ' && zeroPadded(7, 3).fill == '0', "padding helpers");
+static_assert(fixedPoint(-305, 2).decimals == 2 && fixedPoint(-305, 2).width == 0, "fixed-point helper");
+
+void setUp() {}
+void tearDown() {}
+
+void test_integer_fields()
+{
+  TEST_ASSERT_EQUAL_STRING("0", format(0L).c_str());
+  TEST_ASSERT_EQUAL_STRING("-17", format(-17).c_str());
+  TEST_ASSERT_EQUAL_STRING("   42", format(padded(42, 5)).c_str());
+  TEST_ASSERT_EQUAL_STRING("  -42", format(padded(-42, 5)).c_str());
+  TEST_ASSERT_EQUAL_STRING("__7", format(padded(7, 3, '_')).c_str());
+  TEST_ASSERT_EQUAL_STRING("00042", format(zeroPadded(42, 5)).c_str());
+  TEST_ASSERT_EQUAL_STRING("-0042", format(zeroPadded(-42, 5)).c_str()); // Sign first, as printf
+  TEST_ASSERT_EQUAL_STRING("12345", format(zeroPadded(12345, 3)).c_str()); // Never cut
+
+  TEST_ASSERT_EQUAL_STRING(std::to_string(LONG_MIN).c_str(), format(LONG_MIN).c_str());
+  TEST_ASSERT_EQUAL_STRING(std::to_string(LONG_MAX).c_str(), format(LONG_MAX).c_str());
+}
+
+void test_fixed_point()
+{
+  TEST_ASSERT_EQUAL_STRING("-3.05", format(fixedPoint(-305, 2)).c_str());
+  TEST_ASSERT_EQUAL_STRING("0.05", format(fixedPoint(5, 2)).c_str());
+  TEST_ASSERT_EQUAL_STRING("-0.005", format(fixedPoint(-5, 3)).c_str());
+  TEST_ASSERT_EQUAL_STRING("21.5", format(fixedPoint(215, 1)).c_str());
+  TEST_ASSERT_EQUAL_STRING("  1.50", format(fixedPoint(150, 2, 6)).c_str());
+  TEST_ASSERT_EQUAL_STRING(" -1.50", format(fixedPoint(-150, 2, 6)).c_str());
+  TEST_ASSERT_EQUAL_STRING("  150", format(fixedPoint(150, 0, 5)).c_str());
+}
+
+void test_buffer_drops_past_capacity()
+{
+  TextBuffer<6> buffer;
+  buffer.append("Temp ");
+  buffer.append(fixedPoint(215, 1));
+  TEST_ASSERT_EQUAL(6, buffer.length());
+  TEST_ASSERT_EQUAL_STRING("Temp 2", text(buffer).c_str());
+  TEST_ASSERT_EQUAL(6 * FONT_6X8_WIDTH, buffer.width());
+
+  buffer.clear();
+  buffer.append("ț=");
+  buffer.append('x');
+  TEST_ASSERT_EQUAL(3, buffer.length());
+  TEST_ASSERT_EQUAL(fontGlyphIndex(0x21B), buffer.data()[0]);
+}
+
+void test_formats_render()
+{
+  TextBuffer<64> buffer;
+  TIME_FORMAT.render(buffer, 9, 5);
+  TEST_ASSERT_EQUAL_STRING("09:05", text(buffer).c_str());
+  TEST_ASSERT_EQUAL(TIME_FORMAT.width, buffer.length());
+
+  buffer.clear();
+  LABEL_FORMAT.render(buffer, "Baterie", 87L);
+  TEST_ASSERT_EQUAL_STRING("Bateri|  87%", text(buffer).c_str()); // Clipped to 6
+  TEST_ASSERT_EQUAL(LABEL_FORMAT.width, buffer.length());
+
+  buffer.clear();
+  LABEL_FORMAT.render(buffer, "Ață", -12345L);
+  TEST_ASSERT_EQUAL_STRING("A##   |-12345%", text(buffer).c_str()); // Padded by characters, not bytes
+
+  buffer.clear();
+  PLAIN_FORMAT.render(buffer);
+  TEST_ASSERT_EQUAL_STRING("Gata", text(buffer).c_str());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_integer_fields);
+  RUN_TEST(test_fixed_point);
+  RUN_TEST(test_buffer_drops_past_capacity);
+  RUN_TEST(test_formats_render);
+  return UNITY_END();
+}
@@ -0,0 +1,148 @@
+// TextRenderer against a pixel-by-pixel port of Adafruit_GFX::write/drawChar
+// at text size 1: random text, positions, colors and wrap settings must give
+// the same frame and leave the cursor in the same place.
+
+#include "display/TextRenderer.h"
+#include <unity.h>
+#include <random>
+#include <string.h>
+
+namespace
+{
+  constexpr int WIDTH = 128;
+  constexpr int HEIGHT = 64;
+  constexpr int FRAME_SIZE = WIDTH * HEIGHT / 8;
+
+  // Adafruit_GFX::drawChar, size 1, with setPixel() clipping every pixel
+  void referenceChar(PageBuffer &frame, int x, int y, char c, int color, int bg)
+  {
+    if (x >= frame.width() || y >= frame.height() || x + 5 < 0 || y + 7 < 0)
+      return;
+    const uint8_t *glyph = fontGlyph(fontGlyphIndex(static_cast<uint8_t>(c)));
+    for (int i = 0; i < 5; i++)
+    {
+      uint8_t line = glyph[i];
+      for (int j = 0; j < 8; j++, line >>= 1)
+      {
+        if (line & 1)
+          frame.setPixel(x + i, y + j, color);
+        else if (bg != color)
+          frame.setPixel(x + i, y + j, bg);
+      }
+    }
+    if (bg != color)
+    {
+      for (int j = 0; j < 8; j++)
+        frame.setPixel(x + 5, y + j, bg);
+    }
+  }
+
+  // Adafruit_GFX::write for the classic font
+  void referencePrint(PageBuffer &frame, const char *text, int &cursorX, int &cursorY, int color, int bg, bool wrap)
+  {
+    for (; *text; text++)
+    {
+      if (*text == '\n')
+      {
+        cursorX = 0;
+        cursorY += 8;
+      }
+      else if (*text != '\r')
+      {
+        if (wrap && cursorX + 6 > frame.width())
+        {
+          cursorX = 0;
+          cursorY += 8;
+        }
+        referenceChar(frame, cursorX, cursorY, *text, color, bg);
+        cursorX += 6;
+      }
+    }
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_matches_adafruit_draw_char()
+{
+  std::mt19937 random(1);
+  uint8_t fast[FRAME_SIZE], reference[FRAME_SIZE];
+  long mismatches = 0;
+
+  for (int run = 0; run < 20000; run++)
+  {
+    for (int i = 0; i < FRAME_SIZE; i++)
+      fast[i] = reference[i] = static_cast<uint8_t>(random());
+    PageBuffer fastFrame(fast, WIDTH, HEIGHT);
+    PageBuffer referenceFrame(reference, WIDTH, HEIGHT);
+
+    // Printable ASCII with some line breaks and carriage returns
+    char text[24];
+    const int length = random() % (sizeof(text) - 1);
+    for (int i = 0; i < length; i++)
+    {
+      const int pick = random() % 20;
+      text[i] = pick == 0 ? '\n' : pick == 1 ? '\r' : static_cast<char>(0x20 + random() % 95);
+    }
+    text[length] = '\0';
+
+    // Positions off every edge and between pages; colors 0, 1 and 2 (invert)
+    const int x = static_cast<int>(random() % 170) - 24;
+    const int y = static_cast<int>(random() % 96) - 16;
+    const int color = random() % 3;
+    const int bg = random() % 4 == 0 ? color : random() % 3;
+    const bool wrap = random() % 2;
+
+    int fastX = x, fastY = y, referenceX = x, referenceY = y;
+    TextRenderer(fastFrame).print(text, fastX, fastY, color, bg, wrap);
+    referencePrint(referenceFrame, text, referenceX, referenceY, color, bg, wrap);
+
+    if (memcmp(fast, reference, FRAME_SIZE) != 0 || fastX != referenceX || fastY != referenceY)
+      mismatches++;
+  }
+  TEST_ASSERT_EQUAL(0, mismatches);
+}
+
+void test_clip_matches_reference_inside_and_keeps_outside()
+{
+  std::mt19937 random(2);
+  uint8_t fast[FRAME_SIZE], reference[FRAME_SIZE], original[FRAME_SIZE];
+
+  for (int run = 0; run < 2000; run++)
+  {
+    for (int i = 0; i < FRAME_SIZE; i++)
+      fast[i] = reference[i] = original[i] = static_cast<uint8_t>(random());
+    PageBuffer fastFrame(fast, WIDTH, HEIGHT);
+    PageBuffer referenceFrame(reference, WIDTH, HEIGHT);
+
+    const int x0 = random() % WIDTH, y0 = random() % HEIGHT;
+    const int x1 = x0 + random() % (WIDTH - x0), y1 = y0 + random() % (HEIGHT - y0);
+    const int x = static_cast<int>(random() % 140) - 8, y = static_cast<int>(random() % 72) - 8;
+
+    int fastX = x, fastY = y, referenceX = x, referenceY = y;
+    TextRenderer renderer(fastFrame);
+    renderer.setClip(x0, y0, x1, y1);
+    renderer.print("Clip {text} 0123", fastX, fastY, 1, 0, true);
+    referencePrint(referenceFrame, "Clip {text} 0123", referenceX, referenceY, 1, 0, true);
+
+    for (int py = 0; py < HEIGHT; py++)
+    {
+      for (int px = 0; px < WIDTH; px++)
+      {
+        const bool inside = px >= x0 && px <= x1 && py >= y0 && py <= y1;
+        const bool expected = inside ? referenceFrame.getPixel(px, py) : (original[(py / 8) * WIDTH + px] >> (py % 8)) & 1;
+        if (fastFrame.getPixel(px, py) != expected)
+          TEST_FAIL_MESSAGE("clipped text differs from the reference");
+      }
+    }
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_matches_adafruit_draw_char);
+  RUN_TEST(test_clip_matches_reference_inside_and_keeps_outside);
+  return UNITY_END();
+}
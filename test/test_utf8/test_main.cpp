@@ -0,0 +1,123 @@
+// UTF-8 decoding and the glyph mapping of the 6x8 font: malformed and
+// truncated sequences give one replacement per bad byte and never read past
+// the terminator, and the Romanian and Western European letters map to their
+// extended glyphs while everything else outside ASCII gets the hollow box.
+
+#include "display/Font6x8.h"
+#include "display/GlyphString.h"
+#include "display/Utf8.h"
+#include <unity.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+  // First code point of 'text' and the bytes it took
+  constexpr uint32_t first(const char *text) { return utf8Next(text); }
+  constexpr long used(const char *text)
+  {
+    const char *start = text;
+    utf8Next(text);
+    return text - start;
+  }
+
+  std::vector<uint32_t> decode(const char *text)
+  {
+    std::vector<uint32_t> codepoints;
+    const char *end = text + strlen(text);
+    while (*text)
+    {
+      codepoints.push_back(utf8Next(text));
+      TEST_ASSERT_TRUE(text <= end);
+    }
+    return codepoints;
+  }
+}
+
+static_assert(first("A") == 'A' && used("A") == 1, "ASCII is one byte");
+static_assert(first("\xC3\xA9") == 0xE9 && used("\xC3\xA9") == 2, "e acute");
+static_assert(first("\xC8\x99") == 0x219 && used("\xC8\x99") == 2, "s comma below");
+static_assert(first("\xE2\x82\xAC") == 0x20AC && used("\xE2\x82\xAC") == 3, "euro sign");
+static_assert(first("\xF0\x9F\x98\x80") == 0x1F600 && used("\xF0\x9F\x98\x80") == 4, "emoji");
+static_assert(first("\x80") == UTF8_REPLACEMENT && used("\x80") == 1, "stray continuation byte");
+static_assert(first("\xC3") == UTF8_REPLACEMENT && used("\xC3") == 1, "truncated at the terminator");
+static_assert(first("\xC0\xAF") == UTF8_REPLACEMENT && used("\xC0\xAF") == 1, "overlong form");
+static_assert(first("\xED\xA0\x80") == UTF8_REPLACEMENT, "surrogate");
+static_assert(first("\xF4\x90\x80\x80") == UTF8_REPLACEMENT, "above U+10FFFF");
+static_assert(first("\xFF") == UTF8_REPLACEMENT, "invalid lead byte");
+
+void setUp() {}
+void tearDown() {}
+
+void test_malformed_input_resynchronises()
+{
+  // A truncated two byte sequence before ASCII, a lone continuation byte,
+  // a truncated three byte sequence, then a valid letter
+  std::vector<uint32_t> codepoints = decode("\xC3" "a\x80" "b\xE2\x82" "c\xC4\x83");
+  const uint32_t expected[] = {UTF8_REPLACEMENT, 'a', UTF8_REPLACEMENT, 'b', UTF8_REPLACEMENT, UTF8_REPLACEMENT, 'c', 0x103};
+  TEST_ASSERT_EQUAL(sizeof(expected) / sizeof(expected[0]), codepoints.size());
+  for (size_t i = 0; i < codepoints.size(); i++)
+    TEST_ASSERT_EQUAL_HEX32(expected[i], codepoints[i]);
+
+  // Cut off by the terminator: stops there
+  codepoints = decode("x\xF0\x9F\x98");
+  TEST_ASSERT_EQUAL(4, codepoints.size());
+  TEST_ASSERT_EQUAL_HEX32(UTF8_REPLACEMENT, codepoints[3]);
+}
+
+void test_extended_latin_glyphs()
+{
+  const uint32_t covered[] = {0xB0, 0xC2, 0xCE, 0xDF, 0xE2, 0xE9, 0xEE, 0xFC, 0x102, 0x103,
+                              0x15E, 0x15F, 0x162, 0x163, 0x218, 0x219, 0x21A, 0x21B};
+  uint8_t previous = 0;
+  for (uint32_t codepoint : covered)
+  {
+    const uint8_t index = fontGlyphIndex(codepoint);
+    TEST_ASSERT_TRUE(index >= FONT_6X8_EXTENDED_FIRST);
+    TEST_ASSERT_TRUE(index - FONT_6X8_EXTENDED_FIRST < FONT_6X8_EXTENDED_COUNT);
+    TEST_ASSERT_TRUE(index > previous); // The table is sorted
+    TEST_ASSERT_EQUAL_HEX16(codepoint, FONT_6X8_EXTENDED[index - FONT_6X8_EXTENDED_FIRST].codepoint);
+    previous = index;
+  }
+
+  // Cedilla and comma-below forms share their glyphs
+  TEST_ASSERT_EQUAL_PTR(fontGlyph(fontGlyphIndex(0x15F)), fontGlyph(fontGlyphIndex(0x219)));
+  TEST_ASSERT_EQUAL_PTR(fontGlyph(fontGlyphIndex(0x162)), fontGlyph(fontGlyphIndex(0x21A)));
+}
+
+void test_ascii_controls_and_missing_glyphs()
+{
+  TEST_ASSERT_EQUAL(' ', fontGlyphIndex(' '));
+  TEST_ASSERT_EQUAL('~', fontGlyphIndex('~'));
+  TEST_ASSERT_EQUAL('\n', fontGlyphIndex('\n'));
+  TEST_ASSERT_EQUAL('\r', fontGlyphIndex('\r'));
+
+  const uint32_t missing[] = {'\t', 0x7F, 0xA0, 0xE3, 0x20AC, 0x1F600, UTF8_REPLACEMENT};
+  for (uint32_t codepoint : missing)
+    TEST_ASSERT_EQUAL(FONT_6X8_MISSING_INDEX, fontGlyphIndex(codepoint));
+  TEST_ASSERT_EQUAL_PTR(FONT_6X8_MISSING, fontGlyph(FONT_6X8_MISSING_INDEX));
+  TEST_ASSERT_EQUAL_PTR(FONT_6X8_MISSING, fontGlyph(0xFF));
+}
+
+void test_glyph_string_counts_characters()
+{
+  GlyphString text("Înc\xC4\x83 o dat\xC4\x83 \xE2\x82\xAC");
+  TEST_ASSERT_EQUAL(13, text.length());
+  TEST_ASSERT_EQUAL(13 * FONT_6X8_WIDTH, text.width());
+  TEST_ASSERT_EQUAL(fontGlyphIndex(0xCE), text[0]);
+  TEST_ASSERT_EQUAL(fontGlyphIndex(0x103), text[3]);
+  TEST_ASSERT_EQUAL(FONT_6X8_MISSING_INDEX, text[12]);
+
+  GlyphString empty(nullptr);
+  TEST_ASSERT_TRUE(empty.isEmpty());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_malformed_input_resynchronises);
+  RUN_TEST(test_extended_latin_glyphs);
+  RUN_TEST(test_ascii_controls_and_missing_glyphs);
+  RUN_TEST(test_glyph_string_counts_characters);
+  return UNITY_END();
+}